@@ -15,7 +15,12 @@
  */
 
 #include <math.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <string.h>
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
 
 #include "ambe3600x2450_const.h"
 #include "ambe_common.h"
@@ -73,6 +78,99 @@ ambe2450_get_dct_cache(void) {
     return &ambe2450_cache;
 }
 
+/**
+ * @brief Position of one of b0..b8 in the packed 49-bit parameter word.
+ *
+ * The packed word holds ambe_d[0] in bit 48 down to ambe_d[48] in bit 0,
+ * i.e. u0 (12 bits), u1 (12), u2 (11) and u3 (14) from the top. Every
+ * parameter is a run of its high bits in u0..u2 followed by a run of its
+ * low bits further down, each in order, so a field moves as one PEXT/PDEP
+ * mask or as two shift/mask pairs.
+ */
+struct ambe2450_field {
+    uint64_t mask;    /* PEXT/PDEP mask covering both runs */
+    uint8_t hi_shift; /* Bit position of the high run */
+    uint8_t hi_bits;  /* Length of the high run */
+    uint8_t lo_shift; /* Bit position of the low run */
+    uint8_t lo_bits;  /* Length of the low run */
+};
+
+#define AMBE2450_FIELD(hs, hb, ls, lb)                                                                                 \
+    {((((uint64_t)1 << (hb)) - 1) << (hs)) | ((((uint64_t)1 << (lb)) - 1) << (ls)), (hs), (hb), (ls), (lb)}
+
+static const struct ambe2450_field ambe2450_fields[9] = {
+    AMBE2450_FIELD(45, 4, 9, 3),  /* b0: ambe_d[0..3], [37..39] */
+    AMBE2450_FIELD(41, 4, 13, 1), /* b1: ambe_d[4..7], [35] */
+    AMBE2450_FIELD(37, 4, 12, 1), /* b2: ambe_d[8..11], [36] */
+    AMBE2450_FIELD(29, 8, 8, 1),  /* b3: ambe_d[12..19], [40] */
+    AMBE2450_FIELD(25, 4, 5, 3),  /* b4: ambe_d[20..23], [41..43] */
+    AMBE2450_FIELD(21, 4, 4, 1),  /* b5: ambe_d[24..27], [44] */
+    AMBE2450_FIELD(18, 3, 3, 1),  /* b6: ambe_d[28..30], [45] */
+    AMBE2450_FIELD(15, 3, 2, 1),  /* b7: ambe_d[31..33], [46] */
+    AMBE2450_FIELD(14, 1, 0, 2),  /* b8: ambe_d[34], [47..48] */
+};
+
+/**
+ * @brief Pack 49 AMBE 2450 parameter bits into one word.
+ * @param ambe_d Parameter bits (49), one per element.
+ * @return Packed word, ambe_d[0] in bit 48.
+ */
+uint64_t
+mbe_packAmbe2450Data(const char ambe_d[49]) {
+    uint64_t ambe_u = 0;
+    for (int i = 0; i < 49; i++) {
+        ambe_u = (ambe_u << 1) | (uint64_t)(ambe_d[i] & 1);
+    }
+    return ambe_u;
+}
+
+/**
+ * @brief Extract b0..b8 from a packed parameter word.
+ *
+ * Uses BMI2 PEXT when the build targets it (e.g. -mbmi2 or -march=native),
+ * and the shift/mask runs otherwise.
+ *
+ * @param ambe_u Packed parameter word.
+ * @param b      Output: parameter fields b0..b8.
+ */
+void
+mbe_unpackAmbe2450Fields(uint64_t ambe_u, int b[9]) {
+    for (int k = 0; k < 9; k++) {
+        const struct ambe2450_field* f = &ambe2450_fields[k];
+#if defined(__BMI2__)
+        b[k] = (int)_pext_u64(ambe_u, f->mask);
+#else
+        uint64_t hi = (ambe_u >> f->hi_shift) & (((uint64_t)1 << f->hi_bits) - 1);
+        uint64_t lo = (ambe_u >> f->lo_shift) & (((uint64_t)1 << f->lo_bits) - 1);
+        b[k] = (int)((hi << f->lo_bits) | lo);
+#endif
+    }
+}
+
+/**
+ * @brief Pack b0..b8 into a parameter word (inverse of mbe_unpackAmbe2450Fields).
+ *
+ * Uses BMI2 PDEP when the build targets it. Bits of b[k] beyond the
+ * field's width are ignored.
+ *
+ * @param b Parameter fields b0..b8.
+ * @return Packed parameter word.
+ */
+uint64_t
+mbe_packAmbe2450Fields(const int b[9]) {
+    uint64_t ambe_u = 0;
+    for (int k = 0; k < 9; k++) {
+        const struct ambe2450_field* f = &ambe2450_fields[k];
+        uint64_t v = (uint64_t)(unsigned int)b[k];
+#if defined(__BMI2__)
+        ambe_u |= _pdep_u64(v, f->mask);
+#else
+        ambe_u |= ((v >> f->lo_bits) << f->hi_shift | v << f->lo_shift) & f->mask;
+#endif
+    }
+    return ambe_u;
+}
+
 /**
  * @brief Print AMBE 2450 parameter bits to stderr (debug aid).
  * @param ambe_d AMBE parameter bits (49).
@@ -156,6 +254,18 @@ mbe_eccAmbe3600x2450Data(char ambe_fr[4][24], char* ambe_d) {
  */
 int
 mbe_decodeAmbe2450Parms(char* ambe_d, mbe_parms* cur_mp, mbe_parms* prev_mp) {
+    return mbe_decodeAmbe2450PackedParms(mbe_packAmbe2450Data(ambe_d), cur_mp, prev_mp);
+}
+
+/**
+ * @brief Decode AMBE 2450 parameters from a packed parameter word.
+ * @param ambe_u  Packed parameter word (see mbe_packAmbe2450Data).
+ * @param cur_mp  Output: current frame parameters.
+ * @param prev_mp Input: previous frame parameters (for prediction).
+ * @return As for mbe_decodeAmbe2450Parms.
+ */
+int
+mbe_decodeAmbe2450PackedParms(uint64_t ambe_u, mbe_parms* cur_mp, mbe_parms* prev_mp) {
 
     int ji, i, j, k, l, L = 0, L9, m, am, ak;
     int intkl[57];
@@ -173,28 +283,10 @@ mbe_decodeAmbe2450Parms(char* ambe_d, mbe_parms* cur_mp, mbe_parms* prev_mp) {
     fprintf(stderr, "\n");
 #endif
 
-    int u0, u1, u2, u3;
-    u0 = u1 = u2 = u3 = 0;
-
-    for (i = 0; i < 12; i++) {
-        u0 = u0 << 1;
-        u0 = u0 | (int)ambe_d[i];
-    }
-
-    for (i = 12; i < 24; i++) {
-        u1 = u1 << 1;
-        u1 = u1 | (int)ambe_d[i];
-    }
-
-    for (i = 24; i < 35; i++) {
-        u2 = u2 << 1;
-        u2 = u2 | (int)ambe_d[i];
-    }
-
-    for (i = 35; i < 49; i++) {
-        u3 = u3 << 1;
-        u3 = u3 | (int)ambe_d[i];
-    }
+    int u0, u3, fields[9];
+    u0 = (int)(ambe_u >> 37) & 0xfff;
+    u3 = (int)ambe_u & 0x3fff;
+    mbe_unpackAmbe2450Fields(ambe_u, fields);
 
     //bitchin'
     int bitchk1, bitchk2;
@@ -209,14 +301,7 @@ mbe_decodeAmbe2450Parms(char* ambe_d, mbe_parms* cur_mp, mbe_parms* prev_mp) {
     cur_mp->repeat = prev_mp->repeat;
 
     // decode fundamental frequency w0 from b0
-    b0 = 0;
-    b0 |= ambe_d[0] << 6;
-    b0 |= ambe_d[1] << 5;
-    b0 |= ambe_d[2] << 4;
-    b0 |= ambe_d[3] << 3;
-    b0 |= ambe_d[37] << 2;
-    b0 |= ambe_d[38] << 1;
-    b0 |= ambe_d[39];
+    b0 = fields[0];
 
     if (bitchk1 == 63 && bitchk2 == 0) {
 #ifdef AMBE_DEBUG
@@ -283,13 +368,8 @@ mbe_decodeAmbe2450Parms(char* ambe_d, mbe_parms* cur_mp, mbe_parms* prev_mp) {
     (void)L9;
 
     // decode V/UV parameters
-    // load b1 from ambe_d
-    b1 = 0;
-    b1 |= ambe_d[4] << 4;
-    b1 |= ambe_d[5] << 3;
-    b1 |= ambe_d[6] << 2;
-    b1 |= ambe_d[7] << 1;
-    b1 |= ambe_d[35];
+    // load b1 from the packed fields
+    b1 = fields[1];
 
     for (l = 1; l <= L; l++) {
         // jl from specification document
@@ -309,13 +389,8 @@ mbe_decodeAmbe2450Parms(char* ambe_d, mbe_parms* cur_mp, mbe_parms* prev_mp) {
 #endif
 
     // decode gain vector
-    // load b2 from ambe_d
-    b2 = 0;
-    b2 |= ambe_d[8] << 4;
-    b2 |= ambe_d[9] << 3;
-    b2 |= ambe_d[10] << 2;
-    b2 |= ambe_d[11] << 1;
-    b2 |= ambe_d[36];
+    // load b2 from the packed fields
+    b2 = fields[2];
 
     deltaGamma = AmbeDg[b2];
     cur_mp->gamma = deltaGamma + ((float)0.5 * prev_mp->gamma);
@@ -326,30 +401,14 @@ mbe_decodeAmbe2450Parms(char* ambe_d, mbe_parms* cur_mp, mbe_parms* prev_mp) {
     // decode PRBA vectors
     Gm[1] = 0;
 
-    // load b3 from ambe_d
-    b3 = 0;
-    b3 |= ambe_d[12] << 8;
-    b3 |= ambe_d[13] << 7;
-    b3 |= ambe_d[14] << 6;
-    b3 |= ambe_d[15] << 5;
-    b3 |= ambe_d[16] << 4;
-    b3 |= ambe_d[17] << 3;
-    b3 |= ambe_d[18] << 2;
-    b3 |= ambe_d[19] << 1;
-    b3 |= ambe_d[40];
+    // load b3 from the packed fields
+    b3 = fields[3];
     Gm[2] = AmbePRBA24[b3][0];
     Gm[3] = AmbePRBA24[b3][1];
     Gm[4] = AmbePRBA24[b3][2];
 
-    // load b4 from ambe_d
-    b4 = 0;
-    b4 |= ambe_d[20] << 6;
-    b4 |= ambe_d[21] << 5;
-    b4 |= ambe_d[22] << 4;
-    b4 |= ambe_d[23] << 3;
-    b4 |= ambe_d[41] << 2;
-    b4 |= ambe_d[42] << 1;
-    b4 |= ambe_d[43];
+    // load b4 from the packed fields
+    b4 = fields[4];
     Gm[5] = AmbePRBA58[b4][0];
     Gm[6] = AmbePRBA58[b4][1];
     Gm[7] = AmbePRBA58[b4][2];
@@ -394,33 +453,17 @@ mbe_decodeAmbe2450Parms(char* ambe_d, mbe_parms* cur_mp, mbe_parms* prev_mp) {
 
     // decode HOC
 
-    // load b5 from ambe_d
-    b5 = 0;
-    b5 |= ambe_d[24] << 4;
-    b5 |= ambe_d[25] << 3;
-    b5 |= ambe_d[26] << 2;
-    b5 |= ambe_d[27] << 1;
-    b5 |= ambe_d[44];
-
-    // load b6 from ambe_d
-    b6 = 0;
-    b6 |= ambe_d[28] << 3;
-    b6 |= ambe_d[29] << 2;
-    b6 |= ambe_d[30] << 1;
-    b6 |= ambe_d[45];
-
-    // load b7 from ambe_d
-    b7 = 0;
-    b7 |= ambe_d[31] << 3;
-    b7 |= ambe_d[32] << 2;
-    b7 |= ambe_d[33] << 1;
-    b7 |= ambe_d[46];
-
-    // load b8 from ambe_d
-    b8 = 0;
-    b8 |= ambe_d[34] << 2;
-    b8 |= ambe_d[47] << 1;
-    b8 |= ambe_d[48];
+    // load b5 from the packed fields
+    b5 = fields[5];
+
+    // load b6 from the packed fields
+    b6 = fields[6];
+
+    // load b7 from the packed fields
+    b7 = fields[7];
+
+    // load b8 from the packed fields
+    b8 = fields[8];
 
     // lookup Ji
     Ji[1] = AmbeLmprbl[L][0];
@@ -583,22 +626,26 @@ mbe_demodulateAmbe3600x2450Data(char ambe_fr[4][24]) {
 }
 
 /**
- * @brief Process AMBE 2450 parameters into 160 float samples at 8 kHz.
- * @param aout_buf Output buffer of 160 float samples.
- * @param errs     Output: corrected error count in protected fields.
- * @param errs2    Output: raw parity mismatch count.
- * @param err_str  Output: human-readable error summary (optional).
- * @param ambe_d   Demodulated parameter bits (49).
- * @param cur_mp   In/out: current frame parameters (may be enhanced).
- * @param prev_mp  In/out: previous frame parameters.
- * @param prev_mp_enhanced In/out: enhanced previous parameters for continuity.
- * @param uvquality Unvoiced synthesis quality (1..64).
+ * @brief Shared frame processing for the synthesis and parameter-only paths.
+ *
+ * With aout_buf == NULL no audio is produced and the unvoiced WOLA state of
+ * voiced/silence frames is deferred (see mbe_processAmbe2450Parmsf). With
+ * rs != NULL audio is synthesised at rs->rate times 8 kHz. With lost != 0
+ * there is no frame: ambe_u is ignored and the previous parameters are
+ * repeated as for a frame with uncorrectable errors.
+ *
+ * @return Deferred-state code as documented for mbe_processAmbe2450Parmsf.
+ *         When synthesising, MBE_STATE_RESET means aout_buf holds silence.
  */
-void
-mbe_processAmbe2450Dataf(float* aout_buf, int* errs, int* errs2, char* err_str, char ambe_d[49], mbe_parms* cur_mp,
-                         mbe_parms* prev_mp, mbe_parms* prev_mp_enhanced, int uvquality) {
+static int
+mbe_processAmbe2450Common(float* aout_buf, int* errs, int* errs2, char* err_str, uint64_t ambe_u, mbe_parms* cur_mp,
+                          mbe_parms* prev_mp, mbe_parms* prev_mp_enhanced, int uvquality, float* noise_buffer,
+                          mbe_rate_state* rs, int lost) {
 
     int i, bad;
+    int state = MBE_STATE_UNCHANGED;
+    int rate = rs ? rs->rate : 1;
+    float scratch[160];
 
     /* Set AMBE-specific muting threshold (9.6% vs IMBE's 8.75%).
      * This matches JMBE AMBEModelParameters.isFrameMuted(). */
@@ -618,7 +665,7 @@ mbe_processAmbe2450Dataf(float* aout_buf, int* errs, int* errs2, char* err_str,
     }
     //it should be noted that in this context, 'bad' isn't referring to bad decode, but is a return
     //value for which type of frame we should synthesize (voice, repeat, silence, erasure, or tone, etc)
-    bad = mbe_decodeAmbe2450Parms(ambe_d, cur_mp, prev_mp);
+    bad = lost ? 0 : mbe_decodeAmbe2450PackedParms(ambe_u, cur_mp, prev_mp);
     if (bad == 2) {
         // Erasure frame
         *err_str = 'E';
@@ -631,7 +678,7 @@ mbe_processAmbe2450Dataf(float* aout_buf, int* errs, int* errs2, char* err_str,
         err_str++;
         cur_mp->repeat = 0;
         cur_mp->repeatCount = 0;
-    } else if (*errs2 > 3) {
+    } else if (lost || *errs2 > 3) {
         mbe_useLastMbeParms(cur_mp, prev_mp);
         cur_mp->repeat++;
         cur_mp->repeatCount++;
@@ -646,26 +693,169 @@ mbe_processAmbe2450Dataf(float* aout_buf, int* errs, int* errs2, char* err_str,
         if (cur_mp->repeat <= 3) {
             mbe_moveMbeParms(cur_mp, prev_mp);
             mbe_spectralAmpEnhance(cur_mp);
-            mbe_synthesizeSpeechf(aout_buf, cur_mp, prev_mp_enhanced, uvquality);
+            if (aout_buf && rs) {
+                mbe_synthesizeSpeechRatef(aout_buf, rs, cur_mp, prev_mp_enhanced);
+            } else if (aout_buf) {
+                mbe_synthesizeSpeechf(aout_buf, cur_mp, prev_mp_enhanced, uvquality);
+            } else if (mbe_advanceSpeechState(cur_mp, prev_mp_enhanced, noise_buffer)) {
+                state = MBE_STATE_DEFERRED;
+            }
             mbe_moveMbeParms(cur_mp, prev_mp_enhanced);
         } else {
             *err_str = 'M';
             err_str++;
-            mbe_synthesizeSilencef(aout_buf);
+            if (aout_buf) {
+                memset(aout_buf, 0, (size_t)(160 * rate) * sizeof(*aout_buf));
+            }
             mbe_initMbeParms(cur_mp, prev_mp, prev_mp_enhanced);
+            if (rs) {
+                mbe_initRateState(rs, rate);
+            }
+            state = MBE_STATE_RESET;
         }
     }
 
     else if (bad == 7 && *errs < 2 && *errs2 < 3) //only run if no more than x errs accumulated
     {
         //synthesize tone
-        mbe_synthesizeTonef(aout_buf, ambe_d, cur_mp);
+        if (aout_buf) {
+            mbe_synthesizeTonePackedRatef(aout_buf, rate, ambe_u, cur_mp);
+        } else {
+            mbe_synthesizeTonePackedRatef(scratch, 1, ambe_u, cur_mp);
+        }
         mbe_moveMbeParms(cur_mp, prev_mp);
     } else {
-        mbe_synthesizeSilencef(aout_buf);
+        if (aout_buf) {
+            memset(aout_buf, 0, (size_t)(160 * rate) * sizeof(*aout_buf));
+        }
         mbe_initMbeParms(cur_mp, prev_mp, prev_mp_enhanced);
+        if (rs) {
+            mbe_initRateState(rs, rate);
+        }
+        state = MBE_STATE_RESET;
     }
     *err_str = 0;
+
+    return state;
+}
+
+/**
+ * @brief Process AMBE 2450 parameters into 160 float samples at 8 kHz.
+ * @param aout_buf Output buffer of 160 float samples.
+ * @param errs     Output: corrected error count in protected fields.
+ * @param errs2    Output: raw parity mismatch count.
+ * @param err_str  Output: human-readable error summary (optional).
+ * @param ambe_d   Demodulated parameter bits (49).
+ * @param cur_mp   In/out: current frame parameters (may be enhanced).
+ * @param prev_mp  In/out: previous frame parameters.
+ * @param prev_mp_enhanced In/out: enhanced previous parameters for continuity.
+ * @param uvquality Unvoiced synthesis quality (1..64).
+ * @return MBE_STATE_RESET if the frame was not synthesised (erasure,
+ *         rejected tone or muted) and aout_buf holds silence, otherwise
+ *         MBE_STATE_UNCHANGED.
+ */
+int
+mbe_processAmbe2450Dataf(float* aout_buf, int* errs, int* errs2, char* err_str, char ambe_d[49], mbe_parms* cur_mp,
+                         mbe_parms* prev_mp, mbe_parms* prev_mp_enhanced, int uvquality) {
+    return mbe_processAmbe2450Common(aout_buf, errs, errs2, err_str, mbe_packAmbe2450Data(ambe_d), cur_mp, prev_mp,
+                                     prev_mp_enhanced, uvquality, NULL, NULL, 0);
+}
+
+/**
+ * @brief Process a packed AMBE 2450 parameter word into 160 float samples at 8 kHz.
+ *
+ * Same as mbe_processAmbe2450Dataf, with the parameters as the word
+ * returned by mbe_packAmbe2450Data or mbe_packAmbe2450Fields.
+ */
+int
+mbe_processAmbe2450PackedDataf(float* aout_buf, int* errs, int* errs2, char* err_str, uint64_t ambe_u,
+                               mbe_parms* cur_mp, mbe_parms* prev_mp, mbe_parms* prev_mp_enhanced, int uvquality) {
+    return mbe_processAmbe2450Common(aout_buf, errs, errs2, err_str, ambe_u, cur_mp, prev_mp, prev_mp_enhanced,
+                                     uvquality, NULL, NULL, 0);
+}
+
+/**
+ * @brief Process AMBE 2450 parameters into 160 * rs->rate float samples.
+ *
+ * Same as mbe_processAmbe2450Dataf, but speech and tones are synthesised
+ * directly at the output rate of rs (see mbe_synthesizeSpeechRatef).
+ *
+ * @param aout_buf Output buffer of 160 * rs->rate float samples.
+ * @param rs       In/out: rate synthesis state (reset with the parameters).
+ * @param errs,errs2,err_str,ambe_d,cur_mp,prev_mp,prev_mp_enhanced
+ *        As for mbe_processAmbe2450Dataf.
+ * @return As for mbe_processAmbe2450Dataf.
+ */
+int
+mbe_processAmbe2450DataRatef(float* aout_buf, mbe_rate_state* rs, int* errs, int* errs2, char* err_str,
+                             char ambe_d[49], mbe_parms* cur_mp, mbe_parms* prev_mp, mbe_parms* prev_mp_enhanced) {
+    return mbe_processAmbe2450Common(aout_buf, errs, errs2, err_str, mbe_packAmbe2450Data(ambe_d), cur_mp, prev_mp,
+                                     prev_mp_enhanced, 3, NULL, rs, 0);
+}
+
+/**
+ * @brief Packed-word variant of mbe_processAmbe2450DataRatef.
+ */
+int
+mbe_processAmbe2450PackedDataRatef(float* aout_buf, mbe_rate_state* rs, int* errs, int* errs2, char* err_str,
+                                   uint64_t ambe_u, mbe_parms* cur_mp, mbe_parms* prev_mp,
+                                   mbe_parms* prev_mp_enhanced) {
+    return mbe_processAmbe2450Common(aout_buf, errs, errs2, err_str, ambe_u, cur_mp, prev_mp, prev_mp_enhanced, 3,
+                                     NULL, rs, 0);
+}
+
+/**
+ * @brief Process AMBE 2450 parameters without synthesising audio.
+ *
+ * Performs the same classification, repeat/mute handling and parameter
+ * state updates as mbe_processAmbe2450Dataf, but skips synthesis. The
+ * unvoiced WOLA state of speech frames is deferred: when the return value
+ * is MBE_STATE_DEFERRED, noise_buffer holds what mbe_completeSpeechState
+ * needs to bring prev_mp_enhanced (and cur_mp) up to date before the next
+ * synthesised frame.
+ *
+ * @param errs,errs2,err_str,ambe_d,cur_mp,prev_mp,prev_mp_enhanced
+ *        As for mbe_processAmbe2450Dataf.
+ * @param noise_buffer Output: 256-sample noise buffer of a deferred frame.
+ * @return MBE_STATE_DEFERRED (new deferred state in noise_buffer),
+ *         MBE_STATE_RESET (state re-initialised, nothing pending) or
+ *         MBE_STATE_UNCHANGED (any previously deferred state still applies).
+ */
+int
+mbe_processAmbe2450Parmsf(int* errs, int* errs2, char* err_str, char ambe_d[49], mbe_parms* cur_mp,
+                          mbe_parms* prev_mp, mbe_parms* prev_mp_enhanced, float* noise_buffer) {
+    return mbe_processAmbe2450Common(NULL, errs, errs2, err_str, mbe_packAmbe2450Data(ambe_d), cur_mp, prev_mp,
+                                     prev_mp_enhanced, 3, noise_buffer, NULL, 0);
+}
+
+/**
+ * @brief Packed-word variant of mbe_processAmbe2450Parmsf.
+ */
+int
+mbe_processAmbe2450PackedParmsf(int* errs, int* errs2, char* err_str, uint64_t ambe_u, mbe_parms* cur_mp,
+                                mbe_parms* prev_mp, mbe_parms* prev_mp_enhanced, float* noise_buffer) {
+    return mbe_processAmbe2450Common(NULL, errs, errs2, err_str, ambe_u, cur_mp, prev_mp, prev_mp_enhanced, 3,
+                                     noise_buffer, NULL, 0);
+}
+
+/**
+ * @brief Conceal a lost frame (one that never arrived) into 160 float samples.
+ *
+ * The previous parameters are repeated exactly as for a received frame with
+ * uncorrectable errors, so the repeat count and muting (and with them the
+ * comfort noise of mbe_synthesizeComfortNoisef) behave the same. A lost
+ * frame carries no bit errors, so it adds nothing to the error rate.
+ *
+ * @param aout_buf,err_str,cur_mp,prev_mp,prev_mp_enhanced,uvquality
+ *        As for mbe_processAmbe2450Dataf.
+ * @return As for mbe_processAmbe2450Dataf.
+ */
+int
+mbe_processAmbe2450Lostf(float* aout_buf, char* err_str, mbe_parms* cur_mp, mbe_parms* prev_mp,
+                         mbe_parms* prev_mp_enhanced, int uvquality) {
+    int errs = 0, errs2 = 0;
+    return mbe_processAmbe2450Common(aout_buf, &errs, &errs2, err_str, 0, cur_mp, prev_mp, prev_mp_enhanced,
+                                     uvquality, NULL, NULL, 1);
 }
 
 /**
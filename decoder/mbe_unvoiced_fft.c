@@ -20,6 +20,11 @@
 #define MBE_LCG_B_INT 11213u
 #define MBE_LCG_M_INT 53125u
 
+/* Eight steps of the LCG at once (A^8, B * (A^7 + ... + 1), mod M) */
+#define MBE_LCG_LANES  8
+#define MBE_LCG_A8_INT 7311u
+#define MBE_LCG_B8_INT 42784u
+
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -75,6 +80,9 @@ mbe_synthesisWindow_fast(int n) {
 /* Frame length for WOLA (always 160 samples) */
 #define MBE_FRAME_LEN 160
 
+/* Comfort noise interpolator cutoff; the Hann transition band ends at 4 kHz */
+#define MBE_COMFORT_CUTOFF_HZ 3500.0f
+
 /**
  * @brief FFT plan structure wrapping PFFFT setup and scratch buffers.
  *
@@ -115,6 +123,11 @@ struct mbe_fft_plan {
 
     int b_max[57]; /**< Band upper bin edges */
 
+    /* Band edges depend only on w0; they are reused while w0 repeats
+     * (every silence frame, and voice frames with a steady pitch) */
+    float edges_w0; /**< w0 the cached band edges were computed for */
+    int edges_L;    /**< Number of valid cached bands (0 = none) */
+
     /* Index arrays for WOLA (int arrays benefit less from alignment) */
     int wola_prev_idx[MBE_FRAME_LEN]; /**< n + 128 */
     int wola_curr_idx[MBE_FRAME_LEN]; /**< n + 128 - 160 = n - 32 */
@@ -135,6 +148,8 @@ mbe_fft_plan_alloc(void) {
     plan->Uw_fft = NULL;
     plan->Uw_out = NULL;
     plan->work = NULL;
+    plan->edges_w0 = 0.0f;
+    plan->edges_L = 0;
 
     /* Create PFFFT setup for 256-point real transform */
     plan->setup = pffft_new_setup(MBE_FFT_SIZE, PFFFT_REAL);
@@ -214,7 +229,27 @@ mbe_generate_noise_lcg(float* restrict buffer, int count, float* restrict seed)
      * The state is always in [0, 53124] which is exactly representable in float.
      * This optimization replaces per-sample fmodf() with integer modulo. */
     uint32_t state = (uint32_t)(*seed) % 53125u;
-    for (int i = 0; i < count; i++) {
+    int i = 0;
+
+    /* Long buffers (rate synthesis) run eight interleaved lanes that each
+     * jump eight steps, which breaks the serial modulo chain but produces
+     * exactly the same sequence */
+    if (count >= 2 * MBE_LCG_LANES) {
+        uint32_t lane[MBE_LCG_LANES];
+        for (int j = 0; j < MBE_LCG_LANES; j++) {
+            lane[j] = state;
+            state = (MBE_LCG_A_INT * state + MBE_LCG_B_INT) % MBE_LCG_M_INT;
+        }
+        for (; i + MBE_LCG_LANES <= count; i += MBE_LCG_LANES) {
+            for (int j = 0; j < MBE_LCG_LANES; j++) {
+                buffer[i + j] = (float)lane[j];
+                lane[j] = (MBE_LCG_A8_INT * lane[j] + MBE_LCG_B8_INT) % MBE_LCG_M_INT;
+            }
+        }
+        state = lane[0];
+    }
+
+    for (; i < count; i++) {
         /* Write current state to buffer BEFORE updating (preserves JMBE sequence) */
         buffer[i] = (float)state;
         state = (171u * state + 11213u) % 53125u;
@@ -587,13 +622,15 @@ mbe_magnitude_squared_sum(const float* restrict fft, int start, int end) {
     return sum;
 }
 
-void
-mbe_synthesizeUnvoicedFFTWithNoise(float* restrict output, mbe_parms* restrict cur_mp, mbe_parms* restrict prev_mp,
-                                   mbe_fft_plan* restrict plan, const float* restrict noise_buffer) {
-    if (MBE_UNLIKELY(!output || !cur_mp || !prev_mp || !plan || !noise_buffer)) {
-        return;
-    }
-
+/**
+ * @brief Compute the current frame's unvoiced IFFT output into plan->Uw_out.
+ *
+ * Shared by the synthesis path and the state-only path so both produce
+ * identical previousUw state.
+ */
+static void
+mbe_computeUnvoicedUw(const mbe_parms* restrict cur_mp, mbe_fft_plan* restrict plan,
+                      const float* restrict noise_buffer) {
     /* Use plan's scratch buffers */
     float* Uw = plan->Uw;
     float* Uw_fft = plan->Uw_fft;
@@ -625,7 +662,11 @@ mbe_synthesizeUnvoicedFFTWithNoise(float* restrict output, mbe_parms* restrict c
     /* Algorithms #122-123: Calculate frequency band edges for each harmonic */
     float multiplier = MBE_256_OVER_2PI * w0;
 
-    for (int l = 1; l <= L; l++) {
+    if (w0 != plan->edges_w0) {
+        plan->edges_w0 = w0;
+        plan->edges_L = 0;
+    }
+    for (int l = plan->edges_L + 1; l <= L; l++) {
         a_min[l] = (int)ceilf((l - 0.5f) * multiplier);
         b_max[l] = (int)ceilf((l + 0.5f) * multiplier);
         /* Clamp to valid bin range */
@@ -636,6 +677,9 @@ mbe_synthesizeUnvoicedFFTWithNoise(float* restrict output, mbe_parms* restrict c
             b_max[l] = MBE_FFT_SIZE / 2;
         }
     }
+    if (L > plan->edges_L) {
+        plan->edges_L = L;
+    }
 
     /* Algorithm #120: Calculate band-level scaling for unvoiced bands
      * Uses SIMD-optimized magnitude accumulation when available */
@@ -696,11 +740,33 @@ mbe_synthesizeUnvoicedFFTWithNoise(float* restrict output, mbe_parms* restrict c
         }
     }
 
+}
+
+void
+mbe_synthesizeUnvoicedFFTWithNoise(float* restrict output, mbe_parms* restrict cur_mp, mbe_parms* restrict prev_mp,
+                                   mbe_fft_plan* restrict plan, const float* restrict noise_buffer) {
+    if (MBE_UNLIKELY(!output || !cur_mp || !prev_mp || !plan || !noise_buffer)) {
+        return;
+    }
+
+    mbe_computeUnvoicedUw(cur_mp, plan, noise_buffer);
+
     /* Algorithm #126: WOLA combine with previous frame (using precomputed weights) */
-    mbe_wola_combine_fast(output, prev_mp->previousUw, Uw_out, plan);
+    mbe_wola_combine_fast(output, prev_mp->previousUw, plan->Uw_out, plan);
 
     /* Save current output for next frame's WOLA */
-    memcpy(cur_mp->previousUw, Uw_out, MBE_FFT_SIZE * sizeof(float));
+    memcpy(cur_mp->previousUw, plan->Uw_out, MBE_FFT_SIZE * sizeof(float));
+}
+
+void
+mbe_updateUnvoicedFFTState(mbe_parms* restrict cur_mp, mbe_fft_plan* restrict plan,
+                           const float* restrict noise_buffer) {
+    if (MBE_UNLIKELY(!cur_mp || !plan || !noise_buffer)) {
+        return;
+    }
+
+    mbe_computeUnvoicedUw(cur_mp, plan, noise_buffer);
+    memcpy(cur_mp->previousUw, plan->Uw_out, MBE_FFT_SIZE * sizeof(float));
 }
 
 void
@@ -717,3 +783,259 @@ mbe_synthesizeUnvoicedFFT(float* restrict output, mbe_parms* restrict cur_mp, mb
     /* Use the shared implementation */
     mbe_synthesizeUnvoicedFFTWithNoise(output, cur_mp, prev_mp, plan, noise_buffer);
 }
+
+/**
+ * @brief Rate synthesis plan: FFT setup, scratch and resampled windows.
+ *
+ * All float arrays are carved from one PFFFT-aligned block; every length
+ * is a multiple of 16 floats, so each array stays 64-byte aligned.
+ */
+struct mbe_rate_plan {
+    int rate;      /**< Output rate as a multiple of 8 kHz */
+    int nfft;      /**< FFT size (256 * rate) */
+    int frame_len; /**< Output samples per frame (160 * rate) */
+
+    PFFFT_Setup* setup; /**< PFFFT setup for the nfft-point real transform */
+    float* block;       /**< Backing allocation for the arrays below */
+
+    float* Uw;       /**< Windowed noise buffer (nfft) */
+    float* Uw_fft;   /**< FFT output (nfft) */
+    float* Uw_out;   /**< IFFT output (nfft) */
+    float* work;     /**< PFFFT work buffer (nfft) */
+    float* analysis; /**< Synthesis window over the noise buffer, centred at 128 * rate (nfft) */
+    float* wola_a;   /**< w(n) / (w(n)^2 + w(n-160)^2) / 256 for the previous frame (frame_len) */
+    float* wola_b;   /**< w(n-160) / (w(n)^2 + w(n-160)^2) / 256 for the current frame (frame_len) */
+    float* voiced;   /**< Voiced window Ws resampled to 2 * frame_len */
+    float* comfort;  /**< Comfort noise interpolator, MBE_COMFORT_TAPS taps per output phase (rate phases) */
+
+    float scalor[MBE_FFT_SIZE / 2 + 1]; /**< Per-bin scaling for bins below 4 kHz */
+};
+
+/**
+ * @brief Synthesis window at a fractional index.
+ *
+ * The window is piecewise linear, so linear interpolation reproduces it
+ * exactly at any output rate. Returns 0 outside [-105, +105].
+ */
+static float
+mbe_synthesisWindow_interp(float x) {
+    if (x <= -105.0f || x >= 105.0f) {
+        return 0.0f;
+    }
+    float f = floorf(x);
+    int i = (int)f;
+    float a = Ws_synthesis[i + 105];
+    float b = (i < 105) ? Ws_synthesis[i + 106] : 0.0f;
+    return a + ((b - a) * (x - f));
+}
+
+mbe_rate_plan*
+mbe_rate_plan_alloc(int rate, const float* ws) {
+    if (rate < 1 || rate > MBE_MAX_RATE || !ws) {
+        return NULL;
+    }
+
+    mbe_rate_plan* plan = (mbe_rate_plan*)pffft_aligned_malloc(sizeof(mbe_rate_plan));
+    if (!plan) {
+        return NULL;
+    }
+    memset(plan, 0, sizeof(*plan));
+
+    const int nfft = MBE_FFT_SIZE * rate;
+    const int len = MBE_FRAME_LEN * rate;
+    plan->rate = rate;
+    plan->nfft = nfft;
+    plan->frame_len = len;
+
+    plan->setup = pffft_new_setup(nfft, PFFFT_REAL);
+    plan->block = (float*)pffft_aligned_malloc(
+        ((5u * (size_t)nfft) + (4u * (size_t)len) + ((size_t)MBE_COMFORT_TAPS * (size_t)rate)) * sizeof(float));
+    if (!plan->setup || !plan->block) {
+        mbe_rate_plan_free(plan);
+        return NULL;
+    }
+
+    plan->Uw = plan->block;
+    plan->Uw_fft = plan->Uw + nfft;
+    plan->Uw_out = plan->Uw_fft + nfft;
+    plan->work = plan->Uw_out + nfft;
+    plan->analysis = plan->work + nfft;
+    plan->wola_a = plan->analysis + nfft;
+    plan->wola_b = plan->wola_a + len;
+    plan->voiced = plan->wola_b + len;
+    plan->comfort = plan->voiced + (2 * len);
+
+    const float step = 1.0f / (float)rate;
+
+    for (int i = 0; i < nfft; i++) {
+        plan->analysis[i] = mbe_synthesisWindow_interp((float)(i - (128 * rate)) * step);
+    }
+
+    /* WOLA weights with the denominator and IFFT normalisation folded in.
+     * The IFFT is normalised by 1/256 rather than 1/nfft: band-limited noise
+     * has the same per-sample level at any rate, so output matches 8 kHz. */
+    for (int n = 0; n < len; n++) {
+        float t = (float)n * step;
+        float w_prev = mbe_synthesisWindow_interp(t);
+        float w_curr = mbe_synthesisWindow_interp(t - (float)MBE_FRAME_LEN);
+        float denom = (w_prev * w_prev) + (w_curr * w_curr);
+        float norm = (denom > 1e-10f) ? 1.0f / (denom * (float)MBE_FFT_SIZE) : 0.0f;
+        plan->wola_a[n] = w_prev * norm;
+        plan->wola_b[n] = w_curr * norm;
+    }
+
+    /* Ws is piecewise linear too; (2 * len - 1) * step < 320 stays inside it */
+    for (int j = 0; j < 2 * len; j++) {
+        float x = (float)j * step;
+        int i = (int)x;
+        plan->voiced[j] = ws[i] + ((ws[i + 1] - ws[i]) * (x - (float)i));
+    }
+
+    /* Hann-windowed sinc; phase p sits p / rate samples after the input
+     * sample MBE_COMFORT_TAPS / 2 - 1 taps back */
+    const float fc = 2.0f * MBE_COMFORT_CUTOFF_HZ / 8000.0f;
+    const float half = (float)(MBE_COMFORT_TAPS / 2);
+    for (int p = 0; p < rate; p++) {
+        float* h = plan->comfort + (p * MBE_COMFORT_TAPS);
+        for (int i = 0; i < MBE_COMFORT_TAPS; i++) {
+            float tau = (half - 1.0f - (float)i) + ((float)p * step);
+            float x = (float)M_PI * fc * tau;
+            float sinc = (fabsf(x) < 1e-6f) ? 1.0f : sinf(x) / x;
+            h[i] = fc * sinc * 0.5f * (1.0f + cosf((float)M_PI * tau / half));
+        }
+    }
+
+    return plan;
+}
+
+void
+mbe_rate_plan_free(mbe_rate_plan* plan) {
+    if (plan) {
+        if (plan->setup) {
+            pffft_destroy_setup(plan->setup);
+        }
+        if (plan->block) {
+            pffft_aligned_free(plan->block);
+        }
+        pffft_aligned_free(plan);
+    }
+}
+
+const float*
+mbe_rate_plan_voiced_window(const mbe_rate_plan* plan) {
+    return plan->voiced;
+}
+
+void
+mbe_interpolateComfortNoiseRate(float* buf, mbe_rate_state* rs, const mbe_rate_plan* plan) {
+    if (MBE_UNLIKELY(!buf || !rs || !plan)) {
+        return;
+    }
+
+    const int rate = plan->rate;
+    float x[MBE_COMFORT_TAPS + MBE_FRAME_LEN];
+    memcpy(x, rs->comfortHistory, MBE_COMFORT_TAPS * sizeof(float));
+    memcpy(x + MBE_COMFORT_TAPS, buf, MBE_FRAME_LEN * sizeof(float));
+    memcpy(rs->comfortHistory, x + MBE_FRAME_LEN, MBE_COMFORT_TAPS * sizeof(float));
+
+    /* Output m * rate + p is taken from input samples m + 1 .. m + MBE_COMFORT_TAPS */
+    for (int m = 0; m < MBE_FRAME_LEN; m++) {
+        const float* in = x + m + 1;
+        for (int p = 0; p < rate; p++) {
+            const float* h = plan->comfort + (p * MBE_COMFORT_TAPS);
+            float acc = 0.0f;
+            for (int i = 0; i < MBE_COMFORT_TAPS; i++) {
+                acc += h[i] * in[i];
+            }
+            buf[(m * rate) + p] = acc;
+        }
+    }
+}
+
+void
+mbe_synthesizeUnvoicedRate(float* restrict output, const mbe_parms* restrict cur_mp, mbe_rate_state* restrict rs,
+                           mbe_rate_plan* restrict plan) {
+    if (MBE_UNLIKELY(!output || !cur_mp || !rs || !plan)) {
+        return;
+    }
+
+    const int rate = plan->rate;
+    const int nfft = plan->nfft;
+    const int len = plan->frame_len;
+    const int overlap = MBE_NOISE_OVERLAP * rate;
+    float* Uw = plan->Uw;
+    float* Uw_fft = plan->Uw_fft;
+    float* Uw_out = plan->Uw_out;
+    float* scalor = plan->scalor;
+
+    /* Algorithm #117 at the output rate, with the same frame overlap */
+    memcpy(Uw, rs->noiseOverlap, (size_t)overlap * sizeof(float));
+    mbe_generate_noise_lcg(Uw + overlap, nfft - overlap, &rs->noiseSeed);
+    memcpy(rs->noiseOverlap, Uw + (nfft - overlap), (size_t)overlap * sizeof(float));
+
+    for (int i = 0; i < nfft; i++) {
+        Uw[i] *= plan->analysis[i];
+    }
+
+    pffft_transform_ordered(plan->setup, Uw, Uw_fft, plan->work, PFFFT_FORWARD);
+
+    /* Algorithms #120-123: bins are 31.25 Hz apart at every rate, so the
+     * band edges are those of the 8 kHz path */
+    memset(scalor, 0, sizeof(plan->scalor));
+    float multiplier = MBE_256_OVER_2PI * cur_mp->w0;
+    for (int l = 1; l <= cur_mp->L; l++) {
+        if (cur_mp->Vl[l] != 0) {
+            continue;
+        }
+        int a_min = (int)ceilf((l - 0.5f) * multiplier);
+        int b_max = (int)ceilf((l + 0.5f) * multiplier);
+        if (a_min < 0) {
+            a_min = 0;
+        }
+        if (b_max > MBE_FFT_SIZE / 2) {
+            b_max = MBE_FFT_SIZE / 2;
+        }
+
+        int bin_count = b_max - a_min;
+        float numerator = mbe_magnitude_squared_sum(Uw_fft, a_min, b_max);
+        if (bin_count > 0 && numerator > 1e-10f) {
+            float s = MBE_UNVOICED_SCALE_COEFF * cur_mp->Ml[l] / sqrtf(numerator / (float)bin_count);
+            for (int bin = a_min; bin < b_max; bin++) {
+                scalor[bin] = s;
+            }
+        }
+    }
+
+    /* Scale bins below 4 kHz and clear everything above, including the
+     * Nyquist bin of the larger transform */
+    Uw_fft[0] *= scalor[0];
+    Uw_fft[1] = 0.0f;
+    for (int bin = 1; bin < MBE_FFT_SIZE / 2; bin++) {
+        Uw_fft[2 * bin] *= scalor[bin];
+        Uw_fft[(2 * bin) + 1] *= scalor[bin];
+    }
+    memset(Uw_fft + MBE_FFT_SIZE, 0, (size_t)(nfft - MBE_FFT_SIZE) * sizeof(float));
+
+    /* Algorithm #125 (normalisation is folded into the WOLA weights) */
+    pffft_transform_ordered(plan->setup, Uw_fft, Uw_out, plan->work, PFFFT_BACKWARD);
+
+    /* Algorithm #126: previous frame from 128 * rate, current frame from -32 * rate */
+    const float* prev = rs->previousUw + (128 * rate);
+    const float* curr = Uw_out;
+    const float* a = plan->wola_a;
+    const float* b = plan->wola_b;
+    const int both = 32 * rate;
+    const int prev_end = 128 * rate;
+    int n = 0;
+    for (; n < both; n++) {
+        output[n] += a[n] * prev[n];
+    }
+    for (; n < prev_end; n++) {
+        output[n] += (a[n] * prev[n]) + (b[n] * curr[n - both]);
+    }
+    for (; n < len; n++) {
+        output[n] += b[n] * curr[n - both];
+    }
+
+    memcpy(rs->previousUw, Uw_out, (size_t)nfft * sizeof(float));
+}
@@ -53,6 +53,68 @@ mbe_fft_plan* mbe_fft_plan_alloc(void);
  */
 void mbe_fft_plan_free(mbe_fft_plan* plan);
 
+/**
+ * @brief Opaque plan for unvoiced synthesis at a multiple of 8 kHz.
+ */
+typedef struct mbe_rate_plan mbe_rate_plan;
+
+/**
+ * @brief Allocate a plan for rate synthesis.
+ *
+ * Creates a 256 * rate point real FFT, the synthesis and WOLA windows
+ * resampled to the output rate, the voiced window ws resampled to
+ * 320 * rate samples for the harmonic oscillators, and the comfort noise
+ * interpolator's per-phase taps.
+ *
+ * @param rate Output rate as a multiple of 8 kHz (1..MBE_MAX_RATE).
+ * @param ws   321-sample voiced synthesis window at 8 kHz.
+ * @return Allocated plan, or NULL on failure.
+ */
+mbe_rate_plan* mbe_rate_plan_alloc(int rate, const float* ws);
+
+/**
+ * @brief Free a rate synthesis plan.
+ *
+ * @param plan Plan to free.
+ */
+void mbe_rate_plan_free(mbe_rate_plan* plan);
+
+/**
+ * @brief Voiced synthesis window at the plan's rate (320 * rate samples).
+ *
+ * @param plan Rate synthesis plan.
+ * @return Window; the first half fades in, the second half fades out.
+ */
+const float* mbe_rate_plan_voiced_window(const mbe_rate_plan* plan);
+
+/**
+ * @brief Interpolate one frame of 8 kHz comfort noise to the plan's rate.
+ *
+ * A Hann-windowed sinc interpolator keeps the noise below 4 kHz, as the
+ * voiced and unvoiced rate paths are; the state carries the filter history
+ * across frames, so the output lags the input by MBE_COMFORT_TAPS / 2 samples.
+ *
+ * @param buf  In: 160 comfort noise samples at 8 kHz. Out: 160 * rate samples.
+ * @param rs   In/out rate synthesis state (comfort noise history).
+ * @param plan Rate synthesis plan matching rs->rate.
+ */
+void mbe_interpolateComfortNoiseRate(float* buf, mbe_rate_state* rs, const mbe_rate_plan* plan);
+
+/**
+ * @brief Synthesize unvoiced speech at the plan's rate.
+ *
+ * Follows mbe_synthesizeUnvoicedFFT with every length scaled by the rate:
+ * noise from the state's own LCG, a 256 * rate point FFT whose bins keep
+ * the 31.25 Hz spacing (and so the 8 kHz band edges), and WOLA against the
+ * state's previous frame. Bins above 4 kHz are left empty.
+ *
+ * @param output Output buffer of 160 * rate samples (added to existing content).
+ * @param cur_mp Current frame parameters.
+ * @param rs In/out rate synthesis state (noise and WOLA history).
+ * @param plan Rate synthesis plan matching rs->rate.
+ */
+void mbe_synthesizeUnvoicedRate(float* output, const mbe_parms* cur_mp, mbe_rate_state* rs, mbe_rate_plan* plan);
+
 /**
  * @brief Generate LCG noise samples for unvoiced synthesis.
  *
@@ -109,6 +171,19 @@ void mbe_synthesizeUnvoicedFFT(float* output, mbe_parms* cur_mp, mbe_parms* prev
 void mbe_synthesizeUnvoicedFFTWithNoise(float* output, mbe_parms* cur_mp, mbe_parms* prev_mp, mbe_fft_plan* plan,
                                         const float* noise_buffer);
 
+/**
+ * @brief Update the unvoiced WOLA state without producing output.
+ *
+ * Computes the same IFFT output as mbe_synthesizeUnvoicedFFTWithNoise and
+ * stores it in cur_mp->previousUw, skipping the overlap-add. Used to bring
+ * deferred (parameter-only) frames up to date before synthesis resumes.
+ *
+ * @param cur_mp Frame parameters (previousUw is updated).
+ * @param plan FFT plan (reusable).
+ * @param noise_buffer The frame's 256-sample noise buffer.
+ */
+void mbe_updateUnvoicedFFTState(mbe_parms* cur_mp, mbe_fft_plan* plan, const float* noise_buffer);
+
 /**
  * @brief Get the 211-element synthesis window value.
  *
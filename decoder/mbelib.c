@@ -70,6 +70,33 @@ mbe_get_fft_plan(void) {
     return mbe_fft_plan_instance;
 }
 
+/* Thread-local rate synthesis plans, indexed by rate multiple */
+static MBE_THREAD_LOCAL mbe_rate_plan* mbe_rate_plan_instance[MBE_MAX_RATE + 1];
+
+/**
+ * @brief Get or create the thread-local rate synthesis plan for a rate.
+ * @param rate Output rate as a multiple of 8 kHz (1..MBE_MAX_RATE).
+ * @return Rate plan, or NULL on allocation failure.
+ */
+static mbe_rate_plan*
+mbe_get_rate_plan(int rate) {
+    if (MBE_LIKELY(mbe_rate_plan_instance[rate] != NULL)) {
+        return mbe_rate_plan_instance[rate];
+    }
+    mbe_rate_plan_instance[rate] = mbe_rate_plan_alloc(rate, Ws);
+    return mbe_rate_plan_instance[rate];
+}
+
+void
+mbe_releaseThreadPlans(void) {
+    mbe_fft_plan_free(mbe_fft_plan_instance);
+    mbe_fft_plan_instance = NULL;
+    for (int rate = 1; rate <= MBE_MAX_RATE; rate++) {
+        mbe_rate_plan_free(mbe_rate_plan_instance[rate]);
+        mbe_rate_plan_instance[rate] = NULL;
+    }
+}
+
 void
 mbe_setThreadRngSeed(uint32_t seed) {
     if (seed == 0u) {
@@ -493,38 +520,39 @@ mbe_spectralAmpEnhance(mbe_parms* cur_mp) {
 
 // Tone synthesis mapping adapted from OP25 (Boatbod)
 /**
- * @brief Synthesize a tone frame into 160 float samples at 8 kHz.
- * @param aout_buf Output buffer of 160 float samples.
+ * @brief Synthesize a tone frame into 160 * rate float samples.
+ *
+ * The tone clock swn still advances by one per 8 kHz sample, with the
+ * samples in between taken at fractional steps, so tones stay continuous
+ * whatever the output rate.
+ *
+ * @param aout_buf Output buffer of 160 * rate float samples.
+ * @param rate     Output rate as a multiple of 8 kHz.
  * @param ambe_d   AMBE parameter bits (49) providing tone indices.
  * @param cur_mp   Current parameter set (tone synthesis state).
  */
 void
-mbe_synthesizeTonef(float* aout_buf, char* ambe_d, mbe_parms* cur_mp) {
-    int i, n;
+mbe_synthesizeToneRatef(float* aout_buf, int rate, char* ambe_d, mbe_parms* cur_mp) {
+    mbe_synthesizeTonePackedRatef(aout_buf, rate, mbe_packAmbe2450Data(ambe_d), cur_mp);
+}
+
+/**
+ * @brief Synthesize a tone frame from a packed AMBE 2450 parameter word.
+ * @param aout_buf Output buffer of 160 * rate float samples.
+ * @param rate     Output rate as a multiple of 8 kHz.
+ * @param ambe_u   Packed parameter word (see mbe_packAmbe2450Data).
+ * @param cur_mp   Current parameter set (tone synthesis state).
+ */
+void
+mbe_synthesizeTonePackedRatef(float* aout_buf, int rate, uint64_t ambe_u, mbe_parms* cur_mp) {
+    int n, k;
     float* aout_buf_p;
 
     int u0, u1, u2, u3;
-    u0 = u1 = u2 = u3 = 0;
-
-    for (i = 0; i < 12; i++) {
-        u0 = u0 << 1;
-        u0 = u0 | (int)ambe_d[i];
-    }
-
-    for (i = 12; i < 24; i++) {
-        u1 = u1 << 1;
-        u1 = u1 | (int)ambe_d[i];
-    }
-
-    for (i = 24; i < 35; i++) {
-        u2 = u2 << 1;
-        u2 = u2 | (int)ambe_d[i];
-    }
-
-    for (i = 35; i < 49; i++) {
-        u3 = u3 << 1;
-        u3 = u3 | (int)ambe_d[i];
-    }
+    u0 = (int)(ambe_u >> 37) & 0xfff;
+    u1 = (int)(ambe_u >> 25) & 0xfff;
+    u2 = (int)(ambe_u >> 14) & 0x7ff;
+    u3 = (int)ambe_u & 0x3fff;
 
     int AD, ID0, ID1, ID2, ID3, ID4;
     AD = ((u0 & 0x3f) << 1) + ((u3 >> 4) & 0x1);
@@ -545,7 +573,7 @@ mbe_synthesizeTonef(float* aout_buf, char* ambe_d, mbe_parms* cur_mp) {
 
 #ifdef DISABLE_AMBE_TONES // generate silence if tones disabled
     aout_buf_p = aout_buf;
-    for (n = 0; n < 160; n++) {
+    for (n = 0; n < 160 * rate; n++) {
         *aout_buf_p = (float)0;
         aout_buf_p++;
     }
@@ -726,7 +754,7 @@ mbe_synthesizeTonef(float* aout_buf, char* ambe_d, mbe_parms* cur_mp) {
     // Zero amplitude or unimplemented tone IDs
     if ((freq1 == 0) && (freq2 == 0)) {
         aout_buf_p = aout_buf;
-        for (n = 0; n < 160; n++) {
+        for (n = 0; n < 160 * rate; n++) {
             *aout_buf_p = (float)0;
             aout_buf_p++;
         }
@@ -742,13 +770,27 @@ mbe_synthesizeTonef(float* aout_buf, char* ambe_d, mbe_parms* cur_mp) {
     amplitude = AD * 75.0f; //
     aout_buf_p = aout_buf;
     for (n = 0; n < 160; n++) {
-        *aout_buf_p = amplitude * (sinf((cur_mp->swn) * step1) / 2.0f + sinf((cur_mp->swn) * step2) / 2.0f);
-        *aout_buf_p = *aout_buf_p / 6.0f;
-        aout_buf_p++;
+        for (k = 0; k < rate; k++) {
+            float t = (float)cur_mp->swn + ((float)k / (float)rate);
+            *aout_buf_p = amplitude * (sinf(t * step1) / 2.0f + sinf(t * step2) / 2.0f);
+            *aout_buf_p = *aout_buf_p / 6.0f;
+            aout_buf_p++;
+        }
         cur_mp->swn++;
     }
 }
 
+/**
+ * @brief Synthesize a tone frame into 160 float samples at 8 kHz.
+ * @param aout_buf Output buffer of 160 float samples.
+ * @param ambe_d   AMBE parameter bits (49) providing tone indices.
+ * @param cur_mp   Current parameter set (tone synthesis state).
+ */
+void
+mbe_synthesizeTonef(float* aout_buf, char* ambe_d, mbe_parms* cur_mp) {
+    mbe_synthesizeToneRatef(aout_buf, 1, ambe_d, cur_mp);
+}
+
 // Simplified D-STAR single-frequency tone synthesis based on existing approximations
 /**
  * @brief Synthesize a D-STAR style tone into 160 float samples.
@@ -828,45 +870,44 @@ mbe_synthesizeSilence(short* aout_buf) {
     memset(aout_buf, 0, 160 * sizeof(*aout_buf));
 }
 
+/* JMBE-compatible white noise scalar for phase calculation: 2*PI / 53125 */
+#define MBE_WHITE_NOISE_SCALAR (2.0f * (float)M_PI / 53125.0f)
+
 /**
- * @brief Synthesize one speech frame into 160 float samples at 8 kHz.
+ * @brief Frame state update shared by synthesis and the state-only path.
  *
- * Uses FFT-based unvoiced synthesis (JMBE Algorithms #117-126) for
- * high-quality unvoiced audio with proper WOLA frame blending.
+ * Handles muting, generates the frame's noise buffer, applies adaptive
+ * smoothing, aligns band counts and updates phases. Everything here only
+ * touches parameter state, except that a muted frame writes comfort noise
+ * to aout_buf.
  *
- * @param aout_buf Output buffer of 160 float samples.
- * @param cur_mp   Current parameter set.
- * @param prev_mp  Previous parameter set.
- * @param uvquality Unvoiced synthesis quality (ignored, kept for API compatibility).
+ * @param aout_buf     Output buffer (written only when muted).
+ * @param cur_mp       Current parameter set.
+ * @param prev_mp      Previous parameter set.
+ * @param noise_buffer Output: 256-sample noise buffer for this frame.
+ * @param maxl_out     Output: number of bands to synthesise.
+ * @return 0 if the frame was muted, 1 otherwise.
  */
-/* JMBE-compatible white noise scalar for phase calculation: 2*PI / 53125 */
-#define MBE_WHITE_NOISE_SCALAR (2.0f * (float)M_PI / 53125.0f)
-
-void
-mbe_synthesizeSpeechf(float* aout_buf, mbe_parms* cur_mp, mbe_parms* prev_mp, int uvquality) {
+static int
+mbe_prepareSpeechState(float* aout_buf, mbe_parms* cur_mp, mbe_parms* prev_mp, float* noise_buffer, int* maxl_out) {
 
-    int l, n, maxl;
-    float* Ss;
+    int l, maxl;
     int numUv;
-    float cw0, pw0, cw0l, pw0l;
+    float cw0, pw0;
 
     const int N = 160;
 
-    /* Silence unused parameter warning - uvquality is kept for API compatibility */
-    (void)uvquality;
-
     /* Frame muting: generate comfort noise if error rate too high or max repeats exceeded */
     if (mbe_isMaxFrameRepeat(cur_mp) || mbe_requiresMuting(cur_mp)) {
         mbe_synthesizeComfortNoisef(aout_buf);
         /* Copy state from previous frame for potential recovery */
         mbe_useLastMbeParms(cur_mp, prev_mp);
         cur_mp->repeatCount = 0; /* Reset repeat count after muting */
-        return;
+        return 0;
     }
 
     /* Algorithm #117: Generate 256 white noise samples FIRST (JMBE-compatible)
      * This buffer is used for both phase calculation and unvoiced synthesis */
-    float noise_buffer[256];
     mbe_generate_noise_with_overlap(noise_buffer, &cur_mp->noiseSeed, cur_mp->noiseOverlap);
 
     /* Count number of unvoiced bands */
@@ -880,9 +921,6 @@ mbe_synthesizeSpeechf(float* aout_buf, mbe_parms* cur_mp, mbe_parms* prev_mp, in
     cw0 = cur_mp->w0;
     pw0 = prev_mp->w0;
 
-    /* Initialize output buffer to zero */
-    memset(aout_buf, 0, N * sizeof(float));
-
     /* Apply adaptive smoothing (Algorithms #111-116)
      * JMBE-compatible: Always call to track local energy even if smoothing isn't needed.
      * The function will return early after updating energy if smoothing is not required. */
@@ -917,6 +955,78 @@ mbe_synthesizeSpeechf(float* aout_buf, mbe_parms* cur_mp, mbe_parms* prev_mp, in
         }
     }
 
+    *maxl_out = maxl;
+    return 1;
+}
+
+/**
+ * @brief Advance speech state for one frame without synthesising audio.
+ *
+ * Applies every parameter-state update mbe_synthesizeSpeechf performs except
+ * the unvoiced FFT, whose WOLA state (previousUw) is deferred. Call
+ * mbe_completeSpeechState with the returned noise buffer on the frame's
+ * final parameter set before synthesis resumes.
+ *
+ * @param cur_mp       Current parameter set.
+ * @param prev_mp      Previous parameter set.
+ * @param noise_buffer Output: 256-sample noise buffer for this frame.
+ * @return 1 if previousUw is pending, 0 if the frame was muted (no update).
+ */
+int
+mbe_advanceSpeechState(mbe_parms* cur_mp, mbe_parms* prev_mp, float* noise_buffer) {
+    float scratch[160];
+    int maxl;
+
+    return mbe_prepareSpeechState(scratch, cur_mp, prev_mp, noise_buffer, &maxl);
+}
+
+/**
+ * @brief Complete the deferred unvoiced state of a frame.
+ * @param mp           Parameter set of the deferred frame (previousUw updated).
+ * @param noise_buffer Noise buffer returned by mbe_advanceSpeechState.
+ */
+void
+mbe_completeSpeechState(mbe_parms* mp, const float* noise_buffer) {
+    mbe_fft_plan* plan = mbe_get_fft_plan();
+    if (plan) {
+        mbe_updateUnvoicedFFTState(mp, plan, noise_buffer);
+    }
+}
+
+/**
+ * @brief Synthesize one speech frame into 160 float samples at 8 kHz.
+ *
+ * Uses FFT-based unvoiced synthesis (JMBE Algorithms #117-126) for
+ * high-quality unvoiced audio with proper WOLA frame blending.
+ *
+ * @param aout_buf Output buffer of 160 float samples.
+ * @param cur_mp   Current parameter set.
+ * @param prev_mp  Previous parameter set.
+ * @param uvquality Unvoiced synthesis quality (ignored, kept for API compatibility).
+ */
+void
+mbe_synthesizeSpeechf(float* aout_buf, mbe_parms* cur_mp, mbe_parms* prev_mp, int uvquality) {
+
+    int l, n, maxl;
+    float* Ss;
+    float cw0, pw0, cw0l, pw0l;
+
+    const int N = 160;
+
+    /* Silence unused parameter warning - uvquality is kept for API compatibility */
+    (void)uvquality;
+
+    float noise_buffer[256];
+    if (!mbe_prepareSpeechState(aout_buf, cur_mp, prev_mp, noise_buffer, &maxl)) {
+        return;
+    }
+
+    cw0 = cur_mp->w0;
+    pw0 = prev_mp->w0;
+
+    /* Initialize output buffer to zero */
+    memset(aout_buf, 0, N * sizeof(float));
+
     /* Synthesize voiced components
      * Use phase/amplitude interpolation (Algorithms #134-138) for low harmonics
      * when pitch is stable, otherwise use windowed oscillator approach
@@ -1001,6 +1111,216 @@ mbe_synthesizeSpeechf(float* aout_buf, mbe_parms* cur_mp, mbe_parms* prev_mp, in
     }
 }
 
+/* Samples evaluated together by mbe_add_harmonic_series (divides 160) */
+#define MBE_SERIES_BLOCK 16
+
+/**
+ * @brief Fill z(n) = exp(j * theta * n) for n = 0..len-1.
+ *
+ * The recurrence runs in double, so the phase is exact to float precision
+ * across the frame.
+ */
+static void
+mbe_rotation_table(float* restrict zr, float* restrict zi, float theta, int len) {
+    double cr = 1.0, ci = 0.0;
+    double dr = cos(theta), di = sin(theta);
+    for (int n = 0; n < len; n++) {
+        zr[n] = (float)cr;
+        zi[n] = (float)ci;
+        double t = (cr * dr) - (ci * di);
+        ci = (ci * dr) + (cr * di);
+        cr = t;
+    }
+}
+
+/**
+ * @brief Add a windowed harmonic series to the output.
+ *
+ * out[n] += W[n] * Re(sum of c[l] * z(n)^l for l = 1..maxl), evaluated by
+ * Horner's rule. Harmonics of one fundamental share z(n), and no state is
+ * carried from sample to sample, so the sample loop vectorises where one
+ * oscillator per harmonic would run serially.
+ *
+ * @param out Output buffer (len samples, added to).
+ * @param W   Window (len samples).
+ * @param zr,zi Rotation table from mbe_rotation_table.
+ * @param cr,ci Complex coefficient per harmonic (1..maxl).
+ * @param maxl Highest harmonic.
+ * @param len Samples; a multiple of MBE_SERIES_BLOCK.
+ */
+static void
+mbe_add_harmonic_series(float* restrict out, const float* restrict W, const float* restrict zr,
+                        const float* restrict zi, const float* restrict cr, const float* restrict ci, int maxl,
+                        int len) {
+    for (int n0 = 0; n0 < len; n0 += MBE_SERIES_BLOCK) {
+        const float* br = zr + n0;
+        const float* bi = zi + n0;
+        float ar[MBE_SERIES_BLOCK], ai[MBE_SERIES_BLOCK];
+
+        for (int k = 0; k < MBE_SERIES_BLOCK; k++) {
+            ar[k] = cr[maxl];
+            ai[k] = ci[maxl];
+        }
+        for (int l = maxl - 1; l >= 1; l--) {
+            for (int k = 0; k < MBE_SERIES_BLOCK; k++) {
+                float xr = (ar[k] * br[k]) - (ai[k] * bi[k]) + cr[l];
+                float xi = (ar[k] * bi[k]) + (ai[k] * br[k]) + ci[l];
+                ar[k] = xr;
+                ai[k] = xi;
+            }
+        }
+        for (int k = 0; k < MBE_SERIES_BLOCK; k++) {
+            out[n0 + k] += W[n0 + k] * ((ar[k] * br[k]) - (ai[k] * bi[k]));
+        }
+    }
+}
+
+/**
+ * @brief Initialize rate synthesis state.
+ * @param rs   Output: state to reset.
+ * @param rate Output rate as a multiple of 8 kHz; out-of-range values select 1.
+ */
+void
+mbe_initRateState(mbe_rate_state* rs, int rate) {
+    memset(rs, 0, sizeof(*rs));
+    rs->rate = (rate >= 1 && rate <= MBE_MAX_RATE) ? rate : 1;
+    rs->noiseSeed = MBE_LCG_DEFAULT_SEED;
+}
+
+/**
+ * @brief Synthesize one speech frame into 160 * rs->rate float samples.
+ *
+ * Runs the same frame state update as mbe_synthesizeSpeechf, then evaluates
+ * the voiced tracks at 1/rate sample steps and shapes unvoiced noise at the
+ * output rate. Windowed harmonics are summed per frame as one series in
+ * w0 / rate under the resampled window (see mbe_add_harmonic_series).
+ *
+ * @param aout_buf Output buffer of 160 * rs->rate float samples.
+ * @param rs       In/out: rate synthesis state.
+ * @param cur_mp   Current parameter set.
+ * @param prev_mp  Previous parameter set.
+ */
+void
+mbe_synthesizeSpeechRatef(float* aout_buf, mbe_rate_state* rs, mbe_parms* cur_mp, mbe_parms* prev_mp) {
+
+    int l, n, maxl;
+    float* Ss;
+    float cw0, pw0, cw0l, pw0l;
+
+    const int N = 160;
+    const int rate = rs->rate;
+    const int Nr = N * rate;
+    const float step = 1.0f / (float)rate;
+
+    float noise_buffer[256];
+    if (!mbe_prepareSpeechState(aout_buf, cur_mp, prev_mp, noise_buffer, &maxl)) {
+        /* Muted: the first 160 samples hold 8 kHz comfort noise */
+        if (rate > 1) {
+            mbe_rate_plan* plan = mbe_get_rate_plan(rate);
+            if (plan) {
+                mbe_interpolateComfortNoiseRate(aout_buf, rs, plan);
+            } else {
+                memset(aout_buf + N, 0, (Nr - N) * sizeof(float));
+            }
+        }
+        return;
+    }
+
+    memset(aout_buf, 0, Nr * sizeof(float));
+
+    mbe_rate_plan* plan = mbe_get_rate_plan(rate);
+    if (!plan) {
+        return;
+    }
+    const float* W = mbe_rate_plan_voiced_window(plan);
+
+    /* Harmonic series coefficients of the windowed components, and z(n) */
+    float prev_cr[57] = {0}, prev_ci[57] = {0}, cur_cr[57] = {0}, cur_ci[57] = {0};
+    int prev_top = 0, cur_top = 0; /* Highest windowed harmonic (0 = none) */
+    float zr[160 * MBE_MAX_RATE], zi[160 * MBE_MAX_RATE];
+
+    cw0 = cur_mp->w0;
+    pw0 = prev_mp->w0;
+
+    /* Voiced components, as mbe_synthesizeSpeechf with n replaced by n / rate */
+    for (l = 1; l <= maxl; l++) {
+        cw0l = cw0 * (float)l;
+        pw0l = pw0 * (float)l;
+
+        int cur_voiced = (cur_mp->Vl[l] == 1);
+        int prev_voiced = (prev_mp->Vl[l] == 1);
+
+        if (cur_voiced || prev_voiced) {
+            int use_interpolation = (l < 8) && cur_voiced && prev_voiced && (fabsf(cw0 - pw0) < (0.1f * cw0));
+
+            if (use_interpolation) {
+                Ss = aout_buf;
+
+                /* Algorithms #137-138: phase deviation and its rate */
+                float deltaphil = cur_mp->PHIl[l] - prev_mp->PHIl[l] - (((pw0 + cw0) * (float)(l * N)) / 2.0f);
+                float deltawl =
+                    (1.0f / (float)N)
+                    * (deltaphil - (2.0f * (float)M_PI * floorf((deltaphil + (float)M_PI) / (2.0f * (float)M_PI))));
+
+                /* Algorithms #134-136 at t = n / rate. The phase is quadratic in n,
+                 * so it is tracked by a rotation that is itself rotated every
+                 * sample, in double to keep the phase exact over the frame. */
+                double a = (double)(pw0l + deltawl) * step;
+                double b = (double)(cw0 - pw0) * l * step * step / (double)(2 * N);
+                double ur = cos(prev_mp->PHIl[l]), ui = sin(prev_mp->PHIl[l]);
+                double rr = cos(a + b), ri = sin(a + b);
+                double qr = cos(2.0 * b), qi = sin(2.0 * b);
+                float aln = prev_mp->Ml[l];
+                float daln = (cur_mp->Ml[l] - prev_mp->Ml[l]) / (float)Nr;
+
+                for (n = 0; n < Nr; n++) {
+                    *Ss += 2.0f * aln * (float)ur;
+                    Ss++;
+                    aln += daln;
+
+                    double t = (ur * rr) - (ui * ri);
+                    ui = (ui * rr) + (ur * ri);
+                    ur = t;
+                    t = (rr * qr) - (ri * qi);
+                    ri = (ri * qr) + (rr * qi);
+                    rr = t;
+                }
+            } else {
+                /* Windowed components, summed below as harmonic series:
+                 * 2 * Ml * exp(j * phase at n = 0) per harmonic */
+                if (prev_voiced) {
+                    float sp, cp;
+                    mbe_sincosf(prev_mp->PHIl[l], &sp, &cp);
+                    prev_cr[l] = 2.0f * prev_mp->Ml[l] * cp;
+                    prev_ci[l] = 2.0f * prev_mp->Ml[l] * sp;
+                    prev_top = l;
+                }
+                if (cur_voiced) {
+                    float sc, cc;
+                    mbe_sincosf(cur_mp->PHIl[l] - (cw0l * (float)N), &sc, &cc);
+                    cur_cr[l] = 2.0f * cur_mp->Ml[l] * cc;
+                    cur_ci[l] = 2.0f * cur_mp->Ml[l] * sc;
+                    cur_top = l;
+                }
+            }
+        }
+    }
+
+    /* Previous frame fades out over the second half of the window, the
+     * current frame fades in over the first */
+    if (prev_top) {
+        mbe_rotation_table(zr, zi, pw0 * step, Nr);
+        mbe_add_harmonic_series(aout_buf, W + Nr, zr, zi, prev_cr, prev_ci, prev_top, Nr);
+    }
+    if (cur_top) {
+        mbe_rotation_table(zr, zi, cw0 * step, Nr);
+        mbe_add_harmonic_series(aout_buf, W, zr, zi, cur_cr, cur_ci, cur_top, Nr);
+    }
+
+    /* Unvoiced components at the output rate, with their own noise sequence */
+    mbe_synthesizeUnvoicedRate(aout_buf, cur_mp, rs, plan);
+}
+
 /**
  * @brief Synthesize one speech frame into 160 16-bit samples at 8 kHz.
  * @param aout_buf Output buffer of 160 16-bit samples.
@@ -121,6 +121,32 @@ struct mbe_parameters {
 
 typedef struct mbe_parameters mbe_parms;
 
+/** Highest output rate multiple of 8 kHz supported by rate synthesis (48 kHz). */
+#define MBE_MAX_RATE 6
+
+/** Taps of the interpolator that carries 8 kHz comfort noise to higher rates. */
+#define MBE_COMFORT_TAPS 32
+
+/**
+ * @brief Unvoiced synthesis state for output at a multiple of 8 kHz.
+ *
+ * Parameter and phase state stay in mbe_parms and do not depend on the
+ * output rate; the noise sequence and WOLA history of the larger unvoiced
+ * FFT are kept here instead of in previousUw/noiseSeed/noiseOverlap.
+ */
+typedef struct {
+    /** Output rate as a multiple of 8 kHz (1..MBE_MAX_RATE). */
+    int rate;
+    /** LCG noise generator state (seed). */
+    float noiseSeed;
+    /** Noise buffer overlap for continuity (96 * rate samples). */
+    float noiseOverlap[96 * MBE_MAX_RATE];
+    /** Previous frame inverse FFT output for WOLA (256 * rate samples, unnormalised). */
+    float previousUw[256 * MBE_MAX_RATE];
+    /** Last MBE_COMFORT_TAPS comfort noise samples at 8 kHz, for the interpolator. */
+    float comfortHistory[MBE_COMFORT_TAPS];
+} mbe_rate_state;
+
 /**
  * @brief Correct a (23,12) Golay encoded block in-place and extract data.
  * @param block Pointer to packed 23-bit block (upper bits ignored). On return, contains 12-bit data.
@@ -223,12 +249,54 @@ MBE_API int mbe_eccAmbe3600x2450C0(char ambe_fr[4][24]);
 MBE_API int mbe_eccAmbe3600x2450Data(char ambe_fr[4][24], char* ambe_d);
 /** @brief Decode AMBE 2450 parameters. */
 MBE_API int mbe_decodeAmbe2450Parms(char* ambe_d, mbe_parms* cur_mp, mbe_parms* prev_mp);
+/*
+ * Packed AMBE 2450 parameters: the 49 parameter bits as one word,
+ * ambe_d[0] in bit 48 (u0, u1, u2, u3 from the top). Fields b0..b8 move
+ * in and out with one PEXT/PDEP each on BMI2 builds, or two shift/mask
+ * pairs otherwise.
+ */
+/** @brief Pack 49 parameter bits (one per element) into a word. */
+MBE_API uint64_t mbe_packAmbe2450Data(const char ambe_d[49]);
+/** @brief Extract b0..b8 from a packed parameter word. */
+MBE_API void mbe_unpackAmbe2450Fields(uint64_t ambe_u, int b[9]);
+/** @brief Pack b0..b8 into a parameter word. */
+MBE_API uint64_t mbe_packAmbe2450Fields(const int b[9]);
+/** @brief Decode AMBE 2450 parameters from a packed parameter word. */
+MBE_API int mbe_decodeAmbe2450PackedParms(uint64_t ambe_u, mbe_parms* cur_mp, mbe_parms* prev_mp);
 /** @brief Demodulate AMBE 3600x2450 interleaved data. */
 MBE_API void mbe_demodulateAmbe3600x2450Data(char ambe_fr[4][24]);
-/** @brief Process AMBE 2450 parameters into float PCM. */
-MBE_API void mbe_processAmbe2450Dataf(float* aout_buf, int* errs, int* errs2, char* err_str, char ambe_d[49],
+/** @brief Process AMBE 2450 parameters into float PCM (returns MBE_STATE_RESET on silence). */
+MBE_API int mbe_processAmbe2450Dataf(float* aout_buf, int* errs, int* errs2, char* err_str, char ambe_d[49],
                                       mbe_parms* cur_mp, mbe_parms* prev_mp, mbe_parms* prev_mp_enhanced,
                                       int uvquality);
+/**
+ * @brief Process AMBE 2450 parameters into 160 * rs->rate float samples.
+ *
+ * Same as mbe_processAmbe2450Dataf, but synthesises directly at the output
+ * rate of rs (16 kHz for rate 2, 48 kHz for rate 6) rather than at 8 kHz.
+ */
+MBE_API int mbe_processAmbe2450DataRatef(float* aout_buf, mbe_rate_state* rs, int* errs, int* errs2, char* err_str,
+                                         char ambe_d[49], mbe_parms* cur_mp, mbe_parms* prev_mp,
+                                         mbe_parms* prev_mp_enhanced);
+/** @brief State codes returned by mbe_processAmbe2450Dataf and mbe_processAmbe2450Parmsf. */
+#define MBE_STATE_UNCHANGED 0
+#define MBE_STATE_DEFERRED  1
+#define MBE_STATE_RESET     2
+/** @brief Process AMBE 2450 parameters and update state without synthesis. */
+MBE_API int mbe_processAmbe2450Parmsf(int* errs, int* errs2, char* err_str, char ambe_d[49], mbe_parms* cur_mp,
+                                      mbe_parms* prev_mp, mbe_parms* prev_mp_enhanced, float* noise_buffer);
+/** @brief Packed-word variants of the three functions above. */
+MBE_API int mbe_processAmbe2450PackedDataf(float* aout_buf, int* errs, int* errs2, char* err_str, uint64_t ambe_u,
+                                           mbe_parms* cur_mp, mbe_parms* prev_mp, mbe_parms* prev_mp_enhanced,
+                                           int uvquality);
+MBE_API int mbe_processAmbe2450PackedDataRatef(float* aout_buf, mbe_rate_state* rs, int* errs, int* errs2,
+                                               char* err_str, uint64_t ambe_u, mbe_parms* cur_mp, mbe_parms* prev_mp,
+                                               mbe_parms* prev_mp_enhanced);
+MBE_API int mbe_processAmbe2450PackedParmsf(int* errs, int* errs2, char* err_str, uint64_t ambe_u, mbe_parms* cur_mp,
+                                            mbe_parms* prev_mp, mbe_parms* prev_mp_enhanced, float* noise_buffer);
+/** @brief Conceal a lost AMBE 2450 frame into float PCM, repeating then muting as for uncorrectable frames. */
+MBE_API int mbe_processAmbe2450Lostf(float* aout_buf, char* err_str, mbe_parms* cur_mp, mbe_parms* prev_mp,
+                                     mbe_parms* prev_mp_enhanced, int uvquality);
 /** @brief Process AMBE 2450 parameters into 16-bit PCM. */
 MBE_API void mbe_processAmbe2450Data(short* aout_buf, int* errs, int* errs2, char* err_str, char ambe_d[49],
                                      mbe_parms* cur_mp, mbe_parms* prev_mp, mbe_parms* prev_mp_enhanced, int uvquality);
@@ -312,6 +380,12 @@ MBE_API const char* mbe_versionString(void);
  * @param seed Any non-zero 32-bit seed value.
  */
 MBE_API void mbe_setThreadRngSeed(uint32_t seed);
+
+/**
+ * @brief Free the calling thread's FFT and rate synthesis plans.
+ *        They are allocated again on the next synthesis in this thread.
+ */
+MBE_API void mbe_releaseThreadPlans(void);
 /**
  * @brief Copy MBE parameter set from one struct to another.
  * @param cur_mp Source parameters.
@@ -351,6 +425,16 @@ MBE_API void mbe_synthesizeTonef(float* aout_buf, char* ambe_d, mbe_parms* cur_m
  * @param ID1      Tone index selector.
  */
 MBE_API void mbe_synthesizeTonefdstar(float* aout_buf, char* ambe_d, mbe_parms* cur_mp, int ID1);
+/**
+ * @brief Synthesize tone frame into float PCM at a multiple of 8 kHz.
+ * @param aout_buf Output buffer of 160 * rate float samples.
+ * @param rate     Output rate as a multiple of 8 kHz (1..MBE_MAX_RATE).
+ * @param ambe_d   AMBE parameter bits (49).
+ * @param cur_mp   Current parameter set (tone synthesis state).
+ */
+MBE_API void mbe_synthesizeToneRatef(float* aout_buf, int rate, char* ambe_d, mbe_parms* cur_mp);
+/** @brief Packed-word variant of mbe_synthesizeToneRatef. */
+MBE_API void mbe_synthesizeTonePackedRatef(float* aout_buf, int rate, uint64_t ambe_u, mbe_parms* cur_mp);
 /** @brief Fill float PCM buffer with 160 samples of silence. */
 MBE_API void mbe_synthesizeSilencef(float* aout_buf);
 /** @brief Fill 16-bit PCM buffer with 160 samples of silence. */
@@ -363,6 +447,41 @@ MBE_API void mbe_synthesizeSilence(short* aout_buf);
  * @param uvquality Unvoiced synthesis quality (1..64).
  */
 MBE_API void mbe_synthesizeSpeechf(float* aout_buf, mbe_parms* cur_mp, mbe_parms* prev_mp, int uvquality);
+/**
+ * @brief Initialize rate synthesis state.
+ * @param rs   Output: state to reset.
+ * @param rate Output rate as a multiple of 8 kHz; out-of-range values select 1.
+ */
+MBE_API void mbe_initRateState(mbe_rate_state* rs, int rate);
+/**
+ * @brief Synthesize one speech frame directly at a multiple of 8 kHz.
+ *
+ * Harmonics are generated at the output rate with the same phase and
+ * amplitude tracks as mbe_synthesizeSpeechf; unvoiced bands are shaped in
+ * a 256 * rate point FFT with the same 31.25 Hz bin spacing, so nothing is
+ * produced above 4 kHz and no anti-imaging filter is needed.
+ *
+ * @param aout_buf Output buffer of 160 * rs->rate float samples.
+ * @param rs       In/out: rate synthesis state.
+ * @param cur_mp   Current parameter set.
+ * @param prev_mp  Previous parameter set.
+ */
+MBE_API void mbe_synthesizeSpeechRatef(float* aout_buf, mbe_rate_state* rs, mbe_parms* cur_mp, mbe_parms* prev_mp);
+/**
+ * @brief Advance speech state for one frame without synthesising audio.
+ * @param cur_mp       Current parameter set.
+ * @param prev_mp      Previous parameter set.
+ * @param noise_buffer Output: 256-sample noise buffer for this frame.
+ * @return 1 if the unvoiced WOLA state is pending (see mbe_completeSpeechState),
+ *         0 if the frame was muted.
+ */
+MBE_API int mbe_advanceSpeechState(mbe_parms* cur_mp, mbe_parms* prev_mp, float* noise_buffer);
+/**
+ * @brief Compute the deferred unvoiced WOLA state (previousUw) of a frame.
+ * @param mp           Parameter set of the deferred frame.
+ * @param noise_buffer Noise buffer returned by mbe_advanceSpeechState.
+ */
+MBE_API void mbe_completeSpeechState(mbe_parms* mp, const float* noise_buffer);
 /** @brief Synthesize one speech frame into 16-bit PCM. */
 MBE_API void mbe_synthesizeSpeech(short* aout_buf, mbe_parms* cur_mp, mbe_parms* prev_mp, int uvquality);
 /**
@@ -344,9 +344,24 @@ validate_pffft_simd() {} // allow test_pffft.c to call this function even when s
 /* SSE and co like 16-bytes aligned pointers */
 #define MALLOC_V4SF_ALIGNMENT 64 // with a 64-byte alignment, we are even aligned on L2 cache lines...
 
+/* allocator used for setups and aligned buffers, see pffft_set_allocator() */
+static void* (*pffft_alloc_fn)(size_t) = malloc;
+static void (*pffft_free_fn)(void*) = free;
+
+void
+pffft_set_allocator(void* (*alloc_fn)(size_t), void (*free_fn)(void*)) {
+    if (alloc_fn && free_fn) {
+        pffft_alloc_fn = alloc_fn;
+        pffft_free_fn = free_fn;
+    } else {
+        pffft_alloc_fn = malloc;
+        pffft_free_fn = free;
+    }
+}
+
 void*
 pffft_aligned_malloc(size_t nb_bytes) {
-    void *p, *p0 = malloc(nb_bytes + MALLOC_V4SF_ALIGNMENT);
+    void *p, *p0 = pffft_alloc_fn(nb_bytes + MALLOC_V4SF_ALIGNMENT);
     if (!p0) {
         return (void*)0;
     }
@@ -358,7 +373,7 @@ pffft_aligned_malloc(size_t nb_bytes) {
 void
 pffft_aligned_free(void* p) {
     if (p) {
-        free(*((void**)p - 1));
+        pffft_free_fn(*((void**)p - 1));
     }
 }
 
@@ -1368,7 +1383,10 @@ pffft_new_setup(int N, pffft_transform_t transform) {
         assert(0);
         return 0;
     }
-    PFFFT_Setup* s = (PFFFT_Setup*)malloc(sizeof(PFFFT_Setup));
+    PFFFT_Setup* s = (PFFFT_Setup*)pffft_alloc_fn(sizeof(PFFFT_Setup));
+    if (!s) {
+        return 0;
+    }
     int k, m;
     /* unfortunately, the fft size must be a multiple of 16 for complex FFTs
      and 32 for real FFTs -- a lot of stuff would need to be rewritten to
@@ -1385,6 +1403,10 @@ pffft_new_setup(int N, pffft_transform_t transform) {
     /* nb of complex simd vectors */
     s->Ncvec = (transform == PFFFT_REAL ? N / 2 : N) / SIMD_SZ;
     s->data = (v4sf*)pffft_aligned_malloc(2 * s->Ncvec * sizeof(v4sf));
+    if (!s->data) {
+        pffft_free_fn(s);
+        return 0;
+    }
     s->e = (float*)s->data;
     s->twiddle = (float*)(s->data + (2 * s->Ncvec * (SIMD_SZ - 1)) / SIMD_SZ);
 
@@ -1419,7 +1441,7 @@ pffft_new_setup(int N, pffft_transform_t transform) {
 void
 pffft_destroy_setup(PFFFT_Setup* s) {
     pffft_aligned_free(s->data);
-    free(s);
+    pffft_free_fn(s);
 }
 
 #if !defined(PFFFT_SIMD_DISABLE)
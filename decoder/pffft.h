@@ -173,6 +173,14 @@ void pffft_zconvolve_accumulate(PFFFT_Setup* setup, const float* dft_a, const fl
 void* pffft_aligned_malloc(size_t nb_bytes);
 void pffft_aligned_free(void*);
 
+/**
+    replace the allocator used by pffft_new_setup and pffft_aligned_malloc
+    (malloc/free by default). Passing NULL for either function restores the
+    defaults. Must not be changed while setups or buffers obtained from the
+    previous allocator are still alive.
+  */
+void pffft_set_allocator(void* (*alloc_fn)(size_t), void (*free_fn)(void*));
+
 /** return 4 or 1 wether support SSE/Altivec instructions was enable when building pffft.c */
 int pffft_simd_size(void);
 
@@ -4,13 +4,27 @@
  * Demonstrates the OpenDMR library for encoding and decoding DMR voice.
  *
  * Usage:
- *   dmr_codec decode <input.ambe> <output.raw>
- *   dmr_codec encode <input.raw> <output.ambe>
+ *   dmr_codec decode <input.ambe> <output.raw> [rate|ulaw|alaw]
+ *   dmr_codec encode <input.raw> <output.ambe> [rate|ulaw|alaw]
  *   dmr_codec transcode <input.ambe> <output.ambe>
+ *   dmr_codec regenerate <input.ambe> <output.ambe>
+ *   dmr_codec stereo <ts1.ambe> <ts2.ambe> <output.raw>
+ *   dmr_codec toimbe <input.ambe> <output.imbe>
+ *   dmr_codec fromimbe <input.imbe> <output.ambe>
+ *   dmr_codec roundtrip
+ *   dmr_codec schedule <input.ambe> <streams> [seconds]
+ *   dmr_codec conference <input.ambe> <output.ambe> <legs> <talkers>
+ *   dmr_codec jitter <input.ambe> <output.raw> <jitter_ms> <loss_pct>
+ *   dmr_codec latency <input.raw>
+ *   dmr_codec complexity <input.raw>
+ *   dmr_codec dtx <input.raw> <output.ambe>
  *
  * File formats:
  *   .ambe - Raw AMBE+2 frames (9 bytes per frame, 72 bits)
- *   .raw  - Raw PCM audio (16-bit signed, 8kHz mono, little-endian)
+ *   .raw  - Raw PCM audio (16-bit signed, mono, little-endian; 8kHz unless
+ *           a rate of 16000, 44100 or 48000 is given), or 8-bit G.711
+ *           mu-law or A-law at 8kHz with ulaw or alaw
+ *   .imbe - Raw P25 IMBE parameter frames (11 bytes per frame, 88 bits)
  *
  * The .raw files can be played with:
  *   aplay -f S16_LE -r 8000 -c 1 output.raw
@@ -20,7 +34,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include <stdint.h>
+#include <time.h>
 #include "opendmr.h"
 
 static void print_usage(const char *prog)
@@ -28,14 +44,30 @@ static void print_usage(const char *prog)
     printf("OpenDMR Codec Tool v%s\n", opendmr_version());
     printf("\n");
     printf("Usage:\n");
-    printf("  %s decode <input.ambe> <output.raw>   - Decode AMBE+2 to PCM\n", prog);
-    printf("  %s encode <input.raw> <output.ambe>   - Encode PCM to AMBE+2\n", prog);
+    printf("  %s decode <input.ambe> <output.raw> [rate|ulaw|alaw] - Decode AMBE+2 to PCM\n", prog);
+    printf("  %s encode <input.raw> <output.ambe> [rate|ulaw|alaw] - Encode PCM to AMBE+2\n", prog);
     printf("  %s transcode <in.ambe> <out.ambe>     - Decode and re-encode\n", prog);
+    printf("  %s regenerate <in.ambe> <out.ambe>    - Correct and re-encode FEC only\n", prog);
+    printf("  %s stereo <ts1.ambe> <ts2.ambe> <out.raw>\n", prog);
+    printf("                                        - Decode both timeslots to stereo PCM\n");
+    printf("  %s toimbe <in.ambe> <out.imbe>        - Transcode AMBE+2 to P25 IMBE\n", prog);
+    printf("  %s fromimbe <in.imbe> <out.ambe>      - Transcode P25 IMBE to AMBE+2\n", prog);
+    printf("  %s roundtrip                          - Check encoded parameters decode as analysed\n", prog);
+    printf("  %s schedule <in.ambe> <streams> [sec] - Real-time decode load on the tick scheduler\n", prog);
+    printf("  %s conference <in.ambe> <out.ambe> <legs> <talkers>\n", prog);
+    printf("                                        - N-minus-one conference mix\n");
+    printf("  %s jitter <in.ambe> <out.raw> <jitter_ms> <loss_pct>\n", prog);
+    printf("                                        - Decode through the jitter buffer over a simulated network\n");
+    printf("  %s latency <in.raw>                   - End-to-end delay of each encoder latency profile\n", prog);
+    printf("  %s complexity <in.raw>                - Cost and quality of each encoder complexity level\n", prog);
+    printf("  %s dtx <in.raw> <out.ambe>            - Encode with voice activity detection\n", prog);
     printf("  %s info                               - Show library info\n", prog);
     printf("\n");
     printf("File formats:\n");
     printf("  .ambe - Raw AMBE+2 frames (9 bytes/frame, 72 bits, 50 frames/sec)\n");
-    printf("  .raw  - Raw PCM audio (16-bit signed LE, 8kHz mono)\n");
+    printf("  .raw  - Raw PCM audio (16-bit signed LE, mono, 8kHz or [rate];\n");
+    printf("          8-bit G.711 at 8kHz with ulaw or alaw)\n");
+    printf("  .imbe - Raw P25 IMBE frames (11 bytes/frame, 88 bits, no P25 FEC)\n");
     printf("\n");
     printf("Convert .raw to .wav:\n");
     printf("  sox -t raw -r 8000 -e signed -b 16 -c 1 input.raw output.wav\n");
@@ -45,7 +77,31 @@ static void print_usage(const char *prog)
     printf("\n");
 }
 
-static int do_decode(const char *in_file, const char *out_file)
+/* Parse the optional [rate|ulaw|alaw] argument; law is -1 for 16-bit PCM */
+static bool parse_format(int argc, char *argv[], unsigned int *rate, int *law)
+{
+    *rate = OPENDMR_SAMPLE_RATE;
+    *law = -1;
+    if (argc != 5)
+        return true;
+
+    if (strcmp(argv[4], "ulaw") == 0) {
+        *law = OPENDMR_G711_ULAW;
+        return true;
+    }
+    if (strcmp(argv[4], "alaw") == 0) {
+        *law = OPENDMR_G711_ALAW;
+        return true;
+    }
+    *rate = (unsigned int)atoi(argv[4]);
+    if (opendmr_rate_samples(*rate) == 0) {
+        fprintf(stderr, "Error: rate must be 8000, 16000, 44100 or 48000, or ulaw or alaw\n");
+        return false;
+    }
+    return true;
+}
+
+static int do_decode(const char *in_file, const char *out_file, unsigned int rate, int law)
 {
     FILE *fin = fopen(in_file, "rb");
     if (!fin) {
@@ -69,16 +125,22 @@ static int do_decode(const char *in_file, const char *out_file)
     }
 
     uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES];
-    int16_t pcm[OPENDMR_PCM_SAMPLES];
+    int16_t pcm[OPENDMR_MAX_RATE_SAMPLES];
+    uint8_t g711[OPENDMR_PCM_SAMPLES];
+    size_t samples = opendmr_rate_samples(rate);
     int frames = 0;
     int total_errors = 0;
 
     while (fread(ambe, 1, OPENDMR_AMBE_FRAME_BYTES, fin) == OPENDMR_AMBE_FRAME_BYTES) {
-        int errs = 0;
-        if (opendmr_decode(dec, ambe, pcm, &errs)) {
-            fwrite(pcm, sizeof(int16_t), OPENDMR_PCM_SAMPLES, fout);
+        opendmr_frame_info_t info;
+        if (law >= 0 && opendmr_decode_g711(dec, ambe, g711, (opendmr_g711_law_t)law, &info)) {
+            fwrite(g711, 1, OPENDMR_PCM_SAMPLES, fout);
             frames++;
-            total_errors += errs;
+            total_errors += info.errs;
+        } else if (law < 0 && opendmr_decode_rate(dec, ambe, pcm, rate, &info)) {
+            fwrite(pcm, sizeof(int16_t), samples, fout);
+            frames++;
+            total_errors += info.errs;
         } else {
             fprintf(stderr, "Warning: Decode failed for frame %d\n", frames);
         }
@@ -94,7 +156,7 @@ static int do_decode(const char *in_file, const char *out_file)
     return 0;
 }
 
-static int do_encode(const char *in_file, const char *out_file)
+static int do_encode(const char *in_file, const char *out_file, unsigned int rate, int law)
 {
     FILE *fin = fopen(in_file, "rb");
     if (!fin) {
@@ -117,12 +179,25 @@ static int do_encode(const char *in_file, const char *out_file)
         return 1;
     }
 
-    int16_t pcm[OPENDMR_PCM_SAMPLES];
+    int16_t pcm[OPENDMR_MAX_RATE_SAMPLES];
+    uint8_t g711[OPENDMR_PCM_SAMPLES];
+    size_t samples = opendmr_rate_samples(rate);
     uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES];
     int frames = 0;
 
-    while (fread(pcm, sizeof(int16_t), OPENDMR_PCM_SAMPLES, fin) == OPENDMR_PCM_SAMPLES) {
-        if (opendmr_encode(enc, pcm, ambe)) {
+    for (;;) {
+        bool ok;
+        if (law >= 0) {
+            if (fread(g711, 1, OPENDMR_PCM_SAMPLES, fin) != OPENDMR_PCM_SAMPLES)
+                break;
+            ok = opendmr_encode_g711(enc, g711, (opendmr_g711_law_t)law, ambe);
+        } else {
+            if (fread(pcm, sizeof(int16_t), samples, fin) != samples)
+                break;
+            ok = opendmr_encode_rate(enc, pcm, rate, ambe);
+        }
+
+        if (ok) {
             fwrite(ambe, 1, OPENDMR_AMBE_FRAME_BYTES, fout);
             frames++;
         } else {
@@ -191,6 +266,979 @@ static int do_transcode(const char *in_file, const char *out_file)
     return 0;
 }
 
+static int do_regenerate(const char *in_file, const char *out_file)
+{
+    FILE *fin = fopen(in_file, "rb");
+    if (!fin) {
+        fprintf(stderr, "Error: Cannot open input file '%s'\n", in_file);
+        return 1;
+    }
+
+    FILE *fout = fopen(out_file, "wb");
+    if (!fout) {
+        fprintf(stderr, "Error: Cannot open output file '%s'\n", out_file);
+        fclose(fin);
+        return 1;
+    }
+
+    uint8_t ambe_in[OPENDMR_AMBE_FRAME_BYTES];
+    uint8_t ambe_out[OPENDMR_AMBE_FRAME_BYTES];
+    int frames = 0;
+    int total_errors = 0;
+    int uncorrectable = 0;
+
+    while (fread(ambe_in, 1, OPENDMR_AMBE_FRAME_BYTES, fin) == OPENDMR_AMBE_FRAME_BYTES) {
+        int errs = 0;
+        if (opendmr_regenerate(ambe_in, ambe_out, &errs))
+            total_errors += errs;
+        else
+            uncorrectable++;
+        fwrite(ambe_out, 1, OPENDMR_AMBE_FRAME_BYTES, fout);
+        frames++;
+    }
+
+    fclose(fin);
+    fclose(fout);
+
+    printf("Regenerated %d frames (%.2f seconds)\n", frames, frames * 0.02f);
+    printf("Total bit errors corrected: %d\n", total_errors);
+    printf("Uncorrectable frames: %d\n", uncorrectable);
+
+    return 0;
+}
+
+/* Parameter-domain AMBE+2 <-> IMBE conversion, no PCM in between */
+static int do_stereo(const char *ts1_file, const char *ts2_file, const char *out_file)
+{
+    FILE *fin[OPENDMR_SLOTS] = { fopen(ts1_file, "rb"), fopen(ts2_file, "rb") };
+    if (!fin[0] || !fin[1]) {
+        fprintf(stderr, "Error: Cannot open input file '%s'\n", fin[0] ? ts2_file : ts1_file);
+        if (fin[0])
+            fclose(fin[0]);
+        if (fin[1])
+            fclose(fin[1]);
+        return 1;
+    }
+
+    FILE *fout = fopen(out_file, "wb");
+    if (!fout) {
+        fprintf(stderr, "Error: Cannot open output file '%s'\n", out_file);
+        fclose(fin[0]);
+        fclose(fin[1]);
+        return 1;
+    }
+
+    opendmr_dual_decoder_t *dd = opendmr_dual_decoder_create();
+    if (!dd) {
+        fprintf(stderr, "Error: Cannot create dual decoder\n");
+        fclose(fin[0]);
+        fclose(fin[1]);
+        fclose(fout);
+        return 1;
+    }
+
+    uint8_t ambe[OPENDMR_SLOTS][OPENDMR_AMBE_FRAME_BYTES];
+    int16_t pcm[OPENDMR_PCM_SAMPLES * OPENDMR_SLOTS];
+    opendmr_frame_info_t info[OPENDMR_SLOTS];
+    int frames[OPENDMR_SLOTS] = { 0, 0 };
+    int errors[OPENDMR_SLOTS] = { 0, 0 };
+    int periods = 0;
+
+    /* Run until both slots end; the shorter one is padded with silence */
+    for (;;) {
+        const uint8_t *in[OPENDMR_SLOTS];
+        for (int k = 0; k < OPENDMR_SLOTS; k++) {
+            bool got = fread(ambe[k], 1, OPENDMR_AMBE_FRAME_BYTES, fin[k]) == OPENDMR_AMBE_FRAME_BYTES;
+            in[k] = got ? ambe[k] : NULL;
+        }
+        if (!in[0] && !in[1])
+            break;
+
+        if (!opendmr_dual_decode_pair(dd, in, pcm, OPENDMR_SLOTS, info)) {
+            fprintf(stderr, "Error: Decode failed at frame %d\n", periods);
+            break;
+        }
+        for (int k = 0; k < OPENDMR_SLOTS; k++) {
+            if (in[k]) {
+                frames[k]++;
+                errors[k] += info[k].errs;
+            }
+        }
+        fwrite(pcm, sizeof(int16_t), OPENDMR_PCM_SAMPLES * OPENDMR_SLOTS, fout);
+        periods++;
+    }
+
+    opendmr_dual_decoder_destroy(dd);
+    fclose(fin[0]);
+    fclose(fin[1]);
+    fclose(fout);
+
+    printf("Decoded %d stereo frames (%.2f seconds)\n", periods, periods * 0.02f);
+    for (int k = 0; k < OPENDMR_SLOTS; k++)
+        printf("TS%d: %d frames, %d bit errors corrected\n", k + 1, frames[k], errors[k]);
+
+    return 0;
+}
+
+static int do_imbe(const char *in_file, const char *out_file, bool to_imbe)
+{
+    FILE *fin = fopen(in_file, "rb");
+    if (!fin) {
+        fprintf(stderr, "Error: Cannot open input file '%s'\n", in_file);
+        return 1;
+    }
+
+    FILE *fout = fopen(out_file, "wb");
+    if (!fout) {
+        fprintf(stderr, "Error: Cannot open output file '%s'\n", out_file);
+        fclose(fin);
+        return 1;
+    }
+
+    opendmr_transcoder_t *tc = opendmr_transcoder_create();
+    if (!tc) {
+        fprintf(stderr, "Error: Failed to create transcoder\n");
+        fclose(fin);
+        fclose(fout);
+        return 1;
+    }
+
+    uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES];
+    uint8_t imbe[OPENDMR_IMBE_FRAME_BYTES];
+    int frames = 0;
+    int bad = 0;
+
+    if (to_imbe) {
+        while (fread(ambe, 1, sizeof(ambe), fin) == sizeof(ambe)) {
+            opendmr_ambe_to_imbe(tc, ambe, imbe, NULL);
+            fwrite(imbe, 1, sizeof(imbe), fout);
+            frames++;
+        }
+    } else {
+        while (fread(imbe, 1, sizeof(imbe), fin) == sizeof(imbe)) {
+            if (!opendmr_imbe_to_ambe(tc, imbe, ambe))
+                bad++;
+            fwrite(ambe, 1, sizeof(ambe), fout);
+            frames++;
+        }
+    }
+
+    opendmr_transcoder_destroy(tc);
+    fclose(fin);
+    fclose(fout);
+
+    printf("Transcoded %d frames (%.2f seconds)\n", frames, frames * 0.02f);
+    if (!to_imbe)
+        printf("Invalid IMBE frames: %d\n", bad);
+
+    return 0;
+}
+
+/* Round-trip test tones: 1 s each, amplitude of the fundamental */
+#define ROUNDTRIP_FRAMES    50
+#define ROUNDTRIP_SETTLE    5
+#define ROUNDTRIP_AMPLITUDE 3000.0
+
+/* The analysis may take a perfectly periodic tone at up to 1/3 its pitch */
+#define ROUNDTRIP_SUBMULTIPLE 3
+
+/*
+ * Encode harmonic tones of known pitch and decode the frames' parameters:
+ * every settled frame must decode without bit errors as a voiced frame
+ * whose fundamental is within 5% of the tone's, or of a sub-multiple of
+ * it. A mismatch between the
+ * encoder's bit layout and the decoder's shows up as wrong pitch, voicing
+ * or FEC errors.
+ */
+static int do_roundtrip(void)
+{
+    static const double f0s[] = { 100, 125, 150, 200, 250, 300 };
+    int failed = 0;
+
+    printf("Tone     Frames  Errors  Voiced  Pitch matched\n");
+    for (size_t t = 0; t < sizeof(f0s) / sizeof(f0s[0]); t++) {
+        opendmr_encoder_t *enc = opendmr_encoder_create();
+        opendmr_decoder_t *dec = opendmr_decoder_create();
+        if (!enc || !dec) {
+            fprintf(stderr, "Error: Failed to create codec\n");
+            opendmr_encoder_destroy(enc);
+            opendmr_decoder_destroy(dec);
+            return 1;
+        }
+
+        int frames = 0, errors = 0, voiced = 0, in_tune = 0;
+        double phase = 0.0;
+        for (int f = 0; f < ROUNDTRIP_FRAMES; f++) {
+            int16_t pcm[OPENDMR_PCM_SAMPLES];
+            for (int i = 0; i < OPENDMR_PCM_SAMPLES; i++) {
+                double x = 0.0;
+                for (int k = 1; k * f0s[t] < 3600.0; k++)
+                    x += sin(k * phase) / k;
+                pcm[i] = (int16_t)(ROUNDTRIP_AMPLITUDE * x);
+                phase += 2.0 * M_PI * f0s[t] / OPENDMR_SAMPLE_RATE;
+            }
+
+            uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES];
+            opendmr_params_t params;
+            opendmr_encode(enc, pcm, ambe);
+            if (!opendmr_decode_params(dec, ambe, &params) || f < ROUNDTRIP_SETTLE)
+                continue;
+
+            double f0 = params.w0 * OPENDMR_SAMPLE_RATE / (2.0 * M_PI);
+            frames++;
+            errors += params.errs;
+            if (params.frame_class == OPENDMR_FRAME_VOICE && params.vuv) {
+                /* A sub-multiple has the tone's harmonics among its own */
+                double k = floor(f0s[t] / f0 + 0.5);
+                voiced++;
+                in_tune += k >= 1 && k <= ROUNDTRIP_SUBMULTIPLE &&
+                           fabs(k * f0 / f0s[t] - 1.0) < 0.05;
+            }
+        }
+        opendmr_encoder_destroy(enc);
+        opendmr_decoder_destroy(dec);
+
+        bool ok = errors == 0 && voiced == frames && in_tune == frames;
+        failed += !ok;
+        printf("%3.0f Hz   %6d  %6d  %6d  %6d  %s\n", f0s[t], frames, errors,
+               voiced, in_tune, ok ? "ok" : "FAIL");
+    }
+
+    printf("%s\n", failed ? "Round trip FAILED" : "Round trip passed");
+    return failed ? 1 : 0;
+}
+
+/* Read a whole AMBE+2 file into memory (at least one frame) */
+static uint8_t *load_frames(const char *in_file, size_t *count)
+{
+    FILE *fin = fopen(in_file, "rb");
+    if (!fin) {
+        fprintf(stderr, "Error: Cannot open input file '%s'\n", in_file);
+        return NULL;
+    }
+
+    fseek(fin, 0, SEEK_END);
+    long size = ftell(fin);
+    fseek(fin, 0, SEEK_SET);
+    *count = size > 0 ? (size_t)size / OPENDMR_AMBE_FRAME_BYTES : 0;
+    uint8_t *frames = (uint8_t *)malloc(*count * OPENDMR_AMBE_FRAME_BYTES + 1);
+    if (*count == 0 || !frames ||
+        fread(frames, OPENDMR_AMBE_FRAME_BYTES, *count, fin) != *count) {
+        fprintf(stderr, "Error: Cannot read frames from '%s'\n", in_file);
+        free(frames);
+        frames = NULL;
+    }
+    fclose(fin);
+    return frames;
+}
+
+/* Read a whole 8 kHz PCM file into memory (whole frames, at least one) */
+static int16_t *load_pcm(const char *in_file, size_t *frames)
+{
+    FILE *fin = fopen(in_file, "rb");
+    if (!fin) {
+        fprintf(stderr, "Error: Cannot open input file '%s'\n", in_file);
+        return NULL;
+    }
+
+    fseek(fin, 0, SEEK_END);
+    long size = ftell(fin);
+    fseek(fin, 0, SEEK_SET);
+    *frames = size > 0 ? (size_t)size / (OPENDMR_PCM_SAMPLES * sizeof(int16_t)) : 0;
+    int16_t *pcm = (int16_t *)malloc(*frames * OPENDMR_PCM_SAMPLES * sizeof(int16_t) + 1);
+    if (*frames == 0 || !pcm ||
+        fread(pcm, OPENDMR_PCM_SAMPLES * sizeof(int16_t), *frames, fin) != *frames) {
+        fprintf(stderr, "Error: Cannot read PCM from '%s'\n", in_file);
+        free(pcm);
+        pcm = NULL;
+    }
+    fclose(fin);
+    return pcm;
+}
+
+/* Sub-tick for the schedule command: spreads stream phases over the frame */
+#define SCHEDULE_TICK_US    5000
+
+struct schedule_stream {
+    opendmr_decoder_t *dec;
+    const uint8_t *frames;
+    size_t count;
+    size_t pos;
+};
+
+static void schedule_batch(void *ctx, void *const *streams, size_t count)
+{
+    (void)ctx;
+    int16_t pcm[OPENDMR_PCM_SAMPLES];
+    for (size_t i = 0; i < count; i++) {
+        schedule_stream *s = (schedule_stream *)streams[i];
+        opendmr_decode(s->dec, s->frames + s->pos * OPENDMR_AMBE_FRAME_BYTES, pcm, NULL);
+        s->pos = (s->pos + 1) % s->count;
+    }
+}
+
+static int do_schedule(const char *in_file, int num_streams, int seconds)
+{
+    /* Every stream loops over the same input, each at its own position */
+    size_t count;
+    uint8_t *frames = load_frames(in_file, &count);
+    if (!frames)
+        return 1;
+
+    schedule_stream *streams = (schedule_stream *)calloc((size_t)num_streams, sizeof(schedule_stream));
+    opendmr_clock_t *clk = opendmr_clock_create(SCHEDULE_TICK_US, (size_t)num_streams,
+                                                schedule_batch, NULL);
+    if (!streams || !clk) {
+        fprintf(stderr, "Error: Failed to create scheduler\n");
+        free(streams);
+        free(frames);
+        return 1;
+    }
+
+    int rc = 0;
+    for (int i = 0; i < num_streams; i++) {
+        schedule_stream *s = &streams[i];
+        s->dec = opendmr_decoder_create();
+        s->frames = frames;
+        s->count = count;
+        s->pos = (size_t)i % count;
+        if (!s->dec) {
+            fprintf(stderr, "Error: Failed to create decoder\n");
+            rc = 1;
+            break;
+        }
+        opendmr_clock_add(clk, s, (unsigned int)((long)i * OPENDMR_FRAME_US / num_streams));
+    }
+
+    if (rc == 0) {
+        /* Count missed ticks too, so an overloaded run still ends on time */
+        unsigned long ticks = (unsigned long)seconds * (1000000 / SCHEDULE_TICK_US);
+        opendmr_clock_stats_t st;
+        do {
+            opendmr_clock_tick(clk);
+            opendmr_clock_get_stats(clk, &st);
+        } while (st.ticks + st.missed_ticks < ticks);
+
+        double wall = (st.ticks + st.missed_ticks) * (SCHEDULE_TICK_US / 1e6);
+        printf("Streams: %d, tick %d us, %.1f s\n", num_streams, SCHEDULE_TICK_US, wall);
+        printf("Frames dispatched: %lu (%.0f/s), largest batch %u\n",
+               st.frames, st.frames / wall, st.max_batch);
+        printf("Late frames: %lu (worst %.1f ms past deadline), skipped %lu\n",
+               st.late_frames, st.max_late_us / 1000.0, st.skipped);
+        printf("Missed ticks: %lu\n", st.missed_ticks);
+        printf("Decode load: %.1f%% of real time\n", 100.0 * st.busy_us / (wall * 1e6));
+    }
+
+    for (int i = 0; i < num_streams; i++)
+        opendmr_decoder_destroy(streams[i].dec);
+    opendmr_clock_destroy(clk);
+    free(streams);
+    free(frames);
+    return rc;
+}
+
+static double now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/*
+ * Conference of <legs> participants, the first <talkers> of which talk
+ * (each looping the input from its own position). Every leg is decoded,
+ * mixed N-minus-one and re-encoded; the last leg, which only listens
+ * unless every leg talks, is written to the output.
+ */
+static int do_conference(const char *in_file, const char *out_file, int legs, int talkers)
+{
+    size_t count;
+    uint8_t *frames = load_frames(in_file, &count);
+    if (!frames)
+        return 1;
+
+    FILE *fout = fopen(out_file, "wb");
+    if (!fout) {
+        fprintf(stderr, "Error: Cannot create output file '%s'\n", out_file);
+        free(frames);
+        return 1;
+    }
+
+    size_t n = (size_t)legs;
+    opendmr_mixer_t *mix = opendmr_mixer_create(n);
+    opendmr_decoder_t **dec = (opendmr_decoder_t **)calloc(n, sizeof(*dec));
+    opendmr_encoder_t **enc = (opendmr_encoder_t **)calloc(n, sizeof(*enc));
+    float *pcm_in = (float *)malloc(n * OPENDMR_PCM_SAMPLES * sizeof(float));
+    float *pcm_out = (float *)malloc(n * OPENDMR_PCM_SAMPLES * sizeof(float));
+    const float **in = (const float **)calloc(n, sizeof(*in));
+    float **out = (float **)calloc(n, sizeof(*out));
+    opendmr_frame_info_t *info = (opendmr_frame_info_t *)calloc(n, sizeof(*info));
+
+    int rc = 0;
+    if (!mix || !dec || !enc || !pcm_in || !pcm_out || !in || !out || !info)
+        rc = 1;
+    for (size_t i = 0; rc == 0 && i < n; i++) {
+        dec[i] = opendmr_decoder_create();
+        enc[i] = opendmr_encoder_create();
+        out[i] = pcm_out + i * OPENDMR_PCM_SAMPLES;
+        if (!dec[i] || !enc[i])
+            rc = 1;
+    }
+    if (rc != 0)
+        fprintf(stderr, "Error: Failed to create conference\n");
+
+    double t_decode = 0, t_mix = 0, t_encode = 0;
+    size_t mixed = 0;
+    for (size_t f = 0; rc == 0 && f < count; f++) {
+        double t0 = now_us();
+        for (size_t i = 0; i < n; i++) {
+            in[i] = NULL;
+            if (i < (size_t)talkers) {
+                float *pcm = pcm_in + i * OPENDMR_PCM_SAMPLES;
+                size_t pos = (f + i * count / n) % count;
+                opendmr_decode_f32_ex(dec[i], frames + pos * OPENDMR_AMBE_FRAME_BYTES, pcm, &info[i]);
+                in[i] = pcm;
+            }
+        }
+        double t1 = now_us();
+        mixed += opendmr_mixer_mix(mix, in, info, out, n);
+        double t2 = now_us();
+
+        uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES];
+        for (size_t i = 0; i < n; i++) {
+            opendmr_encode_f32(enc[i], out[i], ambe);
+            if (i == n - 1)
+                fwrite(ambe, 1, sizeof(ambe), fout);
+        }
+        double t3 = now_us();
+
+        t_decode += t1 - t0;
+        t_mix += t2 - t1;
+        t_encode += t3 - t2;
+    }
+
+    if (rc == 0) {
+        printf("Conference: %d legs, %d talking, %zu frames\n", legs, talkers, count);
+        printf("Active talkers mixed: %.2f per frame\n", (double)mixed / count);
+        printf("Per frame: decode %.1f us, mix %.1f us, encode %.1f us\n",
+               t_decode / count, t_mix / count, t_encode / count);
+    }
+
+    for (size_t i = 0; dec && enc && i < n; i++) {
+        opendmr_decoder_destroy(dec[i]);
+        opendmr_encoder_destroy(enc[i]);
+    }
+    opendmr_mixer_destroy(mix);
+    free(dec);
+    free(enc);
+    free(pcm_in);
+    free(pcm_out);
+    free(in);
+    free(out);
+    free(info);
+    free(frames);
+    fclose(fout);
+    return rc;
+}
+
+/* Jitter buffer depth limit for the jitter command (500 ms) */
+#define JITTER_MAX_FRAMES   25
+
+struct jitter_packet {
+    uint64_t arrival_us;
+    uint16_t seq;
+};
+
+static int compare_arrival(const void *a, const void *b)
+{
+    const jitter_packet *pa = (const jitter_packet *)a;
+    const jitter_packet *pb = (const jitter_packet *)b;
+    if (pa->arrival_us != pb->arrival_us)
+        return pa->arrival_us < pb->arrival_us ? -1 : 1;
+    return (int)pa->seq - (int)pb->seq;
+}
+
+/*
+ * Send the input one frame every 20 ms over a simulated network that
+ * delays each packet by a uniform 0..<jitter_ms> and loses <loss_pct>
+ * percent of them, and play it out through the jitter buffer.
+ */
+static int do_jitter(const char *in_file, const char *out_file, int jitter_ms, int loss_pct)
+{
+    size_t count;
+    uint8_t *frames = load_frames(in_file, &count);
+    if (!frames)
+        return 1;
+
+    FILE *fout = fopen(out_file, "wb");
+    if (!fout) {
+        fprintf(stderr, "Error: Cannot create output file '%s'\n", out_file);
+        free(frames);
+        return 1;
+    }
+
+    jitter_packet *packets = (jitter_packet *)malloc(count * sizeof(jitter_packet));
+    opendmr_jitterbuf_t *jb = opendmr_jitterbuf_create(JITTER_MAX_FRAMES);
+    opendmr_decoder_t *dec = opendmr_decoder_create();
+    if (!packets || !jb || !dec) {
+        fprintf(stderr, "Error: Failed to create jitter buffer\n");
+        free(packets);
+        opendmr_jitterbuf_destroy(jb);
+        opendmr_decoder_destroy(dec);
+        free(frames);
+        fclose(fout);
+        return 1;
+    }
+
+    /* Fixed seed so runs are repeatable */
+    srand(1);
+    size_t sent = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (rand() % 100 < loss_pct)
+            continue;
+        uint64_t delay = (uint64_t)rand() % ((uint64_t)jitter_ms * 1000 + 1);
+        packets[sent].arrival_us = i * OPENDMR_FRAME_US + delay;
+        packets[sent].seq = (uint16_t)i;
+        sent++;
+    }
+    qsort(packets, sent, sizeof(jitter_packet), compare_arrival);
+
+    /* Play out every 20 ms until everything has arrived and the buffer drains */
+    int16_t pcm[OPENDMR_PCM_SAMPLES];
+    size_t next = 0, ticks = 0;
+    bool played = false;
+    for (uint64_t now = 0;; now += OPENDMR_FRAME_US) {
+        for (; next < sent && packets[next].arrival_us <= now; next++) {
+            uint16_t seq = packets[next].seq;
+            opendmr_jitterbuf_put(jb, seq, packets[next].arrival_us,
+                                  frames + seq * OPENDMR_AMBE_FRAME_BYTES);
+        }
+
+        opendmr_jb_result_t r = opendmr_jitterbuf_decode(jb, dec, now, pcm, NULL);
+        if (r == OPENDMR_JB_IDLE && played && next == sent)
+            break;
+        played |= r != OPENDMR_JB_IDLE;
+        fwrite(pcm, sizeof(int16_t), OPENDMR_PCM_SAMPLES, fout);
+        ticks++;
+    }
+
+    opendmr_jitterbuf_stats_t st;
+    opendmr_jitterbuf_get_stats(jb, &st);
+    printf("Frames: %zu sent, %zu delivered, %d ms jitter, %d%% loss\n",
+           count, sent, jitter_ms, loss_pct);
+    printf("Played: %lu, concealed %lu (stretched %lu), dropped %lu\n",
+           st.frames, st.lost, st.stretched, st.dropped);
+    printf("Rejected: %lu late, %lu duplicate, %lu overflow\n",
+           st.late, st.duplicates, st.overflows);
+    printf("Jitter estimate: %.1f ms, target delay %u frames\n",
+           st.jitter_us / 1000.0, st.target_frames);
+    printf("Mean buffering delay: %.1f ms\n",
+           st.frames ? st.wait_us / 1000.0 / st.frames : 0.0);
+    printf("Output: %zu frames (%.1f s)\n", ticks, ticks * OPENDMR_FRAME_US / 1e6);
+
+    opendmr_jitterbuf_destroy(jb);
+    opendmr_decoder_destroy(dec);
+    free(packets);
+    free(frames);
+    fclose(fout);
+    return 0;
+}
+
+/* Envelope block (1 ms) and largest delay searched to align output with input */
+#define ENVELOPE_BLOCK      8
+#define LATENCY_MAX_MS      150
+
+/* Sum of magnitudes over each envelope block */
+static void envelope(const int16_t *x, size_t blocks, float *env)
+{
+    for (size_t k = 0; k < blocks; k++) {
+        env[k] = 0.0f;
+        for (int i = 0; i < ENVELOPE_BLOCK; i++)
+            env[k] += fabsf((float)x[k * ENVELOPE_BLOCK + i]);
+    }
+}
+
+/* Lag (in envelope blocks) of b behind a with the largest correlation */
+static int envelope_lag(const float *a, const float *b, size_t n, int max_lag)
+{
+    int best = 0;
+    double best_corr = -1.0;
+    for (int lag = 0; lag <= max_lag && (size_t)lag < n; lag++) {
+        double ab = 0, aa = 0, bb = 0;
+        for (size_t i = 0; i + lag < n; i++) {
+            ab += a[i] * b[i + lag];
+            aa += a[i] * a[i];
+            bb += b[i + lag] * b[i + lag];
+        }
+        double corr = aa > 0 && bb > 0 ? ab / sqrt(aa * bb) : 0.0;
+        if (corr > best_corr) {
+            best_corr = corr;
+            best = lag;
+        }
+    }
+    return best;
+}
+
+/*
+ * Encode and decode frames of in with one latency profile and complexity
+ * level. Writes the decoded speech to out and each frame's decoded pitch
+ * to w0 (0 for frames that are not voiced), and returns the total encode
+ * time and the encoder delay. w0 may be NULL. Returns false if the codec
+ * cannot be set up.
+ */
+static bool run_codec(const int16_t *in, size_t frames, opendmr_latency_t latency,
+                      opendmr_complexity_t complexity, int16_t *out, float *w0,
+                      double *t_encode, unsigned int *delay)
+{
+    opendmr_encoder_t *enc = opendmr_encoder_create();
+    opendmr_decoder_t *dec = opendmr_decoder_create();
+    opendmr_decoder_t *pdec = opendmr_decoder_create();
+    bool ok = enc && dec && pdec && opendmr_encoder_set_latency(enc, latency) &&
+              opendmr_encoder_set_complexity(enc, complexity);
+    if (!ok) {
+        fprintf(stderr, "Error: Failed to create codec\n");
+    } else {
+        *t_encode = 0;
+        for (size_t f = 0; f < frames; f++) {
+            uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES];
+            opendmr_params_t params;
+            double t0 = now_us();
+            opendmr_encode(enc, in + f * OPENDMR_PCM_SAMPLES, ambe);
+            *t_encode += now_us() - t0;
+            opendmr_decode(dec, ambe, out + f * OPENDMR_PCM_SAMPLES, NULL);
+            if (w0)
+                w0[f] = opendmr_decode_params(pdec, ambe, &params) &&
+                        params.frame_class == OPENDMR_FRAME_VOICE && params.vuv ? params.w0 : 0.0f;
+        }
+        *delay = opendmr_encoder_delay(enc);
+    }
+    opendmr_encoder_destroy(enc);
+    opendmr_decoder_destroy(dec);
+    opendmr_decoder_destroy(pdec);
+    return ok;
+}
+
+/* Percentage of frames voiced in both ref and got whose pitch agrees within 5% */
+static double pitch_agreement(const float *ref, const float *got, size_t frames)
+{
+    size_t voiced = 0, agree = 0;
+    for (size_t f = 0; f < frames; f++) {
+        if (ref[f] > 0 && got[f] > 0) {
+            voiced++;
+            agree += fabsf(got[f] / ref[f] - 1.0f) < 0.05f;
+        }
+    }
+    return voiced ? 100.0 * agree / voiced : 100.0;
+}
+
+/*
+ * Test signal of the latency command: harmonic tone bursts at 150 Hz with
+ * sharp onsets. The onset period is 20 samples (2.5 ms) longer than a
+ * whole number of frames, so successive onsets step through the 8 phases
+ * of the 20 ms frame grid.
+ */
+#define PROBE_LEAD          800     /* Silence before the first burst */
+#define PROBE_PERIOD        4020    /* Onset to onset */
+#define PROBE_LENGTH        1600    /* Burst length (200 ms) */
+#define PROBE_BURSTS        24
+#define PROBE_F0            150.0
+#define PROBE_AMPLITUDE     4000.0
+
+/* Onsets are timed where the 5 ms mean magnitude first reaches half the
+ * burst's steady level, measured over samples 600-1400 of the burst */
+#define ONSET_WINDOW        40
+#define STEADY_START        600
+#define STEADY_END          1400
+
+static void latency_probe(int16_t *x, size_t samples)
+{
+    memset(x, 0, samples * sizeof(int16_t));
+    for (int b = 0; b < PROBE_BURSTS; b++) {
+        int16_t *burst = x + PROBE_LEAD + b * PROBE_PERIOD;
+        for (int n = 0; n < PROBE_LENGTH; n++) {
+            double v = 0;
+            for (int k = 1; k * PROBE_F0 < 3600.0; k++)
+                v += sin(2.0 * M_PI * PROBE_F0 * k * n / OPENDMR_SAMPLE_RATE) / k;
+            burst[n] = (int16_t)(PROBE_AMPLITUDE * v);
+        }
+    }
+}
+
+/* Sample at which the burst starting near x[start] reaches half its level */
+static long burst_onset(const int16_t *x, size_t start)
+{
+    double level = 0;
+    for (size_t n = start + STEADY_START; n < start + STEADY_END; n++)
+        level += abs(x[n]);
+    level /= STEADY_END - STEADY_START;
+
+    double sum = 0;
+    for (size_t n = start - PROBE_LEAD / 2; n < start + STEADY_START; n++) {
+        sum += abs(x[n]);
+        if (n >= start - PROBE_LEAD / 2 + ONSET_WINDOW)
+            sum -= abs(x[n - ONSET_WINDOW]);
+        if (sum >= 0.5 * level * ONSET_WINDOW)
+            return (long)n;
+    }
+    return -1;
+}
+
+/*
+ * Encode and decode with each encoder latency profile. The end-to-end
+ * delay is timed on tone burst onsets (latency_probe()). A single onset
+ * is only placed to within the 20 ms frame it falls in, so the mean over
+ * onsets at every phase of the frame is reported with their range. Pitch
+ * agreement compares each profile's decoded pitch for the input with the
+ * default profile's for the same (delay-aligned) frame.
+ */
+static int do_latency(const char *in_file)
+{
+    size_t frames;
+    int16_t *in = load_pcm(in_file, &frames);
+    if (!in)
+        return 1;
+
+    size_t probe_frames = (PROBE_LEAD + PROBE_BURSTS * PROBE_PERIOD) / OPENDMR_PCM_SAMPLES + 1;
+    size_t probe_samples = probe_frames * OPENDMR_PCM_SAMPLES;
+    int16_t *probe = (int16_t *)malloc(probe_samples * sizeof(int16_t));
+    int16_t *probe_out = (int16_t *)malloc(probe_samples * sizeof(int16_t));
+    int16_t *out = (int16_t *)malloc(frames * OPENDMR_PCM_SAMPLES * sizeof(int16_t));
+    float *w0 = (float *)calloc(3 * frames, sizeof(float));
+    int rc = 0;
+    if (!probe || !probe_out || !out || !w0) {
+        fprintf(stderr, "Error: Out of memory\n");
+        rc = 1;
+    } else {
+        latency_probe(probe, probe_samples);
+        printf("Profile  Encoder delay  End-to-end (range)      Encode/frame  Pitch agreement\n");
+    }
+
+    static const char *const names[] = { "normal", "low", "min" };
+    for (int p = OPENDMR_LATENCY_NORMAL; rc == 0 && p <= OPENDMR_LATENCY_MIN; p++) {
+        double t_encode;
+        unsigned int delay;
+        if (!run_codec(probe, probe_frames, (opendmr_latency_t)p, OPENDMR_COMPLEXITY_HIGH,
+                       probe_out, NULL, &t_encode, &delay) ||
+            !run_codec(in, frames, (opendmr_latency_t)p, OPENDMR_COMPLEXITY_HIGH,
+                       out, w0 + p * frames, &t_encode, &delay)) {
+            rc = 1;
+            break;
+        }
+
+        double sum = 0, lo = 1e9, hi = -1e9;
+        int timed = 0;
+        for (int b = 0; b < PROBE_BURSTS; b++) {
+            size_t start = PROBE_LEAD + b * PROBE_PERIOD;
+            long t_in = burst_onset(probe, start), t_out = burst_onset(probe_out, start);
+            if (t_in < 0 || t_out < 0)
+                continue;
+            double ms = (t_out - t_in) * 1000.0 / OPENDMR_SAMPLE_RATE;
+            sum += ms;
+            lo = ms < lo ? ms : lo;
+            hi = ms > hi ? ms : hi;
+            timed++;
+        }
+        if (timed == 0)
+            sum = lo = hi = 0;
+        else
+            sum /= timed;
+
+        /* Frames of the default profile describe the speech p frames later */
+        printf("%-7s  %6.2f ms      %5.1f ms (%4.1f-%4.1f)  %6.1f us     %5.1f%%\n", names[p],
+               delay * 1000.0 / OPENDMR_SAMPLE_RATE, sum, lo, hi,
+               t_encode / frames, pitch_agreement(w0 + p, w0 + p * frames, frames - p));
+    }
+
+    free(in);
+    free(probe);
+    free(probe_out);
+    free(out);
+    free(w0);
+    return rc;
+}
+
+/* Analysis frame of the complexity command's spectral distance */
+#define SPECTRUM_SIZE       256
+#define SPECTRUM_BINS       (SPECTRUM_SIZE / 2 + 1)
+
+/* Bins compared (125-3400 Hz) */
+#define SPECTRUM_LO         4
+#define SPECTRUM_HI         108
+#define SPECTRUM_BAND       (SPECTRUM_HI - SPECTRUM_LO + 1)
+
+/* Input frames below this level are left out of the spectral distance */
+#define ACTIVE_DBFS         -40.0
+
+/* Hann-windowed power spectrum of SPECTRUM_SIZE samples, in dB */
+static void log_spectrum(const int16_t *x, double db[SPECTRUM_BINS])
+{
+    static double win[SPECTRUM_SIZE], cs[SPECTRUM_SIZE], sn[SPECTRUM_SIZE];
+    if (win[SPECTRUM_SIZE / 2] == 0.0) {
+        for (int n = 0; n < SPECTRUM_SIZE; n++) {
+            win[n] = 0.5 - 0.5 * cos(2.0 * M_PI * n / SPECTRUM_SIZE);
+            cs[n] = cos(2.0 * M_PI * n / SPECTRUM_SIZE);
+            sn[n] = sin(2.0 * M_PI * n / SPECTRUM_SIZE);
+        }
+    }
+
+    for (int k = 0; k < SPECTRUM_BINS; k++) {
+        double re = 0, im = 0;
+        for (int n = 0; n < SPECTRUM_SIZE; n++) {
+            double v = x[n] * win[n];
+            re += v * cs[(n * k) % SPECTRUM_SIZE];
+            im -= v * sn[(n * k) % SPECTRUM_SIZE];
+        }
+        db[k] = 10.0 * log10(re * re + im * im + 1.0);
+    }
+}
+
+/*
+ * Encode and decode the input at each encoder complexity level. Quality
+ * is scored as the log-spectral distance between the speech frames of
+ * the input and the delay-aligned output (ignoring the overall level,
+ * which the codec does not preserve exactly), and as the pitch agreement
+ * with the highest level frame by frame; cost is the encode time. The
+ * spectral distance moves by a fraction of a dB between levels and does
+ * not rank them; the pitch agreement does.
+ */
+static int do_complexity(const char *in_file)
+{
+    size_t frames;
+    int16_t *in = load_pcm(in_file, &frames);
+    if (!in)
+        return 1;
+    size_t samples = frames * OPENDMR_PCM_SAMPLES;
+    size_t blocks = samples / ENVELOPE_BLOCK;
+
+    int16_t *out = (int16_t *)malloc(samples * sizeof(int16_t));
+    float *env_in = (float *)malloc(blocks * sizeof(float) + 1);
+    float *env_out = (float *)malloc(blocks * sizeof(float) + 1);
+    float *w0 = (float *)calloc(3 * frames, sizeof(float));
+    int rc = 0;
+    if (!out || !env_in || !env_out || !w0) {
+        fprintf(stderr, "Error: Out of memory\n");
+        rc = 1;
+    } else {
+        envelope(in, blocks, env_in);
+        printf("Level    Encode/frame  Cost   Spectral distance  Pitch agreement\n");
+    }
+
+    static const char *const names[] = { "high", "medium", "low" };
+    double t_high = 0;
+    for (int c = OPENDMR_COMPLEXITY_HIGH; rc == 0 && c <= OPENDMR_COMPLEXITY_LOW; c++) {
+        double t_encode;
+        unsigned int delay;
+        if (!run_codec(in, frames, OPENDMR_LATENCY_NORMAL, (opendmr_complexity_t)c,
+                       out, w0 + c * frames, &t_encode, &delay)) {
+            rc = 1;
+            break;
+        }
+        if (c == OPENDMR_COMPLEXITY_HIGH)
+            t_high = t_encode;
+
+        envelope(out, blocks, env_out);
+        size_t lag = (size_t)envelope_lag(env_in, env_out, blocks,
+                                          LATENCY_MAX_MS * OPENDMR_SAMPLE_RATE / 1000 /
+                                          ENVELOPE_BLOCK) * ENVELOPE_BLOCK;
+
+        /* RMS difference of the log spectra, less their level difference,
+         * averaged over speech frames */
+        double lsd = 0;
+        size_t active = 0;
+        for (size_t t = 0; t + lag + SPECTRUM_SIZE <= samples; t += OPENDMR_PCM_SAMPLES) {
+            double energy = 0;
+            for (int n = 0; n < SPECTRUM_SIZE; n++)
+                energy += (double)in[t + n] * in[t + n];
+            if (10.0 * log10(energy / SPECTRUM_SIZE + 1.0) - 90.31 < ACTIVE_DBFS)
+                continue;
+
+            double db_in[SPECTRUM_BINS], db_out[SPECTRUM_BINS], sum = 0, sum2 = 0;
+            log_spectrum(in + t, db_in);
+            log_spectrum(out + t + lag, db_out);
+            for (int k = SPECTRUM_LO; k <= SPECTRUM_HI; k++) {
+                double d = db_in[k] - db_out[k];
+                sum += d;
+                sum2 += d * d;
+            }
+            lsd += sqrt(sum2 / SPECTRUM_BAND - (sum / SPECTRUM_BAND) * (sum / SPECTRUM_BAND));
+            active++;
+        }
+
+        printf("%-7s  %6.1f us     %3.0f%%   %6.2f dB          %5.1f%%\n", names[c],
+               t_encode / frames, 100.0 * t_encode / t_high, active ? lsd / active : 0.0,
+               pitch_agreement(w0, w0 + c * frames, frames));
+    }
+
+    free(in);
+    free(out);
+    free(env_in);
+    free(env_out);
+    free(w0);
+    return rc;
+}
+
+/*
+ * Encode with DTX enabled, and again without to compare, reporting the
+ * frames sent as silence and the encode time per frame both ways.
+ */
+static int do_dtx(const char *in_file, const char *out_file)
+{
+    size_t frames;
+    int16_t *in = load_pcm(in_file, &frames);
+    if (!in)
+        return 1;
+
+    FILE *fout = fopen(out_file, "wb");
+    if (!fout) {
+        fprintf(stderr, "Error: Cannot create output file '%s'\n", out_file);
+        free(in);
+        return 1;
+    }
+
+    /* The decoder only classifies the frames sent */
+    opendmr_decoder_t *dec = opendmr_decoder_create();
+    double t[2] = { 0, 0 };
+    size_t silent = 0;
+    int rc = 0;
+    for (int dtx = 1; dtx >= 0; dtx--) {
+        opendmr_encoder_t *enc = opendmr_encoder_create();
+        if (!enc || !dec) {
+            fprintf(stderr, "Error: Failed to create codec\n");
+            opendmr_encoder_destroy(enc);
+            rc = 1;
+            break;
+        }
+        opendmr_encoder_set_dtx(enc, dtx != 0);
+
+        for (size_t f = 0; f < frames; f++) {
+            uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES];
+            double t0 = now_us();
+            opendmr_encode(enc, in + f * OPENDMR_PCM_SAMPLES, ambe);
+            t[dtx] += now_us() - t0;
+
+            if (dtx) {
+                opendmr_params_t params;
+                fwrite(ambe, 1, sizeof(ambe), fout);
+                silent += opendmr_decode_params(dec, ambe, &params) &&
+                          params.frame_class == OPENDMR_FRAME_SILENCE;
+            }
+        }
+        opendmr_encoder_destroy(enc);
+    }
+
+    if (rc == 0) {
+        printf("Frames: %zu, sent as silence %zu (%.1f%%)\n",
+               frames, silent, 100.0 * silent / frames);
+        printf("Encode per frame: %.1f us with DTX, %.1f us without (%.0f%% saved)\n",
+               t[1] / frames, t[0] / frames, 100.0 * (1.0 - t[1] / t[0]));
+    }
+
+    opendmr_decoder_destroy(dec);
+    free(in);
+    fclose(fout);
+    return rc;
+}
+
 static void do_info(void)
 {
     printf("OpenDMR Library Information\n");
@@ -228,18 +1276,26 @@ int main(int argc, char *argv[])
     }
 
     if (strcmp(argv[1], "decode") == 0) {
-        if (argc != 4) {
-            fprintf(stderr, "Usage: %s decode <input.ambe> <output.raw>\n", argv[0]);
+        if (argc != 4 && argc != 5) {
+            fprintf(stderr, "Usage: %s decode <input.ambe> <output.raw> [rate|ulaw|alaw]\n", argv[0]);
             return 1;
         }
-        return do_decode(argv[2], argv[3]);
+        unsigned int rate;
+        int law;
+        if (!parse_format(argc, argv, &rate, &law))
+            return 1;
+        return do_decode(argv[2], argv[3], rate, law);
     }
     else if (strcmp(argv[1], "encode") == 0) {
-        if (argc != 4) {
-            fprintf(stderr, "Usage: %s encode <input.raw> <output.ambe>\n", argv[0]);
+        if (argc != 4 && argc != 5) {
+            fprintf(stderr, "Usage: %s encode <input.raw> <output.ambe> [rate|ulaw|alaw]\n", argv[0]);
             return 1;
         }
-        return do_encode(argv[2], argv[3]);
+        unsigned int rate;
+        int law;
+        if (!parse_format(argc, argv, &rate, &law))
+            return 1;
+        return do_encode(argv[2], argv[3], rate, law);
     }
     else if (strcmp(argv[1], "transcode") == 0) {
         if (argc != 4) {
@@ -248,6 +1304,90 @@ int main(int argc, char *argv[])
         }
         return do_transcode(argv[2], argv[3]);
     }
+    else if (strcmp(argv[1], "regenerate") == 0) {
+        if (argc != 4) {
+            fprintf(stderr, "Usage: %s regenerate <input.ambe> <output.ambe>\n", argv[0]);
+            return 1;
+        }
+        return do_regenerate(argv[2], argv[3]);
+    }
+    else if (strcmp(argv[1], "stereo") == 0) {
+        if (argc != 5) {
+            fprintf(stderr, "Usage: %s stereo <ts1.ambe> <ts2.ambe> <output.raw>\n", argv[0]);
+            return 1;
+        }
+        return do_stereo(argv[2], argv[3], argv[4]);
+    }
+    else if (strcmp(argv[1], "toimbe") == 0 || strcmp(argv[1], "fromimbe") == 0) {
+        if (argc != 4) {
+            fprintf(stderr, "Usage: %s %s <input> <output>\n", argv[0], argv[1]);
+            return 1;
+        }
+        return do_imbe(argv[2], argv[3], strcmp(argv[1], "toimbe") == 0);
+    }
+    else if (strcmp(argv[1], "roundtrip") == 0) {
+        return do_roundtrip();
+    }
+    else if (strcmp(argv[1], "schedule") == 0) {
+        if (argc != 4 && argc != 5) {
+            fprintf(stderr, "Usage: %s schedule <input.ambe> <streams> [seconds]\n", argv[0]);
+            return 1;
+        }
+        int streams = atoi(argv[3]);
+        int seconds = argc == 5 ? atoi(argv[4]) : 10;
+        if (streams < 1 || seconds < 1) {
+            fprintf(stderr, "Error: streams and seconds must be positive\n");
+            return 1;
+        }
+        return do_schedule(argv[2], streams, seconds);
+    }
+    else if (strcmp(argv[1], "conference") == 0) {
+        if (argc != 6) {
+            fprintf(stderr, "Usage: %s conference <input.ambe> <output.ambe> <legs> <talkers>\n", argv[0]);
+            return 1;
+        }
+        int legs = atoi(argv[4]);
+        int talkers = atoi(argv[5]);
+        if (legs < 2 || talkers < 0 || talkers > legs) {
+            fprintf(stderr, "Error: need at least 2 legs and 0..legs talkers\n");
+            return 1;
+        }
+        return do_conference(argv[2], argv[3], legs, talkers);
+    }
+    else if (strcmp(argv[1], "jitter") == 0) {
+        if (argc != 6) {
+            fprintf(stderr, "Usage: %s jitter <input.ambe> <output.raw> <jitter_ms> <loss_pct>\n", argv[0]);
+            return 1;
+        }
+        int jitter_ms = atoi(argv[4]);
+        int loss_pct = atoi(argv[5]);
+        if (jitter_ms < 0 || loss_pct < 0 || loss_pct > 100) {
+            fprintf(stderr, "Error: jitter must be >= 0 and loss 0..100\n");
+            return 1;
+        }
+        return do_jitter(argv[2], argv[3], jitter_ms, loss_pct);
+    }
+    else if (strcmp(argv[1], "latency") == 0) {
+        if (argc != 3) {
+            fprintf(stderr, "Usage: %s latency <input.raw>\n", argv[0]);
+            return 1;
+        }
+        return do_latency(argv[2]);
+    }
+    else if (strcmp(argv[1], "complexity") == 0) {
+        if (argc != 3) {
+            fprintf(stderr, "Usage: %s complexity <input.raw>\n", argv[0]);
+            return 1;
+        }
+        return do_complexity(argv[2]);
+    }
+    else if (strcmp(argv[1], "dtx") == 0) {
+        if (argc != 4) {
+            fprintf(stderr, "Usage: %s dtx <input.raw> <output.ambe>\n", argv[0]);
+            return 1;
+        }
+        return do_dtx(argv[2], argv[3]);
+    }
     else if (strcmp(argv[1], "info") == 0) {
         do_info();
         return 0;
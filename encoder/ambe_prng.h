@@ -0,0 +1,72 @@
+/*
+ * OpenDMR - Open Source DMR (AMBE+2) Vocoder Library
+ *
+ * B-block scrambling mask of the AMBE 3600x2450 FEC, shared by the encoder
+ * and decoder paths.
+ *
+ * The 23-bit mask is a function of the 12-bit C0 word only: an LCG
+ * (x = 173 * x + 13849 mod 65536) seeded with 16 * C0 is stepped 23
+ * times, and the top bit of each state gives one mask bit, MSB first.
+ * All 4096 masks are generated by the compiler into one table, so
+ * scrambling is a single load instead of a serial 23-step chain.
+ */
+
+#ifndef AMBE_PRNG_H
+#define AMBE_PRNG_H
+
+#include <stdint.h>
+
+#define AMBE_PRNG_ENTRIES   4096
+
+namespace ambe_prng {
+
+constexpr uint32_t next(uint32_t x)
+{
+    return (173U * x + 13849U) & 0xFFFFU;
+}
+
+/* Top bits of the next n states, the first in bit n - 1 */
+constexpr uint32_t bits(uint32_t x, int n)
+{
+    return n == 0 ? 0 : ((next(x) >> 15) << (n - 1)) | bits(next(x), n - 1);
+}
+
+constexpr uint32_t mask(uint32_t c0)
+{
+    return bits((16U * c0) & 0xFFFFU, 23);
+}
+
+/* 0 .. N-1 as a parameter pack, built by halving to keep recursion shallow */
+template <unsigned... I> struct index_list {};
+
+template <class A, class B> struct concat;
+template <unsigned... I, unsigned... J>
+struct concat<index_list<I...>, index_list<J...> > {
+    typedef index_list<I..., (sizeof...(I) + J)...> type;
+};
+
+template <unsigned N> struct make_index {
+    typedef typename concat<typename make_index<N / 2>::type,
+                            typename make_index<N - N / 2>::type>::type type;
+};
+template <> struct make_index<0> { typedef index_list<> type; };
+template <> struct make_index<1> { typedef index_list<0> type; };
+
+template <class L> struct table;
+template <unsigned... I> struct table<index_list<I...> > {
+    static constexpr uint32_t mask[sizeof...(I)] = { ambe_prng::mask(I)... };
+};
+template <unsigned... I>
+constexpr uint32_t table<index_list<I...> >::mask[sizeof...(I)];
+
+typedef table<make_index<AMBE_PRNG_ENTRIES>::type> masks;
+
+} // namespace ambe_prng
+
+/* 23-bit B-block scrambling mask for a 12-bit C0 word */
+inline uint32_t ambe_prng_mask(uint32_t c0)
+{
+    return ambe_prng::masks::mask[c0 & (AMBE_PRNG_ENTRIES - 1)];
+}
+
+#endif
@@ -1106,3 +1106,127 @@ unsigned int CGolay24128::decode24128(unsigned char* bytes)
 
     return decode23127(code >> 1);
 }
+
+unsigned int CGolay24128::decode23127(unsigned int code, unsigned int& errors)
+{
+    unsigned int syndrome = ::get_syndrome_23127(code);
+    unsigned int error_pattern = DECODING_TABLE_23127[syndrome];
+
+    errors = countBits(error_pattern);
+
+    code ^= error_pattern;
+
+    return code >> 11;
+}
+
+unsigned int CGolay24128::decode24128(unsigned int code, unsigned int& errors)
+{
+    unsigned int data = decode23127(code >> 1);
+
+    // Count against the re-encoded word so the parity bit is included
+    errors = countBits((code ^ encode24128(data)) & 0xFFFFFFU);
+
+    return data;
+}
+
+/*
+ * Batched decoding. The syndrome is the remainder of the received word
+ * modulo g(x); long division is done one quotient bit at a time with masks
+ * instead of branches, and error weights are counted with SWAR popcounts,
+ * so the lane loops vectorise. Only the correction lookup stays scalar.
+ */
+#define BATCH_LANES     16U
+
+static inline unsigned int swar_count(unsigned int v)
+{
+    v = v - ((v >> 1) & 0x55555555U);
+    v = (v & 0x33333333U) + ((v >> 2) & 0x33333333U);
+    v = (v + (v >> 4)) & 0x0F0F0F0FU;
+    return (v * 0x01010101U) >> 24;
+}
+
+static inline void syndromes_23127(const unsigned int* codes, unsigned int* syndromes, unsigned int n)
+{
+    for (unsigned int k = 0U; k < n; k++) {
+        unsigned int s = codes[k];
+        for (int i = 22; i >= 11; i--)
+            s ^= (0U - ((s >> i) & 1U)) & (GENPOL << (i - 11));
+        syndromes[k] = s;
+    }
+}
+
+void CGolay24128::encode23127Batch(const unsigned int* data, unsigned int* codes, unsigned int n)
+{
+    for (unsigned int k = 0U; k < n; k++)
+        codes[k] = ENCODING_TABLE_23127[data[k]];
+}
+
+void CGolay24128::encode24128Batch(const unsigned int* data, unsigned int* codes, unsigned int n)
+{
+    for (unsigned int k = 0U; k < n; k++)
+        codes[k] = ENCODING_TABLE_24128[data[k]];
+}
+
+void CGolay24128::decode23127Batch(const unsigned int* codes, unsigned int* data, unsigned int* errors, unsigned int n)
+{
+    unsigned int pattern[BATCH_LANES];
+
+    for (unsigned int base = 0U; base < n; base += BATCH_LANES) {
+        unsigned int m = n - base < BATCH_LANES ? n - base : BATCH_LANES;
+        const unsigned int* in = codes + base;
+
+        syndromes_23127(in, pattern, m);
+        for (unsigned int k = 0U; k < m; k++)
+            pattern[k] = DECODING_TABLE_23127[pattern[k]];
+
+        for (unsigned int k = 0U; k < m; k++)
+            data[base + k] = (in[k] ^ pattern[k]) >> 11;
+        if (errors != NULL) {
+            for (unsigned int k = 0U; k < m; k++)
+                errors[base + k] = swar_count(pattern[k]);
+        }
+    }
+}
+
+void CGolay24128::decode24128Batch(const unsigned int* codes, unsigned int* data, unsigned int* errors, unsigned int n)
+{
+    unsigned int word[BATCH_LANES], pattern[BATCH_LANES];
+
+    for (unsigned int base = 0U; base < n; base += BATCH_LANES) {
+        unsigned int m = n - base < BATCH_LANES ? n - base : BATCH_LANES;
+        const unsigned int* in = codes + base;
+
+        for (unsigned int k = 0U; k < m; k++)
+            word[k] = (in[k] & 0xFFFFFFU) >> 1;
+        syndromes_23127(word, pattern, m);
+        for (unsigned int k = 0U; k < m; k++)
+            pattern[k] = DECODING_TABLE_23127[pattern[k]];
+
+        for (unsigned int k = 0U; k < m; k++)
+            data[base + k] = (word[k] ^ pattern[k]) >> 11;
+
+        /*
+         * As decode24128(): the corrected word is always a codeword, whose
+         * parity bit makes its weight even, so the re-encoded word differs
+         * from the received one in the corrected bits and possibly parity.
+         */
+        if (errors != NULL) {
+            for (unsigned int k = 0U; k < m; k++) {
+                unsigned int parity = swar_count(word[k] ^ pattern[k]) & 1U;
+                errors[base + k] = swar_count(pattern[k]) + ((in[k] ^ parity) & 1U);
+            }
+        }
+    }
+}
+
+unsigned int CGolay24128::countBits(unsigned int v)
+{
+    unsigned int count = 0U;
+
+    while (v != 0U) {
+        v &= v - 1U;
+        count++;
+    }
+
+    return count;
+}
@@ -27,6 +27,20 @@ public:
     static unsigned int decode23127(unsigned int code);
     static unsigned int decode24128(unsigned int code);
     static unsigned int decode24128(unsigned char* bytes);
+
+    // As above, also returning the number of corrected bit errors
+    static unsigned int decode23127(unsigned int code, unsigned int& errors);
+    static unsigned int decode24128(unsigned int code, unsigned int& errors);
+
+    // The above over n codewords at once; errors may be NULL. Results are
+    // identical to the single-codeword functions
+    static void encode23127Batch(const unsigned int* data, unsigned int* codes, unsigned int n);
+    static void encode24128Batch(const unsigned int* data, unsigned int* codes, unsigned int n);
+    static void decode23127Batch(const unsigned int* codes, unsigned int* data, unsigned int* errors, unsigned int n);
+    static void decode24128Batch(const unsigned int* codes, unsigned int* data, unsigned int* errors, unsigned int n);
+
+private:
+    static unsigned int countBits(unsigned int v);
 };
 
 #endif
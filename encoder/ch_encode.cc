@@ -26,6 +26,7 @@
 #include "basic_op.h"
 #include "ch_encode.h"
 #include "aux_sub.h"
+#include "v_uv_det.h"
 
 
 void encode_frame_vector(IMBE_PARAM *imbe_param, Word16 *frame_vector)
@@ -108,3 +109,97 @@ void encode_frame_vector(IMBE_PARAM *imbe_param, Word16 *frame_vector)
 	frame_vector[7] |= (bit_stream[index0++])?0x10:0;
 	frame_vector[7] |= (imbe_param->b_vec[num_harms + 2])?0x01:0;
 }
+
+
+//-----------------------------------------------------------------------------
+//	PURPOSE:
+//		Inverse of encode_frame_vector: recover b_vec, ref_pitch, num_harms,
+//		num_bands and V/UV decisions from received u[] vectors
+//
+//	RETURN:
+//		1 on success, 0 for an invalid (reserved) pitch code
+//
+//-----------------------------------------------------------------------------
+Word16 decode_frame_vector(IMBE_PARAM *imbe_param, const Word16 *frame_vector)
+{
+	Word16 bit_stream[EN_BIT_STREAM_LEN], index0, bit_thr, i, j;
+	Word16 vec_num, num_harms, num_bands, stream_len, b0, b2;
+	Word16 vec_bits[33], *ba_ptr, *b_ptr;
+
+	b0 = (shr(frame_vector[0], 4) & 0xFC) | (shr(frame_vector[7], 1) & 0x03);
+	if(b0 > 207)
+		return 0;
+
+	imbe_param->ref_pitch = add(add(shl(b0, 7), 0x1380), 0x40);               // Centre of the b0 interval
+	get_num_harms(imbe_param);
+	num_harms  = imbe_param->num_harms;
+	num_bands  = imbe_param->num_bands;
+	stream_len = EN_BIT_STREAM_LEN - (num_bands - 3);
+
+	get_bit_allocation(num_harms, imbe_param->bit_alloc);
+
+	index0 = 0;
+	bit_stream[index0++] = (frame_vector[0] & 4)?1:0;
+	bit_stream[index0++] = (frame_vector[0] & 2)?1:0;
+	bit_stream[index0++] = (frame_vector[0] & 1)?1:0;
+
+	for(vec_num = 1; vec_num <= 3; vec_num++)
+		for(i = 11; i >= 0; i--)
+			bit_stream[index0++] = (frame_vector[vec_num] >> i) & 1;
+
+	// u4..u6 hold b1, two bits of b2, then the scan continues
+	j = 0;
+	for(vec_num = 4; vec_num <= 6; vec_num++)
+		for(i = 10; i >= 0; i--)
+			vec_bits[j++] = (frame_vector[vec_num] >> i) & 1;
+
+	j = 0;
+	imbe_param->b_vec[1] = 0;
+	for(i = 0; i < num_bands; i++)
+		imbe_param->b_vec[1] = (imbe_param->b_vec[1] << 1) | vec_bits[j++];
+
+	b2  = frame_vector[0] & 0x38;
+	b2 |= vec_bits[j++]?0x04:0;
+	b2 |= vec_bits[j++]?0x02:0;
+	b2 |= (frame_vector[7] & 0x08)?0x01:0;
+
+	while(j < 33)
+		bit_stream[index0++] = vec_bits[j++];
+
+	bit_stream[index0++] = (frame_vector[7] & 0x40)?1:0;
+	bit_stream[index0++] = (frame_vector[7] & 0x20)?1:0;
+	bit_stream[index0++] = (frame_vector[7] & 0x10)?1:0;
+
+	imbe_param->b_vec[0] = b0;
+	imbe_param->b_vec[2] = b2;
+
+	// Inverse priority scanning
+	b_ptr  = &imbe_param->b_vec[3];
+	ba_ptr = imbe_param->bit_alloc;
+	v_zap(b_ptr, num_harms - 1);
+
+	index0  = 0;
+	bit_thr = (num_harms == 0xb)?9:ba_ptr[0];
+	while(index0 < stream_len && bit_thr > 0)
+	{
+		for(i = 0; i < num_harms - 1 && index0 < stream_len; i++)
+			if(bit_thr <= ba_ptr[i])
+				b_ptr[i] |= shl(bit_stream[index0++], bit_thr - 1);
+
+		bit_thr--;
+	}
+
+	// Expand band decisions to harmonics; the last band takes the remainder
+	imbe_param->l_uv = 0;
+	for(j = 0; j < num_harms; j++)
+	{
+		i = j / 3;
+		if(i > num_bands - 1)
+			i = num_bands - 1;
+		imbe_param->v_uv_dsn[j] = (imbe_param->b_vec[1] >> (num_bands - 1 - i)) & 1;
+		if(!imbe_param->v_uv_dsn[j])
+			imbe_param->l_uv++;
+	}
+
+	return 1;
+}
@@ -27,6 +27,7 @@
 
 
 void encode_frame_vector(IMBE_PARAM *imbe_param, Word16 *frame_vector);
+Word16 decode_frame_vector(IMBE_PARAM *imbe_param, const Word16 *frame_vector);
 
 
 #endif
@@ -64,3 +64,85 @@ void dc_rmv(Word16 *sigin, Word16 *sigout, Word32 *mem, Word16 len)
 	}
 	*mem = L_mem;
 }
+
+
+//-----------------------------------------------------------------------------
+//	PURPOSE:
+//		High-pass filter to remove DC, taking floating point input
+//		(full scale +/-1.0). The conversion to fixed point is fused into
+//		the filter loop and keeps the full Q31 input precision.
+//
+//
+//  INPUT:
+//		*sigin  - pointer to input signal buffer (float)
+//      *sigout - pointer to output signal buffer
+//      *mem    - pointer to filter's memory element
+//       len    - number of input signal samples
+//
+//	OUTPUT:
+//		None
+//
+//	RETURN:
+//       Saved filter state in mem
+//
+//-----------------------------------------------------------------------------
+void dc_rmv_f32(const float *sigin, Word16 *sigout, Word32 *mem, Word16 len)
+{
+	Word32 L_tmp, L_mem;
+	float f_tmp;
+
+	L_mem = *mem;
+	while(len--)
+	{
+		f_tmp = *sigin++ * 2147483648.0f;
+		if(f_tmp >= 2147483648.0f)
+			L_tmp = MAX_32;
+		else if(f_tmp <= -2147483648.0f)
+			L_tmp = MIN_32;
+		else
+			L_tmp = (Word32)f_tmp;
+		L_mem = L_add(L_mem, L_tmp);
+		*sigout++ = round(L_mem);
+		L_mem = L_mpy_ls(L_mem, CNST_0_99_Q1_15);
+		L_mem = L_sub(L_mem, L_tmp);
+	}
+	*mem = L_mem;
+}
+
+
+//-----------------------------------------------------------------------------
+//	PURPOSE:
+//		High-pass filter to remove DC, taking 8-bit companded input
+//		(G.711). Each code is expanded through a 256-entry table as it
+//		is loaded, so no linear copy of the frame is made.
+//
+//
+//  INPUT:
+//		*sigin  - pointer to input signal buffer (G.711 codes)
+//		*lut    - pointer to the 256-entry expansion table
+//      *sigout - pointer to output signal buffer
+//      *mem    - pointer to filter's memory element
+//       len    - number of input signal samples
+//
+//	OUTPUT:
+//		None
+//
+//	RETURN:
+//       Saved filter state in mem
+//
+//-----------------------------------------------------------------------------
+void dc_rmv_g711(const UWord8 *sigin, const Word16 *lut, Word16 *sigout, Word32 *mem, Word16 len)
+{
+	Word32 L_tmp, L_mem;
+
+	L_mem = *mem;
+	while(len--)
+	{
+		L_tmp = L_deposit_h(lut[*sigin++]);
+		L_mem = L_add(L_mem, L_tmp);
+		*sigout++ = round(L_mem);
+		L_mem = L_mpy_ls(L_mem, CNST_0_99_Q1_15);
+		L_mem = L_sub(L_mem, L_tmp);
+	}
+	*mem = L_mem;
+}
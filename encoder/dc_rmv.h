@@ -43,4 +43,26 @@
 //-----------------------------------------------------------------------------
 void dc_rmv(Word16 *sigin, Word16 *sigout, Word32 *mem, Word16 len);
 
+//-----------------------------------------------------------------------------
+//	PURPOSE:
+//		High-pass filter to remove DC, taking floating point input
+//		(full scale +/-1.0) converted to fixed point inside the loop
+//
+//  INPUT/OUTPUT:
+//		As dc_rmv()
+//
+//-----------------------------------------------------------------------------
+void dc_rmv_f32(const float *sigin, Word16 *sigout, Word32 *mem, Word16 len);
+
+//-----------------------------------------------------------------------------
+//	PURPOSE:
+//		High-pass filter to remove DC, taking G.711 codes expanded
+//		through lut[256] inside the loop
+//
+//  INPUT/OUTPUT:
+//		As dc_rmv()
+//
+//-----------------------------------------------------------------------------
+void dc_rmv_g711(const UWord8 *sigin, const Word16 *lut, Word16 *sigout, Word32 *mem, Word16 len);
+
 #endif
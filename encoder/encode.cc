@@ -38,6 +38,8 @@
 #include "imbe_vocoder_impl.h"
 
 const uint8_t  BIT_MASK_TABLE8[]  = { 0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U };
+const uint32_t VEC_BITS_4400[]    = { 12U, 12U, 12U, 12U, 11U, 11U, 11U, 7U };
+#define CNST_0_99_Q1_15   0x7EB8
 #define WRITE_BIT(p,i,b)   p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE8[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE8[(i)&7])
 
 
@@ -55,26 +57,95 @@ void imbe_vocoder_impl::encode_init(void)
 
 
 void imbe_vocoder_impl::encode(IMBE_PARAM *imbe_param, Word16 *frame_vector, Word16 *snd)
+{
+	encode_load(snd);
+	encode_analysis(imbe_param, frame_vector);
+}
+
+
+void imbe_vocoder_impl::encode_f32(IMBE_PARAM *imbe_param, Word16 *frame_vector, const float *snd)
+{
+	encode_load_f32(snd);
+	encode_analysis(imbe_param, frame_vector);
+}
+
+
+void imbe_vocoder_impl::encode_g711(IMBE_PARAM *imbe_param, Word16 *frame_vector, const UWord8 *snd, const Word16 *lut)
+{
+	encode_load_g711(snd, lut);
+	encode_analysis(imbe_param, frame_vector);
+}
+
+
+void imbe_vocoder_impl::encode_load(Word16 *snd)
+{
+	encode_shift();
+	dc_rmv(snd, &pitch_ref_buf[PITCH_EST_BUF_SIZE - FRAME], &dc_rmv_mem, FRAME);
+	encode_lpf();
+}
+
+
+void imbe_vocoder_impl::encode_load_f32(const float *snd)
+{
+	encode_shift();
+	dc_rmv_f32(snd, &pitch_ref_buf[PITCH_EST_BUF_SIZE - FRAME], &dc_rmv_mem, FRAME);
+	encode_lpf();
+}
+
+
+void imbe_vocoder_impl::encode_load_g711(const UWord8 *snd, const Word16 *lut)
+{
+	encode_shift();
+	dc_rmv_g711(snd, lut, &pitch_ref_buf[PITCH_EST_BUF_SIZE - FRAME], &dc_rmv_mem, FRAME);
+	encode_lpf();
+}
+
+
+void imbe_vocoder_impl::encode_shift(void)
 {
 	Word16 i;
-	Word16 *wr_ptr, *sig_ptr;
 
 	for(i = 0; i < PITCH_EST_BUF_SIZE - FRAME; i++)
 	{
 		pitch_est_buf[i] = pitch_est_buf[i + FRAME];
 		pitch_ref_buf[i] = pitch_ref_buf[i + FRAME];
 	}
+}
 
-	dc_rmv(snd, &pitch_ref_buf[PITCH_EST_BUF_SIZE - FRAME], &dc_rmv_mem, FRAME);
+
+void imbe_vocoder_impl::encode_lpf(void)
+{
 	pe_lpf(&pitch_ref_buf[PITCH_EST_BUF_SIZE - FRAME], &pitch_est_buf[PITCH_EST_BUF_SIZE - FRAME], pe_lpf_mem, FRAME);
+}
 
-	pitch_est(imbe_param, pitch_est_buf);
+
+//
+// A loaded frame that is not analysed: the pitch track restarts, and the
+// voicing threshold decays as it would over silence
+//
+void imbe_vocoder_impl::encode_idle(void)
+{
+	pitch_est_init();
+	th_max = L_mpy_ls(th_max, CNST_0_99_Q1_15);
+}
+
+
+void imbe_vocoder_impl::encode_analysis(IMBE_PARAM *imbe_param, Word16 *frame_vector)
+{
+	Word16 i;
+	Word16 *wr_ptr, *sig_ptr;
+
+	// The analysed frame sits look_ahead frames before the newest one
+	Word16 base = (LOOK_AHEAD_MAX - look_ahead) * FRAME;
+	Word16 depth = look_ahead < max_track_depth ? look_ahead : max_track_depth;
+
+	pitch_est(imbe_param, &pitch_est_buf[base], depth);
 
     //
 	// Speech windowing and FFT calculation
 	//
 	wr_ptr  = (Word16 *)wr;
-	sig_ptr = &pitch_ref_buf[40];
+	sig_ptr = &pitch_ref_buf[base + 40];
 	for(i = 146; i < 256; i++)
 	{
 		fft_buf[i].re = mult(*sig_ptr++, *wr_ptr++);
@@ -93,50 +164,69 @@ void imbe_vocoder_impl::encode(IMBE_PARAM *imbe_param, Word16 *frame_vector, Wor
 
 	fft((Word16 *)&fft_buf, FFTLENGTH, 1);
 
-	pitch_ref(imbe_param, fft_buf);
+	pitch_ref(imbe_param, fft_buf, num_ref_cands);
 	v_uv_det(imbe_param, fft_buf);
 	sa_encode(imbe_param);
 	encode_frame_vector(imbe_param, frame_vector);
 }
 
-void imbe_vocoder_impl::encode_4400(int16_t *pcm, uint8_t *imbe)
+// Pack u0..u7 (12, 12, 12, 12, 11, 11, 11, 7 bits) into 88 bits MSB first
+static void pack_4400(const int16_t *frame_vector, uint8_t *imbe)
 {
-	int16_t frame_vector[8];
+	uint32_t offset = 0U;
+
 	memset(imbe, 0, 11);
 
-	imbe_encode(frame_vector, pcm);
+	for (uint32_t v = 0U; v < 8U; v++) {
+		int16_t mask = 1 << (VEC_BITS_4400[v] - 1U);
+		for (uint32_t i = 0U; i < VEC_BITS_4400[v]; i++, mask >>= 1, offset++)
+			WRITE_BIT(imbe, offset, (frame_vector[v] & mask) != 0);
+	}
+}
+
+static void unpack_4400(const uint8_t *imbe, int16_t *frame_vector)
+{
 	uint32_t offset = 0U;
-	int16_t mask = 0x0800;
 
-	for (uint32_t i = 0U; i < 12U; i++, mask >>= 1, offset++)
-		WRITE_BIT(imbe, offset, (frame_vector[0U] & mask) != 0);
+	for (uint32_t v = 0U; v < 8U; v++) {
+		int16_t val = 0;
+		for (uint32_t i = 0U; i < VEC_BITS_4400[v]; i++, offset++)
+			val = (val << 1) | ((imbe[offset >> 3] & BIT_MASK_TABLE8[offset & 7]) ? 1 : 0);
+		frame_vector[v] = val;
+	}
+}
+
+void imbe_vocoder_impl::encode_4400(int16_t *pcm, uint8_t *imbe)
+{
+	int16_t frame_vector[8];
 
-	mask = 0x0800;
-	for (uint32_t i = 0U; i < 12U; i++, mask >>= 1, offset++)
-		WRITE_BIT(imbe, offset, (frame_vector[1U] & mask) != 0);
+	imbe_encode(frame_vector, pcm);
+	pack_4400(frame_vector, imbe);
+}
 
-	mask = 0x0800;
-	for (uint32_t i = 0U; i < 12U; i++, mask >>= 1, offset++)
-		WRITE_BIT(imbe, offset, (frame_vector[2U] & mask) != 0);
+void imbe_vocoder_impl::encode_params_4400(IMBE_PARAM *imbe_param, uint8_t *imbe)
+{
+	Word16 frame_vector[8];
 
-	mask = 0x0800;
-	for (uint32_t i = 0U; i < 12U; i++, mask >>= 1, offset++)
-		WRITE_BIT(imbe, offset, (frame_vector[3U] & mask) != 0);
+	get_num_harms(imbe_param);
+	get_band_vuv(imbe_param);
+	imbe_param->b_vec[0] = shr( sub(imbe_param->ref_pitch, 0x1380), 7);
 
-	mask = 0x0400;
-	for (uint32_t i = 0U; i < 11U; i++, mask >>= 1, offset++)
-		WRITE_BIT(imbe, offset, (frame_vector[4U] & mask) != 0);
+	sa_encode(imbe_param);
+	encode_frame_vector(imbe_param, frame_vector);
+	pack_4400(frame_vector, imbe);
+}
 
-	mask = 0x0400;
-	for (uint32_t i = 0U; i < 11U; i++, mask >>= 1, offset++)
-		WRITE_BIT(imbe, offset, (frame_vector[5U] & mask) != 0);
+bool imbe_vocoder_impl::decode_params_4400(const uint8_t *imbe, IMBE_PARAM *imbe_param)
+{
+	Word16 frame_vector[8];
+	IMBE_PARAM rx;
 
-	mask = 0x0400;
-	for (uint32_t i = 0U; i < 11U; i++, mask >>= 1, offset++)
-		WRITE_BIT(imbe, offset, (frame_vector[6U] & mask) != 0);
+	unpack_4400(imbe, frame_vector);
+	if(!decode_frame_vector(&rx, frame_vector))
+		return false;
 
-	mask = 0x0040;
-	for (uint32_t i = 0U; i < 7U; i++, mask >>= 1, offset++)
-		WRITE_BIT(imbe, offset, (frame_vector[7U] & mask) != 0);
+	sa_decode(&rx);
+	*imbe_param = rx;
+	return true;
 }
-
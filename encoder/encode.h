@@ -24,6 +24,7 @@
 #define _ENCODE
 
 #define PITCH_EST_BUF_SIZE  621
+#define LOOK_AHEAD_MAX        2   // Frames of pitch look-ahead the buffer holds
 #if 0
 void encode_init(void);
 void encode(IMBE_PARAM *imbe_param, Word16 *frame_vector, Word16 *snd);
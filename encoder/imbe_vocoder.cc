@@ -11,25 +11,83 @@
 
 imbe_vocoder::imbe_vocoder()
 {
-	Impl = new imbe_vocoder_impl();
 }
 
 imbe_vocoder::~imbe_vocoder()
 {
-	delete Impl;
 }
 
 void imbe_vocoder::imbe_encode(int16_t *frame_vector, int16_t *snd)
 {
-	Impl->imbe_encode(frame_vector, snd);
+	Impl.imbe_encode(frame_vector, snd);
+}
+
+void imbe_vocoder::imbe_encode_f32(int16_t *frame_vector, const float *snd)
+{
+	Impl.imbe_encode_f32(frame_vector, snd);
+}
+
+void imbe_vocoder::imbe_encode_g711(int16_t *frame_vector, const uint8_t *snd, const int16_t *lut)
+{
+	Impl.imbe_encode_g711(frame_vector, snd, lut);
+}
+
+void imbe_vocoder::imbe_load(int16_t *snd)
+{
+	Impl.imbe_load(snd);
+}
+
+void imbe_vocoder::imbe_load_f32(const float *snd)
+{
+	Impl.imbe_load_f32(snd);
+}
+
+void imbe_vocoder::imbe_load_g711(const uint8_t *snd, const int16_t *lut)
+{
+	Impl.imbe_load_g711(snd, lut);
+}
+
+void imbe_vocoder::imbe_analyse(int16_t *frame_vector)
+{
+	Impl.imbe_analyse(frame_vector);
+}
+
+void imbe_vocoder::imbe_idle(void)
+{
+	Impl.imbe_idle();
+}
+
+const int16_t *imbe_vocoder::newest_frame(void) const
+{
+	return Impl.newest_frame();
 }
 
 void imbe_vocoder::encode_4400(int16_t *snd, uint8_t *imbe)
 {
-	Impl->encode_4400(snd, imbe);
+	Impl.encode_4400(snd, imbe);
+}
+
+void imbe_vocoder::encode_params_4400(IMBE_PARAM *imbe_param, uint8_t *imbe)
+{
+	Impl.encode_params_4400(imbe_param, imbe);
+}
+
+bool imbe_vocoder::decode_params_4400(const uint8_t *imbe, IMBE_PARAM *imbe_param)
+{
+	return Impl.decode_params_4400(imbe, imbe_param);
 }
 
 const IMBE_PARAM* imbe_vocoder::param(void)
 {
-	return Impl->param();
+	return Impl.param();
+}
+
+void imbe_vocoder::set_look_ahead(int16_t frames)
+{
+	Impl.set_look_ahead(frames);
+}
+
+void imbe_vocoder::set_search(int16_t ref_cands, int16_t track_depth)
+{
+	Impl.set_search(ref_cands, track_depth);
 }
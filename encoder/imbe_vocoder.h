@@ -11,8 +11,12 @@
 
 #include <cstdint>
 #include "imbe.h"
+#include "imbe_vocoder_impl.h"
 
-class imbe_vocoder_impl;
+/*
+ * The implementation is held by value so that an encoder is a single flat
+ * object with no heap allocations, suitable for placement in caller memory.
+ */
 class imbe_vocoder
 {
 public:
@@ -23,13 +27,41 @@ public:
 	// outputs u[] vectors as frame_vector[]
 	void imbe_encode(int16_t *frame_vector, int16_t *snd);
 
+	// imbe_encode_f32 compresses 160 float samples (full scale +/-1.0)
+	void imbe_encode_f32(int16_t *frame_vector, const float *snd);
+
+	// imbe_encode_g711 compresses 160 G.711 codes expanded through lut[256]
+	void imbe_encode_g711(int16_t *frame_vector, const uint8_t *snd, const int16_t *lut);
+
+	// imbe_load* take in one frame for imbe_analyse() or imbe_idle()
+	void imbe_load(int16_t *snd);
+	void imbe_load_f32(const float *snd);
+	void imbe_load_g711(const uint8_t *snd, const int16_t *lut);
+	void imbe_analyse(int16_t *frame_vector);
+	void imbe_idle(void);
+
+	// Newest loaded frame after DC removal (160 samples)
+	const int16_t *newest_frame(void) const;
+
 	// encode_4400 encodes PCM to IMBE frame (88 bits)
 	void encode_4400(int16_t *snd, uint8_t *imbe);
 
+	// encode_params_4400 quantises model parameters to an IMBE frame
+	void encode_params_4400(IMBE_PARAM *imbe_param, uint8_t *imbe);
+
+	// decode_params_4400 dequantises an IMBE frame to model parameters
+	bool decode_params_4400(const uint8_t *imbe, IMBE_PARAM *imbe_param);
+
 	// Get access to IMBE parameters (for analysis)
 	const IMBE_PARAM* param(void);
 
+	// set_look_ahead selects 0..LOOK_AHEAD_MAX frames of pitch look-ahead
+	void set_look_ahead(int16_t frames);
+
+	// set_search sets the pitch refinement candidates and tracking depth
+	void set_search(int16_t ref_cands, int16_t track_depth);
+
 private:
-	imbe_vocoder_impl *Impl;
+	imbe_vocoder_impl Impl;
 };
 #endif /* INCLUDED_IMBE_VOCODER_H */
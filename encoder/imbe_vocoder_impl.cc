@@ -9,6 +9,7 @@
 #include <cstdio>
 
 #include "imbe_vocoder_impl.h"
+#include "pitch_ref.h"
 
 imbe_vocoder_impl::imbe_vocoder_impl(void) :
 	prev_pitch(0),
@@ -18,8 +19,12 @@ imbe_vocoder_impl::imbe_vocoder_impl(void) :
 	seed(1),
 	num_harms_prev1(0),
 	num_harms_prev2(0),
+	num_harms_dec_prev(0),
 	th_max(0),
-	dc_rmv_mem(0)
+	dc_rmv_mem(0),
+	look_ahead(LOOK_AHEAD_MAX),
+	num_ref_cands(PITCH_REF_CANDS),
+	max_track_depth(LOOK_AHEAD_MAX)
 {
 	memset(wr_array, 0, sizeof(wr_array));
 	memset(wi_array, 0, sizeof(wi_array));
@@ -29,9 +34,11 @@ imbe_vocoder_impl::imbe_vocoder_impl(void) :
 	memset(fft_buf, 0, sizeof(fft_buf));
 	memset(sa_prev1, 0, sizeof(sa_prev1));
 	memset(sa_prev2, 0, sizeof(sa_prev2));
+	memset(sa_dec_prev, 0, sizeof(sa_dec_prev));
 	memset(v_uv_dsn, 0, sizeof(v_uv_dsn));
 
 	memset(&my_imbe_param, 0, sizeof(IMBE_PARAM));
 
 	encode_init();
+	sa_decode_init();
 }
@@ -30,12 +30,55 @@ public:
 		encode(&my_imbe_param, frame_vector, snd);
 	}
 
+	// imbe_encode_f32 compresses 160 float samples (full scale +/-1.0)
+	void imbe_encode_f32(int16_t *frame_vector, const float *snd) {
+		encode_f32(&my_imbe_param, frame_vector, snd);
+	}
+
+	// imbe_encode_g711 compresses 160 G.711 codes expanded through lut[256]
+	void imbe_encode_g711(int16_t *frame_vector, const uint8_t *snd, const int16_t *lut) {
+		encode_g711(&my_imbe_param, frame_vector, snd, lut);
+	}
+
+	// imbe_load* take in one frame without analysing it: the input and
+	// pitch estimation histories advance, ready for imbe_analyse() or
+	// imbe_idle(). imbe_encode* are a load followed by an analysis.
+	void imbe_load(int16_t *snd) { encode_load(snd); }
+	void imbe_load_f32(const float *snd) { encode_load_f32(snd); }
+	void imbe_load_g711(const uint8_t *snd, const int16_t *lut) { encode_load_g711(snd, lut); }
+	void imbe_analyse(int16_t *frame_vector) { encode_analysis(&my_imbe_param, frame_vector); }
+	void imbe_idle(void) { encode_idle(); }
+
+	// Newest loaded frame after DC removal (160 samples)
+	const int16_t *newest_frame(void) const { return &pitch_ref_buf[PITCH_EST_BUF_SIZE - FRAME]; }
+
 	// encode_4400 encodes PCM to IMBE frame (88 bits)
 	void encode_4400(int16_t *snd, uint8_t *imbe);
 
+	// encode_params_4400 quantises supplied model parameters (ref_pitch,
+	// v_uv_dsn[], sa[]) to an IMBE frame, bypassing speech analysis.
+	// Shares the spectral amplitude predictor with encode_4400, so use one
+	// or the other on a given instance.
+	void encode_params_4400(IMBE_PARAM *imbe_param, uint8_t *imbe);
+
+	// decode_params_4400 dequantises an IMBE frame to model parameters.
+	// Returns false (param untouched) for invalid pitch codes.
+	bool decode_params_4400(const uint8_t *imbe, IMBE_PARAM *imbe_param);
+
 	// Get access to IMBE parameters (for analysis)
 	const IMBE_PARAM* param(void) { return &my_imbe_param; }
 
+	// set_look_ahead selects 0..LOOK_AHEAD_MAX frames of pitch look-ahead.
+	// Fewer frames move the analysis windows towards the newest input,
+	// cutting the encoder delay by one frame each.
+	void set_look_ahead(Word16 frames) { look_ahead = frames; }
+
+	// set_search trades analysis quality for speed: ref_cands pitch
+	// refinement candidates (up to PITCH_REF_CANDS) and at most
+	// track_depth frames of look-ahead pitch tracking, without moving
+	// the analysis windows.
+	void set_search(Word16 ref_cands, Word16 track_depth) { num_ref_cands = ref_cands; max_track_depth = track_depth; }
+
 private:
 	IMBE_PARAM my_imbe_param;
 
@@ -46,6 +89,8 @@ private:
 	Word32 sa_prev1[NUM_HARMS_MAX + 2];
 	Word16 num_harms_prev2;
 	Word32 sa_prev2[NUM_HARMS_MAX + 2];
+	Word16 num_harms_dec_prev;
+	Word32 sa_dec_prev[NUM_HARMS_MAX + 2];
 	Word32 th_max;
 	Word16 v_uv_dsn[NUM_BANDS_MAX];
 	Word16 wr_array[FFTLENGTH / 2 + 1];
@@ -55,6 +100,9 @@ private:
 	Word32 dc_rmv_mem;
 	Cmplx16 fft_buf[FFTLENGTH];
 	Word16 pe_lpf_mem[PE_LPF_ORD];
+	Word16 look_ahead;
+	Word16 num_ref_cands;
+	Word16 max_track_depth;
 
 	/* member functions - encode path only */
 	void idct(Word16 *in, Word16 m_lim, Word16 i_lim, Word16 *out);
@@ -62,12 +110,24 @@ private:
 	void fft_init(void);
 	void fft(Word16 *datam1, Word16 nn, Word16 isign);
 	void encode(IMBE_PARAM *imbe_param, Word16 *frame_vector, Word16 *snd);
+	void encode_f32(IMBE_PARAM *imbe_param, Word16 *frame_vector, const float *snd);
+	void encode_g711(IMBE_PARAM *imbe_param, Word16 *frame_vector, const UWord8 *snd, const Word16 *lut);
+	void encode_load(Word16 *snd);
+	void encode_load_f32(const float *snd);
+	void encode_load_g711(const UWord8 *snd, const Word16 *lut);
+	void encode_shift(void);
+	void encode_lpf(void);
+	void encode_idle(void);
+	void encode_analysis(IMBE_PARAM *imbe_param, Word16 *frame_vector);
 	void pitch_est_init(void);
 	Word32 autocorr(Word16 *sigin, Word16 shift, Word16 scale_shift);
 	void e_p(Word16 *sigin, Word16 *res_buf);
-	void pitch_est(IMBE_PARAM *imbe_param, Word16 *frames_buf);
+	void pitch_est(IMBE_PARAM *imbe_param, Word16 *frames_buf, Word16 depth);
 	void sa_encode_init(void);
 	void sa_encode(IMBE_PARAM *imbe_param);
+	void sa_reconstruct(IMBE_PARAM *imbe_param, Word32 *sa_prev, Word16 *num_harms_prev);
+	void sa_decode_init(void);
+	void sa_decode(IMBE_PARAM *imbe_param);
 	void pitch_ref_init(void);
 	Word16 voiced_sa_calc(Word32 num, Word16 den);
 	Word16 unvoiced_sa_calc(Word32 num, Word16 den);
@@ -21,6 +21,7 @@
 
 #include "mbeenc.h"
 #include "cgolay24128.h"
+#include "ambe_prng.h"
 #include "ambe3600x2450_const.h"  // DMR AMBE+2 tables
 
 /* Lookup table for b0 (pitch) encoding */
@@ -159,48 +160,33 @@ static const unsigned int DMR_C_TABLE[] = {
 	39U, 43U, 47U, 51U, 55U, 59U, 63U, 67U, 71U
 };
 
-/* PRNG table for B-block scrambling */
-static const unsigned int PRNG_TABLE[] = {
-	0x000000U, 0x000001U, 0x000002U, 0x000003U, 0x000004U, 0x000007U, 0x000006U, 0x000005U,
-	0x000008U, 0x000009U, 0x00000EU, 0x00000FU, 0x00000AU, 0x00000BU, 0x00000CU, 0x00000DU,
-	0x000010U, 0x000011U, 0x000012U, 0x000013U, 0x00001CU, 0x00001DU, 0x00001AU, 0x00001BU,
-	0x000018U, 0x000019U, 0x000016U, 0x000017U, 0x000014U, 0x000015U, 0x00003AU, 0x00003BU,
-	0x000024U, 0x000025U, 0x000026U, 0x000027U, 0x000020U, 0x000021U, 0x000022U, 0x000023U,
-	0x000038U, 0x000039U, 0x00002EU, 0x00002FU, 0x000034U, 0x000035U, 0x00002CU, 0x00002DU,
-	0x000028U, 0x000029U, 0x00002AU, 0x00002BU, 0x00003CU, 0x00003DU, 0x000032U, 0x000033U,
-	0x000030U, 0x000031U, 0x000036U, 0x000037U, 0x00006CU, 0x00006DU, 0x00006AU, 0x00006BU,
-	0x000048U, 0x000049U, 0x00004EU, 0x00004FU, 0x00004AU, 0x00004BU, 0x00004CU, 0x00004DU,
-	0x000074U, 0x000075U, 0x000076U, 0x000077U, 0x000070U, 0x000071U, 0x000072U, 0x000073U,
-	0x000068U, 0x000069U, 0x00005EU, 0x00005FU, 0x000054U, 0x000055U, 0x00005CU, 0x00005DU,
-	0x000058U, 0x000059U, 0x00005AU, 0x00005BU, 0x00007CU, 0x00007DU, 0x000062U, 0x000063U,
-	0x000040U, 0x000041U, 0x000046U, 0x000047U, 0x000044U, 0x000045U, 0x00007AU, 0x00007BU,
-	0x000078U, 0x000079U, 0x00007EU, 0x00007FU, 0x00006EU, 0x00006FU, 0x000064U, 0x000065U,
-	0x000066U, 0x000067U, 0x000060U, 0x000061U, 0x000042U, 0x000043U, 0x000050U, 0x000051U,
-	0x000052U, 0x000053U, 0x00009CU, 0x00009DU, 0x00009AU, 0x00009BU, 0x000098U, 0x000099U,
-	0x000090U, 0x000091U, 0x000096U, 0x000097U, 0x000094U, 0x000095U, 0x0000DAU, 0x0000DBU,
-	0x0000D8U, 0x0000D9U, 0x0000E8U, 0x0000E9U, 0x0000EEU, 0x0000EFU, 0x0000ECU, 0x0000EDU,
-	0x0000E4U, 0x0000E5U, 0x0000E6U, 0x0000E7U, 0x0000E0U, 0x0000E1U, 0x0000E2U, 0x0000E3U,
-	0x0000DCU, 0x0000DDU, 0x0000C2U, 0x0000C3U, 0x0000C0U, 0x0000C1U, 0x0000C6U, 0x0000C7U,
-	0x0000F8U, 0x0000F9U, 0x0000FEU, 0x0000FFU, 0x0000FAU, 0x0000FBU, 0x0000FCU, 0x0000FDU,
-	0x0000F4U, 0x0000F5U, 0x0000F6U, 0x0000F7U, 0x0000F0U, 0x0000F1U, 0x0000F2U, 0x0000F3U,
-	0x0000C4U, 0x0000C5U, 0x0000CAU, 0x0000CBU, 0x0000D4U, 0x0000D5U, 0x0000CCU, 0x0000CDU,
-	0x0000C8U, 0x0000C9U, 0x0000CEU, 0x0000CFU, 0x0000D0U, 0x0000D1U, 0x0000DEU, 0x0000DFU,
-	0x000080U, 0x000081U, 0x000086U, 0x000087U, 0x000084U, 0x000085U, 0x0000BAU, 0x0000BBU,
-	0x0000B8U, 0x0000B9U, 0x0000BEU, 0x0000BFU, 0x0000AEU, 0x0000AFU, 0x0000A4U, 0x0000A5U,
-	0x0000A6U, 0x0000A7U, 0x0000A0U, 0x0000A1U, 0x000082U, 0x000083U, 0x000092U, 0x000093U,
-	0x0000D2U, 0x0000D3U, 0x0000D6U, 0x0000D7U, 0x000088U, 0x000089U, 0x00008EU, 0x00008FU,
-	0x00008AU, 0x00008BU, 0x00008CU, 0x00008DU, 0x0000B4U, 0x0000B5U, 0x0000B6U, 0x0000B7U,
-	0x0000B0U, 0x0000B1U, 0x0000B2U, 0x0000B3U, 0x0000ACU, 0x0000ADU, 0x0000A2U, 0x0000A3U,
-	0x0000BCU, 0x0000BDU, 0x0000AAU, 0x0000ABU, 0x0000A8U, 0x0000A9U, 0x0000AEU, 0x0000AFU
-};
-
 /* Bit manipulation macros */
 #define READ_BIT(p, i)    (((p)[(i) >> 3] >> (7 - ((i) & 7))) & 1)
 #define WRITE_BIT(p, i, b) (p)[(i) >> 3] = ((b) ? ((p)[(i) >> 3] | (1 << (7 - ((i) & 7)))) : ((p)[(i) >> 3] & ~(1 << (7 - ((i) & 7)))))
 
+/*
+ * The standard DMR silence frame (b0 = 124; B9 E8 81 52 61 73 00 2A 6B on
+ * air), sent for frames the voice activity detector finds silent.
+ */
+static const int SILENCE_B[9] = { 124, 16, 1, 53, 78, 18, 14, 12, 1 };
+
+/*
+ * Voice activity detector: frame energy against a noise floor taken as the
+ * minimum over the last one to two blocks of frames, with the spectral
+ * flatness (order-2 LPC prediction error over energy: 1 for white noise,
+ * well below for voiced speech) to keep quiet voiced frames.
+ */
+#define VAD_BLOCK           25      /* Frames per noise floor block */
+#define VAD_SILENT_DBFS     -66.0f  /* Below this a frame is always silent */
+#define VAD_SPEECH_DB       10.0f   /* Above the floor: speech */
+#define VAD_VOICED_DB       4.0f    /* Above the floor and not flat: speech */
+#define VAD_FLATNESS        0.3f
+#define VAD_HANGOVER        8       /* Frames analysed after the last speech */
+
 /* Forward declarations */
 static void encode_49bit(uint8_t outp[49], const int b[9]);
 static void encode_ambe(const IMBE_PARAM *imbe_param, int b[], mbe_parms *cur_mp, mbe_parms *prev_mp, float gain_adjust);
+static void update_state(const int b[9], mbe_parms *cur_mp, mbe_parms *prev_mp);
 
 /*
  * Encode voice parameters to 49-bit DMR format.
@@ -513,7 +499,15 @@ static void encode_ambe(const IMBE_PARAM *imbe_param, int b[], mbe_parms *cur_mp
 		b[4+ii] = error_index;
 	}
 
-	/* Update decoder state with quantized values */
+	update_state(b, cur_mp, prev_mp);
+}
+
+/*
+ * Track the decoder: decode the quantised b[9] into the parameters the
+ * next frame is predicted from.
+ */
+static void update_state(const int b[9], mbe_parms *cur_mp, mbe_parms *prev_mp)
+{
 	uint8_t ambe_49[49];
 	encode_49bit(ambe_49, b);
 
@@ -530,7 +524,13 @@ static void encode_ambe(const IMBE_PARAM *imbe_param, int b[], mbe_parms *cur_mp
  * MBEEncoder implementation
  */
 MBEEncoder::MBEEncoder()
-	: d_gain_adjust(1.0f)
+	: d_gain_adjust(1.0f),
+	  d_look_ahead(2),
+	  d_dtx(false),
+	  d_hang(0),
+	  d_block_pos(0),
+	  d_block_min(VAD_SILENT_DBFS),
+	  d_prev_block_min(VAD_SILENT_DBFS)
 {
 	mbe_parms enh_mp;
 	mbe_initMbeParms(&cur_mp, &prev_mp, &enh_mp);
@@ -545,18 +545,93 @@ void MBEEncoder::set_dmr_mode(void)
 	/* DMR mode is the only mode - no action needed */
 }
 
-void MBEEncoder::encode_dmr_params(const int16_t samples[], int b[9])
+/*
+ * Classify the newest loaded frame. It is judged as it enters the look-ahead,
+ * so an onset restarts analysis before it reaches the analysed frame, and
+ * the hang-over covers the look-ahead as well as the tail of the speech.
+ */
+bool MBEEncoder::vad_active(void)
+{
+	const int16_t *x = vocoder.newest_frame();
+	float r0 = 0.0f, r1 = 0.0f, r2 = 0.0f;
+	for (int i = 0; i < 160; i++) {
+		float s = (float)x[i];
+		r0 += s * s;
+		if (i >= 1) r1 += s * (float)x[i - 1];
+		if (i >= 2) r2 += s * (float)x[i - 2];
+	}
+
+	/* Energy in dBFS; the floor starts low so the first frames are kept */
+	float db = 10.0f * log10f(r0 / 160.0f + 1.0f) - 90.31f;
+	if (db < d_block_min)
+		d_block_min = db;
+	float floor_db = d_block_min < d_prev_block_min ? d_block_min : d_prev_block_min;
+	if (++d_block_pos == VAD_BLOCK) {
+		d_prev_block_min = d_block_min;
+		d_block_min = 0.0f;
+		d_block_pos = 0;
+	}
+
+	/* Levinson recursion to order 2 */
+	float flatness = 1.0f;
+	if (r0 > 0.0f) {
+		float k1 = r1 / r0;
+		float e1 = r0 * (1.0f - k1 * k1);
+		float k2 = e1 > 0.0f ? (r2 - k1 * r1) / e1 : 0.0f;
+		flatness = e1 * (1.0f - k2 * k2) / r0;
+	}
+
+	bool speech = db > VAD_SILENT_DBFS &&
+	              (db > floor_db + VAD_SPEECH_DB ||
+	               (db > floor_db + VAD_VOICED_DB && flatness < VAD_FLATNESS));
+	if (speech)
+		d_hang = VAD_HANGOVER + d_look_ahead;
+	else if (d_hang > 0)
+		d_hang--;
+	return d_hang > 0;
+}
+
+void MBEEncoder::encode_loaded(int b[9])
 {
 	int16_t frame_vector[8];  /* Result ignored */
 
-	/* Do speech analysis to generate MBE model parameters
-	 * Note: imbe_encode expects non-const pointer but does not modify the samples.
+	if (d_dtx && !vad_active()) {
+		/* Silence: only the decoder tracking and input histories advance */
+		vocoder.imbe_idle();
+		for (int i = 0; i < 9; i++)
+			b[i] = SILENCE_B[i];
+		update_state(b, &cur_mp, &prev_mp);
+		return;
+	}
+
+	vocoder.imbe_analyse(frame_vector);
+	encode_ambe(vocoder.param(), b, &cur_mp, &prev_mp, d_gain_adjust);
+}
+
+void MBEEncoder::encode_dmr_params(const int16_t samples[], int b[9])
+{
+	/* Note: imbe_load expects non-const pointer but does not modify the samples.
 	 * This is a legacy API limitation from the original OP25 code.
 	 * We use const_cast here as the underlying implementation only reads the data. */
-	vocoder.imbe_encode(frame_vector, const_cast<int16_t*>(samples));
+	vocoder.imbe_load(const_cast<int16_t*>(samples));
+	encode_loaded(b);
+}
 
-	/* Encode to get b[9] voice parameters */
-	encode_ambe(vocoder.param(), b, &cur_mp, &prev_mp, d_gain_adjust);
+void MBEEncoder::encode_dmr_params_f32(const float samples[], int b[9])
+{
+	vocoder.imbe_load_f32(samples);
+	encode_loaded(b);
+}
+
+void MBEEncoder::encode_dmr_params_g711(const uint8_t samples[], const int16_t lut[256], int b[9])
+{
+	vocoder.imbe_load_g711(samples, lut);
+	encode_loaded(b);
+}
+
+void MBEEncoder::encode_dmr_params_imbe(const IMBE_PARAM *imbe_param, int b[9])
+{
+	encode_ambe(imbe_param, b, &cur_mp, &prev_mp, d_gain_adjust);
 }
 
 void MBEEncoder::encode_dmr(const unsigned char* in, unsigned char* out)
@@ -585,7 +660,7 @@ void MBEEncoder::encode_dmr(const unsigned char* in, unsigned char* out)
 	unsigned int a = CGolay24128::encode24128(aOrig);
 
 	/* PRNG scramble and Golay encode B */
-	unsigned int p = PRNG_TABLE[aOrig] >> 1;
+	unsigned int p = ambe_prng_mask(aOrig);
 	unsigned int b = CGolay24128::encode23127(bOrig) >> 1;
 	b ^= p;
 
@@ -30,6 +30,28 @@ public:
 	 */
 	void set_gain_adjust(const float gain_adjust) { d_gain_adjust = gain_adjust; }
 
+	/**
+	 * Set the frames of pitch look-ahead (0 to 2, default 2). Each frame
+	 * less cuts the analysis delay by 20 ms.
+	 * @param frames Look-ahead in frames
+	 */
+	void set_look_ahead(int frames) { d_look_ahead = frames; vocoder.set_look_ahead(frames); }
+
+	/**
+	 * Limit the speech analysis searches (default: full search).
+	 * @param ref_cands   Pitch refinement candidates (1 to 19, odd)
+	 * @param track_depth Frames of look-ahead pitch tracking (0 to 2)
+	 */
+	void set_search(int ref_cands, int track_depth) { vocoder.set_search(ref_cands, track_depth); }
+
+	/**
+	 * Enable discontinuous transmission. Frames the voice activity
+	 * detector finds silent are sent as the standard DMR silence frame
+	 * (b0 = 124) without speech analysis.
+	 * @param enable true to enable (default false)
+	 */
+	void set_dtx(bool enable) { d_dtx = enable; }
+
 	/**
 	 * Enable DMR mode (AMBE+2). This is the default and only supported mode.
 	 */
@@ -44,6 +66,34 @@ public:
 	 */
 	void encode_dmr_params(const int16_t samples[], int b[9]);
 
+	/**
+	 * Analyze float PCM and return b[9] voice parameters for DMR.
+	 * The conversion to fixed point is fused into the DC removal filter.
+	 *
+	 * @param samples Input: 160 float samples (full scale +/-1.0, 8kHz)
+	 * @param b       Output: 9 voice parameter values
+	 */
+	void encode_dmr_params_f32(const float samples[], int b[9]);
+
+	/**
+	 * Analyze G.711 audio and return b[9] voice parameters for DMR.
+	 * Expansion to linear is fused into the DC removal filter.
+	 *
+	 * @param samples Input: 160 G.711 codes (8kHz)
+	 * @param lut     Input: 256-entry expansion table for the codes' law
+	 * @param b       Output: 9 voice parameter values
+	 */
+	void encode_dmr_params_g711(const uint8_t samples[], const int16_t lut[256], int b[9]);
+
+	/**
+	 * Quantise externally supplied model parameters (e.g. decoded IMBE)
+	 * and return b[9] voice parameters for DMR. No speech analysis is run.
+	 *
+	 * @param imbe_param Input: ref_pitch, num_harms, v_uv_dsn[] and sa[]
+	 * @param b          Output: 9 voice parameter values
+	 */
+	void encode_dmr_params_imbe(const IMBE_PARAM *imbe_param, int b[9]);
+
 	/**
 	 * Encode 49-bit voice data to 72-bit DMR frame with FEC.
 	 *
@@ -53,10 +103,22 @@ public:
 	void encode_dmr(const unsigned char* in, unsigned char* out);
 
 private:
+	/* Analyse the loaded frame, or send silence when DTX allows it */
+	void encode_loaded(int b[9]);
+	bool vad_active(void);
+
 	imbe_vocoder vocoder;
 	mbe_parms cur_mp;
 	mbe_parms prev_mp;
 	float d_gain_adjust;
+	int d_look_ahead;
+
+	/* Voice activity detector */
+	bool d_dtx;
+	int d_hang;                 /* Frames still to analyse after speech */
+	int d_block_pos;            /* Frames into the current minimum block */
+	float d_block_min;          /* Noise floor: minimum energy (dBFS) of */
+	float d_prev_block_min;     /* this and the previous block */
 };
 
 #endif /* MBEENC_H */
@@ -185,7 +185,7 @@ void imbe_vocoder_impl::e_p(Word16 *sigin, Word16 *res_buf)
 
 
 
-void imbe_vocoder_impl::pitch_est(IMBE_PARAM *imbe_param, Word16 *frames_buf)
+void imbe_vocoder_impl::pitch_est(IMBE_PARAM *imbe_param, Word16 *frames_buf, Word16 depth)
 {
 	Word16 e_p_arr0[203], e_p_arr1[203], e_p_arr2[203], e1p1_e2p2_est_save[203];
 	Word16 min_index, max_index, p, i, p_index;
@@ -195,7 +195,7 @@ void imbe_vocoder_impl::pitch_est(IMBE_PARAM *imbe_param, Word16 *frames_buf)
 	Word16 cef_est, cef, p0_est, p0, p1, p2, p1_max_index, p2_max_index, e1p1_e2p2_est;
         Word16 e_p_arr2_min[203];
 
-	// Calculate E(p) function for current and two future frames
+	// Calculate E(p) function for the current frame
 	e_p(&frames_buf[0], e_p_arr0);
 
 	// Look-Back Pitch Tracking
@@ -226,23 +226,34 @@ void imbe_vocoder_impl::pitch_est(IMBE_PARAM *imbe_param, Word16 *frames_buf)
 	}
 
 
-	// Look-Ahead Pitch Tracking
-	e_p(&frames_buf[FRAME],     e_p_arr1);
-	e_p(&frames_buf[2 * FRAME], e_p_arr2);
+	// Look-Ahead Pitch Tracking over depth future frames; a frame not yet
+	// available is taken to repeat the last one that is, so the costs keep
+	// their three-frame scale
+	Word16 *e_p_fut1 = e_p_arr0, *e_p_fut2 = e_p_arr0;
+	if(depth >= 1)
+	{
+		e_p(&frames_buf[FRAME], e_p_arr1);
+		e_p_fut1 = e_p_fut2 = e_p_arr1;
+	}
+	if(depth >= 2)
+	{
+		e_p(&frames_buf[2 * FRAME], e_p_arr2);
+		e_p_fut2 = e_p_arr2;
+	}
 
 	p0_est = p0 = 0;
-	cef_est = e_p_arr0[p0] + e_p_arr1[p0] + e_p_arr2[p0];
+	cef_est = e_p_arr0[p0] + e_p_fut1[p0] + e_p_fut2[p0];
 
             p1 = 0;
             while(p1 < 203)
             {
                         p2 = HI_BYTE(min_max_tbl[p1]);
                         p2_max_index = LO_BYTE(min_max_tbl[p1]);
-                        s_tmp = e_p_arr2[p1];
+                        s_tmp = e_p_fut2[p1];
                         while(p2 <= p2_max_index)
                         {
-                                   if(e_p_arr2[p2] < s_tmp)
-                                               s_tmp = e_p_arr2[p2];
+                                   if(e_p_fut2[p2] < s_tmp)
+                                               s_tmp = e_p_fut2[p2];
                                    p2++;
                         }
                         e_p_arr2_min[p1] = s_tmp;
@@ -250,13 +261,13 @@ void imbe_vocoder_impl::pitch_est(IMBE_PARAM *imbe_param, Word16 *frames_buf)
             }
             while(p0 < 203)
             {
-                        e1p1_e2p2_est = e_p_arr1[p0] + e_p_arr2_min[p0];
+                        e1p1_e2p2_est = e_p_fut1[p0] + e_p_arr2_min[p0];
                         p1 = HI_BYTE(min_max_tbl[p0]);
                         p1_max_index = LO_BYTE(min_max_tbl[p0]);
                         while(p1 <= p1_max_index)
                         {
-                                   if(add(e_p_arr1[p1], e_p_arr2_min[p1]) < e1p1_e2p2_est)
-                                               e1p1_e2p2_est = add(e_p_arr1[p1], e_p_arr2_min[p1]);
+                                   if(add(e_p_fut1[p1], e_p_arr2_min[p1]) < e1p1_e2p2_est)
+                                               e1p1_e2p2_est = add(e_p_fut1[p1], e_p_arr2_min[p1]);
                                    p1++;
                         }
                         e1p1_e2p2_est_save[p0] = e1p1_e2p2_est;
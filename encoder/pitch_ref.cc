@@ -41,7 +41,7 @@
 
 
 
-void pitch_ref(IMBE_PARAM *imbe_param, Cmplx16 *fft_buf)
+void pitch_ref(IMBE_PARAM *imbe_param, Cmplx16 *fft_buf, Word16 num_cands)
 {
 	Word16 i, j, index_a_save, pitch_est, tmp, shift, index_wr, up_lim;
 	Cmplx16 sp_rec[FFTLENGTH/2];
@@ -51,10 +51,10 @@ void pitch_ref(IMBE_PARAM *imbe_param, Cmplx16 *fft_buf)
 
 
 	pitch_est = shl(imbe_param->pitch, 7);                      // Convert to Q8.8
-	pitch_est = sub(pitch_est, CNST_1_125_Q8_8);                // Sub 1.125 = 9/8
+	pitch_est = sub(pitch_est, (num_cands >> 1) * CNST_0_125_Q8_8); // Sub 1.125 = 9/8 for 19 candidates
 
 	L_diff_min = MAX_32;
-	for(i = 0; i < 19; i++)
+	for(i = 0; i < num_cands; i++)
 	{
 		shift = norm_s(pitch_est);
 		tmp = shl(pitch_est, shift);
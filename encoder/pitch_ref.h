@@ -23,6 +23,9 @@
 #ifndef _PITCH_REF
 #define _PITCH_REF
 
-void pitch_ref(IMBE_PARAM *imbe_param, Cmplx16 *fft_buf);
+// Refinement candidates, 1/8 sample apart and centred on the estimate
+#define PITCH_REF_CANDS  19
+
+void pitch_ref(IMBE_PARAM *imbe_param, Cmplx16 *fft_buf, Word16 num_cands);
 
 #endif
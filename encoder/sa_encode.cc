@@ -44,29 +44,24 @@ void imbe_vocoder_impl::sa_encode_init(void)
 		sa_prev2[i] = 0;
 }
 
-void imbe_vocoder_impl::sa_encode(IMBE_PARAM *imbe_param)
+//-----------------------------------------------------------------------------
+//	PURPOSE:
+//		Calculate num_harms_prev/num_harms in unsigned Q8.24 format
+//-----------------------------------------------------------------------------
+static UWord32 sa_interp_coef(Word16 num_harms, Word16 num_harms_prev)
 {
-	Word16 gain_vec[6], gain_r[6];
-	UWord16 index, i, j, num_harms;
-	Word16 *ba_ptr, *t_vec_ptr, *b_vec_ptr, *gss_ptr, *sa_ptr;
-	Word16 t_vec[NUM_HARMS_MAX], c_vec[MAX_BLOCK_LEN];
-	UWord32 lmprbl_item;
-	Word16 bl_len, step_size, num_bits, tmp, ro_coef, si_coef, tmp1;
-	UWord32 k_coef, k_acc;
-	Word32 sum, tmp_word32, vec32_tmp[NUM_HARMS_MAX], *vec32_ptr;
-
-	num_harms = imbe_param->num_harms;
+	UWord32 k_coef;
+	Word16 tmp;
 
-	// Calculate num_harms_prev2/num_harms. Result save in unsigned format Q8.24
-	if(num_harms == num_harms_prev2)
+	if(num_harms == num_harms_prev)
 		k_coef = (Word32)CNST_ONE_Q8_24;
-	else if(num_harms > num_harms_prev2)
-		k_coef = (Word32)div_s(num_harms_prev2 << 9, num_harms << 9) << 9;
+	else if(num_harms > num_harms_prev)
+		k_coef = (Word32)div_s(num_harms_prev << 9, num_harms << 9) << 9;
 	else
 	{
-		// imbe_param->num_harms < num_harms_prev2
+		// num_harms < num_harms_prev
 		k_coef = 0;
-		tmp = num_harms_prev2;
+		tmp = num_harms_prev;
 		while(tmp > num_harms)
 		{
 			tmp -= num_harms;
@@ -75,13 +70,66 @@ void imbe_vocoder_impl::sa_encode(IMBE_PARAM *imbe_param)
 		k_coef += (Word32)div_s(tmp << 9, num_harms << 9) << 9;
 	}
 
-    // Calculate prediction coefficient
+	return k_coef;
+}
+
+//-----------------------------------------------------------------------------
+//	PURPOSE:
+//		Calculate prediction coefficient
+//-----------------------------------------------------------------------------
+static Word16 sa_pred_coef(Word16 num_harms)
+{
 	if(num_harms <= 15)
-		ro_coef = CNST_0_4_Q1_15;
+		return CNST_0_4_Q1_15;
 	else if(num_harms <= 24)
-		ro_coef = num_harms * CNST_0_03_Q1_15 - CNST_0_05_Q1_15;
+		return num_harms * CNST_0_03_Q1_15 - CNST_0_05_Q1_15;
 	else
-		ro_coef = CNST_0_7_Q1_15;
+		return CNST_0_7_Q1_15;
+}
+
+void imbe_vocoder_impl::sa_decode_init(void)
+{
+	Word16 i;
+	num_harms_dec_prev = 30;
+	for(i = 0; i < NUM_HARMS_MAX + 2; i++)
+		sa_dec_prev[i] = 0;
+}
+
+//-----------------------------------------------------------------------------
+//	PURPOSE:
+//		Reconstruct spectral amplitudes (Q14.2) from a received b_vec
+//-----------------------------------------------------------------------------
+void imbe_vocoder_impl::sa_decode(IMBE_PARAM *imbe_param)
+{
+	Word16 i, tmp;
+
+	sa_reconstruct(imbe_param, sa_dec_prev, &num_harms_dec_prev);
+
+	for(i = 0; i < imbe_param->num_harms; i++)
+	{
+		tmp = Pow2(sa_dec_prev[i + 1]);
+		imbe_param->sa[i] = (tmp > 0)?tmp:1;
+	}
+}
+
+void imbe_vocoder_impl::sa_encode(IMBE_PARAM *imbe_param)
+{
+	Word16 gain_vec[6], gain_r[6];
+	UWord16 index, i, j, num_harms;
+	Word16 *ba_ptr, *t_vec_ptr, *b_vec_ptr, *gss_ptr, *sa_ptr;
+	Word16 t_vec[NUM_HARMS_MAX], c_vec[MAX_BLOCK_LEN];
+	UWord32 lmprbl_item;
+	Word16 bl_len, step_size, num_bits, tmp, ro_coef, si_coef, tmp1;
+	UWord32 k_coef, k_acc;
+	Word32 sum, tmp_word32, vec32_tmp[NUM_HARMS_MAX], *vec32_ptr;
+
+	num_harms = imbe_param->num_harms;
+
+	// Calculate num_harms_prev2/num_harms. Result save in unsigned format Q8.24
+	k_coef = sa_interp_coef(num_harms, num_harms_prev2);
+
+    // Calculate prediction coefficient
+	ro_coef = sa_pred_coef(num_harms);
 
 	for(i = num_harms_prev2 + 1; i < NUM_HARMS_MAX + 2; i++)
 		sa_prev2[i] = sa_prev2[num_harms_prev2];
@@ -192,7 +240,56 @@ void imbe_vocoder_impl::sa_encode(IMBE_PARAM *imbe_param)
 	printf("\n");
 */
 
+	sa_reconstruct(imbe_param, sa_prev2, &num_harms_prev2);
+}
+
+//-----------------------------------------------------------------------------
+//	PURPOSE:
+//		Decode the T vector from b_vec and reconstruct the log2 spectral
+//		amplitudes into sa_prev (Q10.22), updating the predictor state.
+//		Shared by the encoder's closed-loop update and by sa_decode.
+//-----------------------------------------------------------------------------
+void imbe_vocoder_impl::sa_reconstruct(IMBE_PARAM *imbe_param, Word32 *sa_prev, Word16 *num_harms_prev)
+{
+	Word16 gain_vec[6], gain_r[6];
+	UWord16 index, i, j, num_harms;
+	Word16 *ba_ptr, *t_vec_ptr, *b_vec_ptr, *gss_ptr;
+	Word16 t_vec[NUM_HARMS_MAX], c_vec[MAX_BLOCK_LEN];
+	UWord32 lmprbl_item;
+	Word16 bl_len, step_size, num_bits, ro_coef, si_coef, tmp, tmp1;
+	UWord32 k_coef, k_acc;
+	Word32 sum, tmp_word32, vec32_tmp[NUM_HARMS_MAX], *vec32_ptr;
+
+	num_harms = imbe_param->num_harms;
+	index     = num_harms - NUM_HARMS_MIN;
+	k_coef    = sa_interp_coef(num_harms, *num_harms_prev);
+	ro_coef   = sa_pred_coef(num_harms);
 
+	for(i = *num_harms_prev + 1; i < NUM_HARMS_MAX + 2; i++)
+		sa_prev[i] = sa_prev[*num_harms_prev];
+
+	// Mean of the interpolated prediction, as in the encoder
+	k_acc = k_coef;
+	sum   = 0;
+	for(i = 0; i < num_harms; i++)
+	{
+		j       = (UWord16)(k_acc >> 24);
+		si_coef = (Word16)((k_acc - ((UWord32)j << 24)) >> 9);
+
+		if(si_coef == 0)
+			sum = L_add(sum, sa_prev[j]);
+		else
+		{
+			sum = L_add(sum, L_mpy_ls(sa_prev[j], sub(0x7FFF, si_coef)));
+			sum = L_add(sum, L_mpy_ls(sa_prev[j + 1], si_coef));
+		}
+
+		k_acc += k_coef;
+	}
+
+	imbe_param->div_one_by_num_harm_sh = tmp = norm_s(num_harms);
+	imbe_param->div_one_by_num_harm = tmp1 = div_s(0x4000, num_harms << tmp);
+	sum = L_shr(L_mpy_ls(L_mpy_ls(sum, ro_coef), tmp1), (14 - tmp));
 
 	//////////////////////////////////////////////
 	//
@@ -262,9 +359,6 @@ void imbe_vocoder_impl::sa_encode(IMBE_PARAM *imbe_param)
 	k_acc = k_coef;
 	vec32_ptr = vec32_tmp;
 
-	for(i = num_harms_prev2 + 1; i < NUM_HARMS_MAX + 2; i++)
-		sa_prev2[i] = sa_prev2[num_harms_prev2];
-
 	for(i = 0; i < num_harms; i++)
 	{
 		index   = (UWord16)(k_acc >> 24);                    // Get integer part
@@ -272,15 +366,15 @@ void imbe_vocoder_impl::sa_encode(IMBE_PARAM *imbe_param)
 
 		if(si_coef == 0)
 		{
-			tmp_word32 = L_mpy_ls(sa_prev2[index], ro_coef);                        // sa_prev2 here is in Q10.22 format
+			tmp_word32 = L_mpy_ls(sa_prev[index], ro_coef);                         // sa_prev here is in Q10.22 format
 			*vec32_ptr++ = L_add(L_shr(L_deposit_h(t_vec[i]), 5), tmp_word32);     // Convert t_vec to Q10.22 and add ...
 		}
 		else
 		{
-			tmp_word32 = L_mpy_ls(sa_prev2[index], sub(0x7FFF, si_coef));
+			tmp_word32 = L_mpy_ls(sa_prev[index], sub(0x7FFF, si_coef));
 			*vec32_ptr  = L_add(L_shr(L_deposit_h(t_vec[i]), 5), L_mpy_ls(tmp_word32, ro_coef));
 
-			tmp_word32 = L_mpy_ls(sa_prev2[index + 1], si_coef);
+			tmp_word32 = L_mpy_ls(sa_prev[index + 1], si_coef);
 			*vec32_ptr = L_add(*vec32_ptr, L_mpy_ls(tmp_word32, ro_coef));
 
 			vec32_ptr++;
@@ -290,7 +384,7 @@ void imbe_vocoder_impl::sa_encode(IMBE_PARAM *imbe_param)
 	}
 
 	for(i = 1; i <= num_harms; i++)
-		sa_prev2[i] = L_sub(vec32_tmp[i - 1], sum);
+		sa_prev[i] = L_sub(vec32_tmp[i - 1], sum);
 
-	num_harms_prev2 = num_harms;
+	*num_harms_prev = num_harms;
 }
@@ -95,6 +95,62 @@ Word16 imbe_vocoder_impl::unvoiced_sa_calc(Word32 num, Word16 den)
 	return extract_h(L_tmp);
 }
 
+//-----------------------------------------------------------------------------
+//	PURPOSE:
+//		Derive the number of harmonics and V/UV bands from ref_pitch
+//-----------------------------------------------------------------------------
+void get_num_harms(IMBE_PARAM *imbe_param)
+{
+	Word16 tmp, num_harms, num_bands;
+
+	tmp = shr( add( shr(imbe_param->ref_pitch, 1),  CNST_0_25_Q8_8), 8);     // fix(pitch_cand / 2 + 0.5)
+	num_harms = extract_h((UWord32)CNST_0_9254_Q0_16 * tmp);                 // fix(0.9254 * fix(pitch_cand / 2 + 0.5))
+	if(num_harms < NUM_HARMS_MIN)
+		num_harms = NUM_HARMS_MIN;
+	else if(num_harms > NUM_HARMS_MAX)
+		num_harms = NUM_HARMS_MAX;
+
+	if(num_harms <= 36)
+		num_bands = extract_h((UWord32)(num_harms + 2) * CNST_0_33_Q0_16);   // fix((L+2)/3)
+	else
+		num_bands = NUM_BANDS_MAX;
+
+	imbe_param->num_harms = num_harms;
+	imbe_param->num_bands = num_bands;
+}
+
+//-----------------------------------------------------------------------------
+//	PURPOSE:
+//		Collapse per-harmonic v_uv_dsn to one decision per band (majority of
+//		its harmonics) and write it back to every harmonic of the band.
+//		Sets b_vec[1] and l_uv. Requires num_harms and num_bands.
+//-----------------------------------------------------------------------------
+void get_band_vuv(IMBE_PARAM *imbe_param)
+{
+	Word16 band, first, last, voiced, i;
+
+	imbe_param->b_vec[1] = 0;
+	imbe_param->l_uv = 0;
+	for(band = 0; band < imbe_param->num_bands; band++)
+	{
+		first = band * 3;
+		last  = (band == imbe_param->num_bands - 1)?imbe_param->num_harms:first + 3;
+
+		voiced = 0;
+		for(i = first; i < last; i++)
+			voiced += imbe_param->v_uv_dsn[i]?1:0;
+		voiced = (2 * voiced >= last - first)?1:0;
+
+		imbe_param->b_vec[1] = (imbe_param->b_vec[1] << 1) | voiced;
+		for(i = first; i < last; i++)
+		{
+			imbe_param->v_uv_dsn[i] = voiced;
+			if(!voiced)
+				imbe_param->l_uv++;
+		}
+	}
+}
+
 //=============================================================================
 //
 // Voiced/Unvoiced Determination & Spectral Amplitudes Estimation
@@ -114,20 +170,9 @@ void imbe_vocoder_impl::v_uv_det(IMBE_PARAM *imbe_param, Cmplx16 *fft_buf)
 
 	fund_freq = imbe_param->fund_freq;
 
-	tmp = shr( add( shr(imbe_param->ref_pitch, 1),  CNST_0_25_Q8_8), 8);     // fix(pitch_cand / 2 + 0.5)
-	num_harms = extract_h((UWord32)CNST_0_9254_Q0_16 * tmp);                 // fix(0.9254 * fix(pitch_cand / 2 + 0.5))
-	if(num_harms < NUM_HARMS_MIN)
-		num_harms = NUM_HARMS_MIN;
-	else if(num_harms > NUM_HARMS_MAX)
-		num_harms = NUM_HARMS_MAX;
-
-	if(num_harms <= 36)
-		num_bands = extract_h((UWord32)(num_harms + 2) * CNST_0_33_Q0_16);   // fix((L+2)/3)
-	else
-		num_bands = NUM_BANDS_MAX;
-
-	imbe_param->num_harms = num_harms;
-	imbe_param->num_bands = num_bands;
+	get_num_harms(imbe_param);
+	num_harms = imbe_param->num_harms;
+	num_bands = imbe_param->num_bands;
 
 	//=========================================================================
 	//
@@ -24,5 +24,7 @@
 #define _V_UV_DET
 
 void v_uv_det(IMBE_PARAM *imbe_param, Cmplx16 *fft_buf);
+void get_num_harms(IMBE_PARAM *imbe_param);
+void get_band_vuv(IMBE_PARAM *imbe_param);
 
 #endif
@@ -5,6 +5,7 @@
  */
 
 #include "opendmr.h"
+#include "opendmr_internal.h"
 #include <cstring>
 #include <cstdlib>
 #include <cmath>
@@ -13,6 +14,7 @@
 /* mbelib-neo for decoding */
 extern "C" {
 #include "mbelib.h"
+#include "pffft.h"
 }
 
 /* MBEEncoder for encoding */
@@ -38,6 +40,51 @@ static const char *version_string = "1.0.0";
 
 /* Golay FEC processing */
 #include "cgolay24128.h"
+#include "ambe_prng.h"
+
+/*
+ * ============================================================================
+ * Allocation
+ * ============================================================================
+ */
+
+static opendmr_alloc_fn alloc_hook = malloc;
+static opendmr_free_fn free_hook = free;
+
+void opendmr_set_allocator(opendmr_alloc_fn alloc_fn, opendmr_free_fn free_fn)
+{
+    if (alloc_fn && free_fn) {
+        alloc_hook = alloc_fn;
+        free_hook = free_fn;
+    } else {
+        alloc_hook = malloc;
+        free_hook = free;
+    }
+
+    /* PFFFT setups and aligned buffers (thread-local unvoiced FFT plan) */
+    pffft_set_allocator(alloc_hook, free_hook);
+}
+
+void opendmr_thread_release(void)
+{
+    mbe_releaseThreadPlans();
+}
+
+void *opendmr_mem_alloc(size_t size)
+{
+    return alloc_hook(size);
+}
+
+void opendmr_mem_free(void *ptr)
+{
+    if (ptr)
+        free_hook(ptr);
+}
+
+static bool is_aligned(const void *mem, size_t align)
+{
+    return (reinterpret_cast<uintptr_t>(mem) & (align - 1)) == 0;
+}
 
 /*
  * ============================================================================
@@ -49,52 +96,101 @@ struct opendmr_decoder {
     mbe_parms cur_mp;
     mbe_parms prev_mp;
     mbe_parms prev_mp_enhanced;
+
+    /* Unvoiced WOLA state deferred by opendmr_decode_params() */
+    bool state_pending;
+    float pending_noise[256];
+
+    /* Output resampler of opendmr_decode_rate() */
+    opendmr_resampler rs;
+
+    /* Native 16/48 kHz synthesis of opendmr_decode_rate() (rate 0 = not started) */
+    mbe_rate_state native;
+    bool filter_rate;           /* Resample 16/48 kHz instead */
 };
 
+size_t opendmr_decoder_size(void)
+{
+    return sizeof(opendmr_decoder_t);
+}
+
+size_t opendmr_decoder_align(void)
+{
+    return alignof(opendmr_decoder_t);
+}
+
+opendmr_decoder_t *opendmr_decoder_init(void *mem)
+{
+    if (!mem || !is_aligned(mem, alignof(opendmr_decoder_t)))
+        return nullptr;
+
+    memset(mem, 0, sizeof(opendmr_decoder_t));
+    opendmr_decoder_t *dec = static_cast<opendmr_decoder_t *>(mem);
+    mbe_initMbeParms(&dec->cur_mp, &dec->prev_mp, &dec->prev_mp_enhanced);
+    return dec;
+}
+
 opendmr_decoder_t *opendmr_decoder_create(void)
 {
-    opendmr_decoder_t *dec = static_cast<opendmr_decoder_t *>(calloc(1, sizeof(opendmr_decoder_t)));
-    if (dec) {
-        mbe_initMbeParms(&dec->cur_mp, &dec->prev_mp, &dec->prev_mp_enhanced);
-    }
+    void *mem = alloc_hook(sizeof(opendmr_decoder_t));
+    opendmr_decoder_t *dec = opendmr_decoder_init(mem);
+    if (!dec && mem)
+        free_hook(mem);
     return dec;
 }
 
 void opendmr_decoder_destroy(opendmr_decoder_t *dec)
 {
-    free(dec);
+    if (dec)
+        free_hook(dec);
 }
 
 void opendmr_decoder_reset(opendmr_decoder_t *dec)
 {
     if (dec) {
         mbe_initMbeParms(&dec->cur_mp, &dec->prev_mp, &dec->prev_mp_enhanced);
+        dec->state_pending = false;
+        opendmr_resampler_reset(&dec->rs);
+        memset(&dec->native, 0, sizeof(dec->native));
     }
 }
 
+void opendmr_decoder_set_native_rate(opendmr_decoder_t *dec, bool enable)
+{
+    if (dec)
+        dec->filter_rate = !enable;
+}
+
 /*
- * Compute PRNG mask for B-block descrambling.
- * Uses the same algorithm as mbelib's mbe_demodulateAmbe3600Data_common.
+ * Split a 72-bit frame (DVSI order) into its A (24), B (23) and C (25)
+ * bit blocks, MSB first. The first 64 bits are taken as one big-endian
+ * word and the blocks cut out with shifts.
  */
-static uint32_t compute_prng_mask_23bit(uint32_t aOrig)
+void opendmr_unpack_blocks(const uint8_t *frame72,
+                           uint32_t *a_out, uint32_t *b_out, uint32_t *c_out)
 {
-    uint16_t pr[24];
-    pr[0] = static_cast<uint16_t>(16U * aOrig);
+    uint64_t top = 0;
+    for (int i = 0; i < 8; i++)
+        top = (top << 8) | frame72[i];
 
-    for (int i = 1; i < 24; i++) {
-        pr[i] = static_cast<uint16_t>((173U * static_cast<uint32_t>(pr[i - 1]) + 13849U) % 65536U);
-    }
+    /* A: bits 0-23, B: bits 24-46, C: bits 47-71 */
+    *a_out = static_cast<uint32_t>(top >> 40);
+    *b_out = static_cast<uint32_t>(top >> 17) & 0x7FFFFFU;
+    *c_out = (static_cast<uint32_t>(top & 0x1FFFFU) << 8) | frame72[8];
+}
 
-    for (int i = 1; i < 24; i++) {
-        pr[i] = pr[i] / 32768U;
-    }
+/*
+ * Assemble a 72-bit frame (DVSI order) from its A, B and C bit blocks.
+ */
+void opendmr_pack_blocks(uint32_t a, uint32_t b, uint32_t c, uint8_t *frame72)
+{
+    uint64_t top = (static_cast<uint64_t>(a & 0xFFFFFFU) << 40) |
+                   (static_cast<uint64_t>(b & 0x7FFFFFU) << 17) |
+                   ((c & 0x1FFFFFFU) >> 8);
 
-    uint32_t mask = 0;
-    for (int i = 1; i <= 23; i++) {
-        if (pr[i])
-            mask |= (1U << (23 - i));
-    }
-    return mask;
+    for (int i = 0; i < 8; i++)
+        frame72[i] = static_cast<uint8_t>(top >> (56 - 8 * i));
+    frame72[8] = static_cast<uint8_t>(c);
 }
 
 /*
@@ -105,90 +201,472 @@ static uint32_t compute_prng_mask_23bit(uint32_t aOrig)
  *   - Bits 24-46: B block (Golay 23,12 + PRNG scrambled)
  *   - Bits 47-71: C block (raw: 11-bit C2 + 14-bit C3)
  *
- * Output format (mbelib ambe_d):
- *   - ambe_d[0-11]:  C0 data (12 bits from A)
- *   - ambe_d[12-23]: C1 data (12 bits from B)
- *   - ambe_d[24-34]: C2 data (11 bits)
- *   - ambe_d[35-48]: C3 data (14 bits)
+ * Output format (mbelib packed parameter word, ambe_d[0] in bit 48):
+ *   - Bits 48-37: C0 data (12 bits from A)
+ *   - Bits 36-25: C1 data (12 bits from B)
+ *   - Bits 24-14: C2 data (11 bits)
+ *   - Bits 13-0:  C3 data (14 bits)
  */
-static void decode_ambe_frame(const uint8_t *frame72, char ambe_d[49])
-{
-    /* Extract A block - bits 0-23 */
-    uint32_t a = 0;
-    for (int i = 0; i < 24; i++) {
-        int byte_idx = i / 8;
-        int bit_pos = 7 - (i % 8);
-        if ((frame72[byte_idx] >> bit_pos) & 1)
-            a |= (0x800000U >> i);
-    }
-
-    /* Extract B block - bits 24-46 */
-    uint32_t b = 0;
-    for (int i = 0; i < 23; i++) {
-        int pos = 24 + i;
-        int byte_idx = pos / 8;
-        int bit_pos = 7 - (pos % 8);
-        if ((frame72[byte_idx] >> bit_pos) & 1)
-            b |= (0x400000U >> i);
-    }
-
-    /* Extract C block - bits 47-71 */
-    uint32_t c = 0;
-    for (int i = 0; i < 25; i++) {
-        int pos = 47 + i;
-        int byte_idx = pos / 8;
-        int bit_pos = 7 - (pos % 8);
-        if ((frame72[byte_idx] >> bit_pos) & 1)
-            c |= (0x1000000U >> i);
-    }
+static uint64_t decode_ambe_frame(const uint8_t *frame72, int *errs_a, int *errs_b)
+{
+    uint32_t a, b, c;
+    opendmr_unpack_blocks(frame72, &a, &b, &c);
 
     /* Golay decode A to get 12-bit C0 data */
-    uint32_t aOrig = CGolay24128::decode24128(a);
+    unsigned int a_errs = 0;
+    uint32_t aOrig = CGolay24128::decode24128(a, a_errs);
 
     /* Descramble B with PRNG, then Golay decode to get 12-bit C1 data */
-    uint32_t prng_mask = compute_prng_mask_23bit(aOrig);
+    unsigned int b_errs = 0;
+    uint32_t prng_mask = ambe_prng_mask(aOrig);
     uint32_t b_descrambled = b ^ prng_mask;
-    uint32_t bOrig = CGolay24128::decode23127(b_descrambled);
+    uint32_t bOrig = CGolay24128::decode23127(b_descrambled, b_errs);
+
+    *errs_a = static_cast<int>(a_errs);
+    *errs_b = static_cast<int>(b_errs);
+
+    return (static_cast<uint64_t>(aOrig & 0xFFFU) << 37) |
+           (static_cast<uint64_t>(bOrig & 0xFFFU) << 25) | c;
+}
+
+/*
+ * Bring the unvoiced WOLA state of the last parameter-only frame up to
+ * date, so synthesis continues exactly as if that frame had been rendered.
+ */
+static void complete_pending_state(opendmr_decoder_t *dec)
+{
+    if (dec->state_pending) {
+        mbe_completeSpeechState(&dec->prev_mp_enhanced, dec->pending_noise);
+        memcpy(dec->cur_mp.previousUw, dec->prev_mp_enhanced.previousUw,
+               sizeof(dec->cur_mp.previousUw));
+        dec->state_pending = false;
+    }
+}
+
+/*
+ * Classify a processed frame from mbelib's error string and the pitch
+ * index b0 (b0 124/125 are silence frames).
+ */
+static opendmr_frame_class_t classify_frame(const char *err_str, uint64_t ambe_u)
+{
+    if (strchr(err_str, 'M'))
+        return OPENDMR_FRAME_MUTED;
+    if (strchr(err_str, 'R'))
+        return OPENDMR_FRAME_REPEAT;
+    if (strchr(err_str, 'E'))
+        return OPENDMR_FRAME_ERASURE;
+    if (strchr(err_str, 'T'))
+        return OPENDMR_FRAME_TONE;
+
+    int b[9];
+    mbe_unpackAmbe2450Fields(ambe_u, b);
+    if (b[0] == 124 || b[0] == 125)
+        return OPENDMR_FRAME_SILENCE;
+
+    return OPENDMR_FRAME_VOICE;
+}
+
+/*
+ * Decode one frame to mbelib's native float scale (before the x8 output
+ * gain and clipping applied by mbe_floattoshort).
+ *
+ * Error counts follow mbelib's convention: errs = C0 (A block) errors,
+ * errs2 = C0 + C1 errors. errs2 > 3 makes mbelib repeat the previous
+ * frame's parameters. The reported count is the total.
+ *
+ * Returns true if the frame was not synthesised and buf holds silence
+ * (erasure, rejected tone or muted frame), so the caller can skip output
+ * conversion.
+ */
+static bool decode_frame_float(opendmr_decoder_t *dec,
+                               const uint8_t *ambe,
+                               float buf[OPENDMR_PCM_SAMPLES],
+                               opendmr_frame_info_t *info)
+{
+    /* Decode 72-bit frame to 49-bit voice parameters */
+    int errs_a, errs_b;
+    uint64_t ambe_u = decode_ambe_frame(ambe, &errs_a, &errs_b);
+
+    complete_pending_state(dec);
+
+    /* Decode voice parameters to audio using mbelib */
+    int err_count = errs_a;
+    int err_count2 = errs_a + errs_b;
+    char err_str[64] = {0};
+
+    int state = mbe_processAmbe2450PackedDataf(buf, &err_count, &err_count2, err_str,
+                                               ambe_u, &dec->cur_mp, &dec->prev_mp,
+                                               &dec->prev_mp_enhanced, 3);
+    bool silent = (state == MBE_STATE_RESET);
+
+    if (info) {
+        info->errs = err_count2;
+        info->frame_class = classify_frame(err_str, ambe_u);
+        info->silent = silent;
+    }
+
+    return silent;
+}
 
-    /* Populate ambe_d in mbelib format */
-    memset(ambe_d, 0, 49);
+/*
+ * Conceal a lost frame to mbelib's native float scale; as
+ * decode_frame_float(), returns true if buf holds silence.
+ */
+static bool conceal_frame_float(opendmr_decoder_t *dec,
+                                float buf[OPENDMR_PCM_SAMPLES],
+                                opendmr_frame_info_t *info)
+{
+    complete_pending_state(dec);
 
-    /* ambe_d[0-11] = C0 data (aOrig, MSB first) */
-    for (int i = 0; i < 12; i++)
-        ambe_d[i] = (aOrig >> (11 - i)) & 1;
+    char err_str[64] = {0};
+    int state = mbe_processAmbe2450Lostf(buf, err_str, &dec->cur_mp, &dec->prev_mp,
+                                         &dec->prev_mp_enhanced, 3);
+    bool silent = (state == MBE_STATE_RESET);
 
-    /* ambe_d[12-23] = C1 data (bOrig, MSB first) */
-    for (int i = 0; i < 12; i++)
-        ambe_d[12 + i] = (bOrig >> (11 - i)) & 1;
+    if (info) {
+        info->errs = 0;
+        info->frame_class = classify_frame(err_str, 0);
+        info->silent = silent;
+    }
 
-    /* ambe_d[24-48] = C2 + C3 (from c, MSB first) */
-    for (int i = 0; i < 25; i++)
-        ambe_d[24 + i] = (c >> (24 - i)) & 1;
+    return silent;
 }
 
 bool opendmr_decode(opendmr_decoder_t *dec,
                     const uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES],
                     int16_t pcm[OPENDMR_PCM_SAMPLES],
                     int *errs)
+{
+    opendmr_frame_info_t info;
+
+    if (!opendmr_decode_ex(dec, ambe, pcm, &info))
+        return false;
+
+    if (errs)
+        *errs = info.errs;
+
+    return true;
+}
+
+bool opendmr_decode_ex(opendmr_decoder_t *dec,
+                       const uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES],
+                       int16_t pcm[OPENDMR_PCM_SAMPLES],
+                       opendmr_frame_info_t *info)
 {
     if (!dec || !ambe || !pcm)
         return false;
 
-    /* Decode 72-bit frame to 49-bit voice parameters */
-    char ambe_d[49];
-    decode_ambe_frame(ambe, ambe_d);
+    float buf[OPENDMR_PCM_SAMPLES];
+    if (decode_frame_float(dec, ambe, buf, info)) {
+        memset(pcm, 0, OPENDMR_PCM_SAMPLES * sizeof(int16_t));
+        return true;
+    }
 
-    /* Decode voice parameters to PCM using mbelib */
-    int err_count = 0;
-    int err_count2 = 0;
-    char err_str[64] = {0};
+    /* Scale, clip and convert to 16-bit */
+    mbe_floattoshort(buf, pcm);
+
+    return true;
+}
+
+bool opendmr_decode_lost(opendmr_decoder_t *dec,
+                         int16_t pcm[OPENDMR_PCM_SAMPLES],
+                         opendmr_frame_info_t *info)
+{
+    if (!dec || !pcm)
+        return false;
+
+    float buf[OPENDMR_PCM_SAMPLES];
+    if (conceal_frame_float(dec, buf, info)) {
+        memset(pcm, 0, OPENDMR_PCM_SAMPLES * sizeof(int16_t));
+        return true;
+    }
 
-    mbe_processAmbe2450Data(pcm, &err_count, &err_count2, err_str,
-                            ambe_d, &dec->cur_mp, &dec->prev_mp,
-                            &dec->prev_mp_enhanced, 3);
+    mbe_floattoshort(buf, pcm);
+
+    return true;
+}
+
+bool opendmr_decode_f32(opendmr_decoder_t *dec,
+                        const uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES],
+                        float pcm[OPENDMR_PCM_SAMPLES],
+                        int *errs)
+{
+    opendmr_frame_info_t info;
+
+    if (!opendmr_decode_f32_ex(dec, ambe, pcm, &info))
+        return false;
 
     if (errs)
-        *errs = err_count;
+        *errs = info.errs;
+
+    return true;
+}
+
+bool opendmr_decode_f32_ex(opendmr_decoder_t *dec,
+                           const uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES],
+                           float pcm[OPENDMR_PCM_SAMPLES],
+                           opendmr_frame_info_t *info)
+{
+    if (!dec || !ambe || !pcm)
+        return false;
+
+    /* Silent frames are already zero at any scale */
+    if (decode_frame_float(dec, ambe, pcm, info))
+        return true;
+
+    /* Same output gain as the 16-bit path, normalised to full scale 1.0 */
+    const float scale = 8.0f / 32768.0f;
+    for (int i = 0; i < OPENDMR_PCM_SAMPLES; i++)
+        pcm[i] *= scale;
+
+    return true;
+}
+
+/*
+ * Decode one frame straight to rate times 8 kHz, at mbelib's float scale.
+ * Returns true if the frame was not synthesised and buf holds silence.
+ */
+static bool decode_frame_native(opendmr_decoder_t *dec,
+                                const uint8_t *ambe,
+                                int rate, float *buf,
+                                opendmr_frame_info_t *info)
+{
+    int errs_a, errs_b;
+    uint64_t ambe_u = decode_ambe_frame(ambe, &errs_a, &errs_b);
+
+    /* Parameter-only frames do not advance the native unvoiced history,
+     * so it restarts rather than overlapping a stale frame */
+    if (dec->native.rate != rate || dec->state_pending)
+        mbe_initRateState(&dec->native, rate);
+    complete_pending_state(dec);
+
+    int err_count = errs_a;
+    int err_count2 = errs_a + errs_b;
+    char err_str[64] = {0};
+
+    int state = mbe_processAmbe2450PackedDataRatef(buf, &dec->native, &err_count, &err_count2,
+                                                   err_str, ambe_u, &dec->cur_mp, &dec->prev_mp,
+                                                   &dec->prev_mp_enhanced);
+    bool silent = (state == MBE_STATE_RESET);
+
+    if (info) {
+        info->errs = err_count2;
+        info->frame_class = classify_frame(err_str, ambe_u);
+        info->silent = silent;
+    }
+
+    return silent;
+}
+
+/* Output rates synthesised natively, as a multiple of 8 kHz (0 = resampled) */
+static int native_rate(const opendmr_decoder_t *dec, unsigned int rate)
+{
+    if (dec->filter_rate || (rate != 16000 && rate != 48000))
+        return 0;
+    return static_cast<int>(rate / OPENDMR_SAMPLE_RATE);
+}
+
+bool opendmr_decode_rate(opendmr_decoder_t *dec,
+                         const uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES],
+                         int16_t *pcm, unsigned int rate,
+                         opendmr_frame_info_t *info)
+{
+    if (rate == OPENDMR_SAMPLE_RATE)
+        return opendmr_decode_ex(dec, ambe, pcm, info);
+
+    if (!dec || !ambe || !pcm || opendmr_rate_samples(rate) == 0)
+        return false;
+
+    int native = native_rate(dec, rate);
+    if (native) {
+        float buf[OPENDMR_MAX_RATE_SAMPLES];
+        if (decode_frame_native(dec, ambe, native, buf, info)) {
+            memset(pcm, 0, OPENDMR_PCM_SAMPLES * native * sizeof(int16_t));
+            return true;
+        }
+
+        /* mbe_floattoshort() converts 160 samples at a time */
+        for (int i = 0; i < native; i++)
+            mbe_floattoshort(buf + i * OPENDMR_PCM_SAMPLES, pcm + i * OPENDMR_PCM_SAMPLES);
+        return true;
+    }
+
+    /* Silent frames still run through the filter to flush its history */
+    float buf[OPENDMR_PCM_SAMPLES];
+    decode_frame_float(dec, ambe, buf, info);
+
+    /* Same output gain as mbe_floattoshort(), applied by the resampler */
+    return opendmr_resample_up(&dec->rs, rate, buf, 8.0f, pcm);
+}
+
+bool opendmr_decode_g711(opendmr_decoder_t *dec,
+                         const uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES],
+                         uint8_t g711[OPENDMR_PCM_SAMPLES],
+                         opendmr_g711_law_t law,
+                         opendmr_frame_info_t *info)
+{
+    if (!dec || !ambe || !g711 || !opendmr_g711_expand_table(law))
+        return false;
+
+    /* Silent frames are zero, which compresses to the law's zero code */
+    float buf[OPENDMR_PCM_SAMPLES];
+    decode_frame_float(dec, ambe, buf, info);
+
+    /* Scale, clip and compress in one pass, as mbe_floattoshort() */
+    opendmr_g711_compress(buf, 8.0f, law, g711);
+
+    return true;
+}
+
+bool opendmr_decode_params(opendmr_decoder_t *dec,
+                           const uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES],
+                           opendmr_params_t *params)
+{
+    if (!dec || !ambe || !params)
+        return false;
+
+    int errs_a, errs_b;
+    uint64_t ambe_u = decode_ambe_frame(ambe, &errs_a, &errs_b);
+
+    int err_count = errs_a;
+    int err_count2 = errs_a + errs_b;
+    char err_str[64] = {0};
+
+    /* Advance state without synthesis; the unvoiced FFT is deferred */
+    int state = mbe_processAmbe2450PackedParmsf(&err_count, &err_count2, err_str,
+                                                ambe_u, &dec->cur_mp, &dec->prev_mp,
+                                                &dec->prev_mp_enhanced,
+                                                dec->pending_noise);
+    if (state == MBE_STATE_DEFERRED)
+        dec->state_pending = true;
+    else if (state == MBE_STATE_RESET)
+        dec->state_pending = false;
+
+    memset(params, 0, sizeof(*params));
+    params->errs = err_count2;
+    params->frame_class = classify_frame(err_str, ambe_u);
+
+    switch (params->frame_class) {
+    case OPENDMR_FRAME_VOICE:
+    case OPENDMR_FRAME_SILENCE:
+    case OPENDMR_FRAME_REPEAT: {
+        const mbe_parms *mp = &dec->prev_mp_enhanced;
+        int L = mp->L;
+        if (L > OPENDMR_MAX_BANDS)
+            L = OPENDMR_MAX_BANDS;
+        params->w0 = mp->w0;
+        params->L = L;
+        params->gain = mp->gamma;
+        for (int l = 1; l <= L; l++) {
+            if (mp->Vl[l])
+                params->vuv |= (UINT64_C(1) << (l - 1));
+            params->log2_ml[l - 1] = mp->log2Ml[l];
+        }
+        break;
+    }
+    default:
+        /* Erasure, tone and muted frames carry no voice parameters */
+        break;
+    }
+
+    return true;
+}
+
+/*
+ * ============================================================================
+ * Dual-Timeslot Decoder
+ * ============================================================================
+ */
+
+struct opendmr_dual_decoder {
+    opendmr_decoder_t slot[OPENDMR_SLOTS];
+};
+
+/* Output gain, clip and truncation of mbe_floattoshort() */
+static inline int16_t output_sample(float v)
+{
+    return opendmr_clip_sample(v * 8.0f);
+}
+
+static bool valid_slot(int slot)
+{
+    return slot >= 0 && slot < OPENDMR_SLOTS;
+}
+
+opendmr_dual_decoder_t *opendmr_dual_decoder_create(void)
+{
+    opendmr_dual_decoder_t *dd = static_cast<opendmr_dual_decoder_t *>(
+        alloc_hook(sizeof(opendmr_dual_decoder_t)));
+    if (!dd)
+        return nullptr;
+
+    for (int k = 0; k < OPENDMR_SLOTS; k++) {
+        if (!opendmr_decoder_init(&dd->slot[k])) {
+            free_hook(dd);
+            return nullptr;
+        }
+    }
+    return dd;
+}
+
+void opendmr_dual_decoder_destroy(opendmr_dual_decoder_t *dd)
+{
+    if (dd)
+        free_hook(dd);
+}
+
+void opendmr_dual_decoder_reset(opendmr_dual_decoder_t *dd, int slot)
+{
+    if (dd && valid_slot(slot))
+        opendmr_decoder_reset(&dd->slot[slot]);
+}
+
+opendmr_decoder_t *opendmr_dual_decoder_slot(opendmr_dual_decoder_t *dd, int slot)
+{
+    if (!dd || !valid_slot(slot))
+        return nullptr;
+    return &dd->slot[slot];
+}
+
+bool opendmr_dual_decode(opendmr_dual_decoder_t *dd, int slot,
+                         const uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES],
+                         int16_t *pcm, size_t stride,
+                         opendmr_frame_info_t *info)
+{
+    if (!dd || !valid_slot(slot) || !ambe || !pcm || stride < 1)
+        return false;
+
+    /* Silent frames come back zeroed, so they take the same path */
+    float buf[OPENDMR_PCM_SAMPLES];
+    decode_frame_float(&dd->slot[slot], ambe, buf, info);
+
+    for (int n = 0; n < OPENDMR_PCM_SAMPLES; n++)
+        pcm[n * stride] = output_sample(buf[n]);
+
+    return true;
+}
+
+bool opendmr_dual_decode_pair(opendmr_dual_decoder_t *dd,
+                              const uint8_t *const ambe[OPENDMR_SLOTS],
+                              int16_t *pcm, size_t stride,
+                              opendmr_frame_info_t info[OPENDMR_SLOTS])
+{
+    if (!dd || !ambe || !pcm || stride < OPENDMR_SLOTS)
+        return false;
+
+    /* Synthesise both slots, then interleave them in a single pass */
+    float buf[OPENDMR_SLOTS][OPENDMR_PCM_SAMPLES];
+    for (int k = 0; k < OPENDMR_SLOTS; k++) {
+        if (ambe[k])
+            decode_frame_float(&dd->slot[k], ambe[k], buf[k], info ? &info[k] : nullptr);
+        else
+            memset(buf[k], 0, sizeof(buf[k]));
+    }
+
+    for (int n = 0; n < OPENDMR_PCM_SAMPLES; n++) {
+        pcm[n * stride] = output_sample(buf[0][n]);
+        pcm[n * stride + 1] = output_sample(buf[1][n]);
+    }
 
     return true;
 }
@@ -200,149 +678,352 @@ bool opendmr_decode(opendmr_decoder_t *dec,
  */
 
 struct opendmr_encoder {
-    MBEEncoder *enc;
+    MBEEncoder enc;
     int gain_db;
+    opendmr_latency_t latency;
+    opendmr_complexity_t complexity;
+    bool dtx;
+
+    /* Input resampler of opendmr_encode_rate() */
+    opendmr_resampler rs;
 };
 
+size_t opendmr_encoder_size(void)
+{
+    return sizeof(opendmr_encoder_t);
+}
+
+size_t opendmr_encoder_align(void)
+{
+    return alignof(opendmr_encoder_t);
+}
+
+opendmr_encoder_t *opendmr_encoder_init(void *mem)
+{
+    if (!mem || !is_aligned(mem, alignof(opendmr_encoder_t)))
+        return nullptr;
+
+    opendmr_encoder_t *enc = new (mem) opendmr_encoder_t();
+    enc->enc.set_dmr_mode();    /* AMBE+2 mode */
+    enc->enc.set_gain_adjust(1.0f);
+    enc->gain_db = 0;
+    enc->latency = OPENDMR_LATENCY_NORMAL;
+    enc->complexity = OPENDMR_COMPLEXITY_HIGH;
+    enc->dtx = false;
+    return enc;
+}
+
 opendmr_encoder_t *opendmr_encoder_create(void)
 {
-    opendmr_encoder_t *enc = static_cast<opendmr_encoder_t *>(calloc(1, sizeof(opendmr_encoder_t)));
-    if (enc) {
-        enc->enc = new (std::nothrow) MBEEncoder();
-        if (!enc->enc) {
-            /* Allocation failed - clean up and return NULL */
-            free(enc);
-            return nullptr;
-        }
-        enc->enc->set_dmr_mode();   /* AMBE+2 mode */
-        enc->enc->set_gain_adjust(1.0f);
-        enc->gain_db = 0;
-    }
+    void *mem = alloc_hook(sizeof(opendmr_encoder_t));
+    opendmr_encoder_t *enc = opendmr_encoder_init(mem);
+    if (!enc && mem)
+        free_hook(mem);
     return enc;
 }
 
 void opendmr_encoder_destroy(opendmr_encoder_t *enc)
 {
     if (enc) {
-        delete enc->enc;
-        free(enc);
+        enc->~opendmr_encoder_t();
+        free_hook(enc);
     }
 }
 
+/* Pitch refinement candidates and tracking depth of each complexity level */
+static const struct {
+    int ref_cands;
+    int track_depth;
+} complexity_search[] = {
+    { 19, LOOK_AHEAD_MAX },     /* OPENDMR_COMPLEXITY_HIGH */
+    { 7, 1 },                   /* OPENDMR_COMPLEXITY_MEDIUM */
+    { 7, 0 },                   /* OPENDMR_COMPLEXITY_LOW */
+};
+
+static void apply_complexity(opendmr_encoder_t *enc)
+{
+    enc->enc.set_search(complexity_search[enc->complexity].ref_cands,
+                        complexity_search[enc->complexity].track_depth);
+}
+
 void opendmr_encoder_reset(opendmr_encoder_t *enc)
 {
-    if (enc && enc->enc) {
-        /* Re-create encoder to reset state */
-        delete enc->enc;
-        enc->enc = new (std::nothrow) MBEEncoder();
-        if (!enc->enc) {
-            /* Allocation failed - encoder is now in invalid state */
-            return;
-        }
-        enc->enc->set_dmr_mode();
-        enc->enc->set_gain_adjust(powf(10.0f, enc->gain_db / 20.0f));
+    if (enc) {
+        /* Re-construct the analysis state in place */
+        enc->enc.~MBEEncoder();
+        new (&enc->enc) MBEEncoder();
+        enc->enc.set_dmr_mode();
+        enc->enc.set_gain_adjust(powf(10.0f, enc->gain_db / 20.0f));
+        enc->enc.set_look_ahead(LOOK_AHEAD_MAX - enc->latency);
+        apply_complexity(enc);
+        enc->enc.set_dtx(enc->dtx);
+        opendmr_resampler_reset(&enc->rs);
     }
 }
 
 void opendmr_encoder_set_gain(opendmr_encoder_t *enc, int gain_db)
 {
-    if (enc && enc->enc) {
+    if (enc) {
         /* Clamp to reasonable range */
         if (gain_db < -20) gain_db = -20;
         if (gain_db > 20) gain_db = 20;
         enc->gain_db = gain_db;
-        enc->enc->set_gain_adjust(powf(10.0f, gain_db / 20.0f));
+        enc->enc.set_gain_adjust(powf(10.0f, gain_db / 20.0f));
+    }
+}
+
+bool opendmr_encoder_set_latency(opendmr_encoder_t *enc, opendmr_latency_t latency)
+{
+    if (!enc || latency < OPENDMR_LATENCY_NORMAL || latency > OPENDMR_LATENCY_MIN)
+        return false;
+
+    /* Each profile step gives up one frame of look-ahead */
+    enc->latency = latency;
+    enc->enc.set_look_ahead(LOOK_AHEAD_MAX - latency);
+    return true;
+}
+
+bool opendmr_encoder_set_complexity(opendmr_encoder_t *enc, opendmr_complexity_t complexity)
+{
+    if (!enc || complexity < OPENDMR_COMPLEXITY_HIGH || complexity > OPENDMR_COMPLEXITY_LOW)
+        return false;
+
+    enc->complexity = complexity;
+    apply_complexity(enc);
+    return true;
+}
+
+void opendmr_encoder_set_dtx(opendmr_encoder_t *enc, bool enable)
+{
+    if (enc) {
+        enc->dtx = enable;
+        enc->enc.set_dtx(enable);
     }
 }
 
+/*
+ * Samples from the analysis window centre to the newest input sample with
+ * no look-ahead: the pitch and spectral windows (301 and 221 samples)
+ * share the centre, 150 samples from the end of the history.
+ */
+#define ANALYSIS_DELAY      150
+
+unsigned int opendmr_encoder_delay(const opendmr_encoder_t *enc)
+{
+    if (!enc)
+        return 0;
+
+    return (LOOK_AHEAD_MAX - enc->latency) * OPENDMR_PCM_SAMPLES + ANALYSIS_DELAY;
+}
+
 /*
  * Encode 49-bit voice parameters to 72-bit AMBE+2 frame.
  *
  * Input: b[9] voice parameters from MBEEncoder
  * Output: 72-bit frame in DVSI/canonical order
  */
-static void encode_ambe_frame(const int b[9], uint8_t *frame72)
-{
-    /* Pack b[9] into 49 bits */
-    static const int b_lengths[9] = {7, 5, 5, 9, 7, 5, 4, 4, 3};
-    uint8_t bits49[49];
-    int pos = 0;
-    for (int i = 0; i < 9; i++) {
-        int val = b[i];
-        for (int j = b_lengths[i] - 1; j >= 0; j--) {
-            bits49[pos++] = (val >> j) & 1;
-        }
-    }
+void opendmr_encode_ambe_frame(const int b[9], uint8_t *frame72)
+{
+    /*
+     * Pack b[9] into the 49-bit parameter word in mbelib's ambe_d order
+     * (as encode_49bit() in the encoder): the most significant bits of
+     * each parameter are in C0/C1 where Golay protects them, the LSBs
+     * follow in C2/C3.
+     */
+    uint64_t ambe_u = mbe_packAmbe2450Fields(b);
 
-    /* Extract 12-bit values for FEC encoding */
-    /* C0 = bits49[0-11], C1 = bits49[12-23], C2 = bits49[24-34], C3 = bits49[35-48] */
-    uint32_t c0 = 0, c1 = 0;
-    for (int i = 0; i < 12; i++) {
-        c0 = (c0 << 1) | bits49[i];
-        c1 = (c1 << 1) | bits49[12 + i];
-    }
+    /* C0 = bits 48-37, C1 = bits 36-25, C2 + C3 = bits 24-0 */
+    uint32_t c0 = static_cast<uint32_t>(ambe_u >> 37) & 0xFFFU;
+    uint32_t c1 = static_cast<uint32_t>(ambe_u >> 25) & 0xFFFU;
 
     /* Golay encode C0 -> A block (24 bits) */
     uint32_t a = CGolay24128::encode24128(c0);
 
-    /* Golay encode C1, then scramble with PRNG -> B block (23 bits) */
-    uint32_t b_codeword = CGolay24128::encode23127(c1);
-    uint32_t prng_mask = compute_prng_mask_23bit(c0);
+    /* Golay encode C1, then scramble with PRNG -> B block (23 bits).
+     * encode23127() returns the codeword shifted left by one bit. */
+    uint32_t b_codeword = CGolay24128::encode23127(c1) >> 1;
+    uint32_t prng_mask = ambe_prng_mask(c0);
     b_codeword ^= prng_mask;
 
     /* C block = raw C2 + C3 (25 bits) */
-    uint32_t c_block = 0;
-    for (int i = 24; i < 49; i++) {
-        c_block = (c_block << 1) | bits49[i];
-    }
+    uint32_t c_block = static_cast<uint32_t>(ambe_u) & 0x1FFFFFFU;
 
     /* Pack into 72-bit output frame (DVSI order) */
-    memset(frame72, 0, 9);
-
-    /* A block: bits 0-23 */
-    for (int i = 0; i < 24; i++) {
-        int byte_idx = i / 8;
-        int bit_pos = 7 - (i % 8);
-        if ((a >> (23 - i)) & 1)
-            frame72[byte_idx] |= (1 << bit_pos);
-    }
-
-    /* B block: bits 24-46 */
-    for (int i = 0; i < 23; i++) {
-        int pos = 24 + i;
-        int byte_idx = pos / 8;
-        int bit_pos = 7 - (pos % 8);
-        if ((b_codeword >> (22 - i)) & 1)
-            frame72[byte_idx] |= (1 << bit_pos);
-    }
-
-    /* C block: bits 47-71 */
-    for (int i = 0; i < 25; i++) {
-        int pos = 47 + i;
-        int byte_idx = pos / 8;
-        int bit_pos = 7 - (pos % 8);
-        if ((c_block >> (24 - i)) & 1)
-            frame72[byte_idx] |= (1 << bit_pos);
-    }
+    opendmr_pack_blocks(a, b_codeword, c_block, frame72);
 }
 
 bool opendmr_encode(opendmr_encoder_t *enc,
                     const int16_t pcm[OPENDMR_PCM_SAMPLES],
                     uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES])
 {
-    if (!enc || !enc->enc || !pcm || !ambe)
+    if (!enc || !pcm || !ambe)
         return false;
 
     /* Encode PCM to voice parameters */
     int b[9] = {0};
-    enc->enc->encode_dmr_params(pcm, b);
+    enc->enc.encode_dmr_params(pcm, b);
+
+    /* Encode voice parameters to 72-bit frame */
+    opendmr_encode_ambe_frame(b, ambe);
+
+    return true;
+}
+
+bool opendmr_encode_f32(opendmr_encoder_t *enc,
+                        const float pcm[OPENDMR_PCM_SAMPLES],
+                        uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES])
+{
+    if (!enc || !pcm || !ambe)
+        return false;
+
+    /* Encode float PCM to voice parameters */
+    int b[9] = {0};
+    enc->enc.encode_dmr_params_f32(pcm, b);
+
+    /* Encode voice parameters to 72-bit frame */
+    opendmr_encode_ambe_frame(b, ambe);
+
+    return true;
+}
+
+bool opendmr_encode_g711(opendmr_encoder_t *enc,
+                         const uint8_t g711[OPENDMR_PCM_SAMPLES],
+                         opendmr_g711_law_t law,
+                         uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES])
+{
+    if (!enc || !g711 || !ambe)
+        return false;
+
+    const int16_t *lut = opendmr_g711_expand_table(law);
+    if (!lut)
+        return false;
+
+    /* Expansion is fused into the encoder's DC removal filter */
+    int b[9] = {0};
+    enc->enc.encode_dmr_params_g711(g711, lut, b);
 
     /* Encode voice parameters to 72-bit frame */
-    encode_ambe_frame(b, ambe);
+    opendmr_encode_ambe_frame(b, ambe);
 
     return true;
 }
 
+bool opendmr_encode_rate(opendmr_encoder_t *enc,
+                         const int16_t *pcm, unsigned int rate,
+                         uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES])
+{
+    if (rate == OPENDMR_SAMPLE_RATE)
+        return opendmr_encode(enc, pcm, ambe);
+
+    if (!enc || !pcm || !ambe)
+        return false;
+
+    /* Resample straight to the float encoder input scale */
+    float buf[OPENDMR_PCM_SAMPLES];
+    if (!opendmr_resample_down(&enc->rs, rate, pcm, 1.0f / 32768.0f, buf))
+        return false;
+
+    return opendmr_encode_f32(enc, buf, ambe);
+}
+
+/*
+ * ============================================================================
+ * FEC Regeneration
+ * ============================================================================
+ */
+
+/*
+ * Correct A and B, re-encode them and pass C through unchanged.
+ * Returns the corrected error count, or -1 if the frame is uncorrectable.
+ */
+static int regenerate_frame(const uint8_t *in, uint8_t *out)
+{
+    uint32_t a, b, c;
+    opendmr_unpack_blocks(in, &a, &b, &c);
+
+    unsigned int a_errs = 0;
+    uint32_t c0 = CGolay24128::decode24128(a, a_errs);
+
+    unsigned int b_errs = 0;
+    uint32_t prng_mask = ambe_prng_mask(c0);
+    uint32_t c1 = CGolay24128::decode23127(b ^ prng_mask, b_errs);
+
+    a = CGolay24128::encode24128(c0);
+    b = (CGolay24128::encode23127(c1) >> 1) ^ prng_mask;
+    opendmr_pack_blocks(a, b, c, out);
+
+    int errs = static_cast<int>(a_errs + b_errs);
+    return errs > OPENDMR_MAX_CORRECTED_ERRORS ? -1 : errs;
+}
+
+bool opendmr_regenerate(const uint8_t in[OPENDMR_AMBE_FRAME_BYTES],
+                        uint8_t out[OPENDMR_AMBE_FRAME_BYTES],
+                        int *errs)
+{
+    if (!in || !out)
+        return false;
+
+    int n = regenerate_frame(in, out);
+    if (errs)
+        *errs = n;
+
+    return n >= 0;
+}
+
+/* Frames per pass through the batched Golay decoder */
+#define REGEN_CHUNK         64
+
+size_t opendmr_regenerate_batch(const uint8_t *in, uint8_t *out,
+                                size_t frames, int *errs)
+{
+    if (!in || !out)
+        return 0;
+
+    unsigned int a[REGEN_CHUNK], b[REGEN_CHUNK], c0[REGEN_CHUNK], c1[REGEN_CHUNK];
+    unsigned int a_errs[REGEN_CHUNK], b_errs[REGEN_CHUNK];
+    uint32_t c[REGEN_CHUNK];
+    size_t good = 0;
+
+    /* As regenerate_frame(), a chunk at a time: B is descrambled with the
+     * corrected C0, so all A blocks are decoded before any B block */
+    for (size_t base = 0; base < frames; base += REGEN_CHUNK) {
+        unsigned int n = static_cast<unsigned int>(
+            frames - base < REGEN_CHUNK ? frames - base : REGEN_CHUNK);
+        const uint8_t *src = in + base * OPENDMR_AMBE_FRAME_BYTES;
+        uint8_t *dst = out + base * OPENDMR_AMBE_FRAME_BYTES;
+
+        for (unsigned int k = 0; k < n; k++) {
+            uint32_t ak, bk;
+            opendmr_unpack_blocks(src + k * OPENDMR_AMBE_FRAME_BYTES, &ak, &bk, &c[k]);
+            a[k] = ak;
+            b[k] = bk;
+        }
+
+        CGolay24128::decode24128Batch(a, c0, a_errs, n);
+        for (unsigned int k = 0; k < n; k++)
+            b[k] ^= ambe_prng_mask(c0[k]);
+        CGolay24128::decode23127Batch(b, c1, b_errs, n);
+
+        CGolay24128::encode24128Batch(c0, a, n);
+        CGolay24128::encode23127Batch(c1, b, n);
+
+        for (unsigned int k = 0; k < n; k++) {
+            opendmr_pack_blocks(a[k], (b[k] >> 1) ^ ambe_prng_mask(c0[k]), c[k],
+                                dst + k * OPENDMR_AMBE_FRAME_BYTES);
+
+            int e = static_cast<int>(a_errs[k] + b_errs[k]);
+            if (e > OPENDMR_MAX_CORRECTED_ERRORS)
+                e = -1;
+            if (errs)
+                errs[base + k] = e;
+            if (e >= 0)
+                good++;
+        }
+    }
+
+    return good;
+}
+
 /*
  * ============================================================================
  * Utility Functions
@@ -354,25 +1035,34 @@ const char *opendmr_version(void)
     return version_string;
 }
 
+/*
+ * Byte k of a word <-> bit 7 - k of a byte. Multiplying by this constant
+ * spreads a byte's bits one per byte, or gathers 0/1 bytes back, with no
+ * carries between the partial products.
+ */
+#define BIT_SPREAD          UINT64_C(0x8040201008040201)
+#define BYTE_LSBS           UINT64_C(0x0101010101010101)
+#define BYTE_LOW7           UINT64_C(0x7F7F7F7F7F7F7F7F)
+
 void opendmr_convert_frame(uint8_t bytes[OPENDMR_AMBE_FRAME_BYTES],
                            uint8_t bits[OPENDMR_AMBE_FRAME_BITS],
                            bool to_bits)
 {
     if (to_bits) {
-        /* bytes -> bits */
-        for (int i = 0; i < 72; i++) {
-            int byte_idx = i / 8;
-            int bit_pos = 7 - (i % 8);
-            bits[i] = (bytes[byte_idx] >> bit_pos) & 1;
+        /* bytes -> bits, eight at a time */
+        for (int i = 0; i < OPENDMR_AMBE_FRAME_BYTES; i++) {
+            uint64_t w = ((bytes[i] * BIT_SPREAD) >> 7) & BYTE_LSBS;
+            for (int k = 0; k < 8; k++)
+                bits[8 * i + k] = static_cast<uint8_t>(w >> (8 * k));
         }
     } else {
-        /* bits -> bytes */
-        memset(bytes, 0, 9);
-        for (int i = 0; i < 72; i++) {
-            int byte_idx = i / 8;
-            int bit_pos = 7 - (i % 8);
-            if (bits[i])
-                bytes[byte_idx] |= (1 << bit_pos);
+        /* bits -> bytes; any non-zero element is a set bit */
+        for (int i = 0; i < OPENDMR_AMBE_FRAME_BYTES; i++) {
+            uint64_t w = 0;
+            for (int k = 0; k < 8; k++)
+                w |= static_cast<uint64_t>(bits[8 * i + k]) << (8 * k);
+            w = ((((w & BYTE_LOW7) + BYTE_LOW7) | w) >> 7) & BYTE_LSBS;
+            bytes[i] = static_cast<uint8_t>((w * BIT_SPREAD) >> 56);
         }
     }
 }
@@ -16,6 +16,7 @@
 #ifndef OPENDMR_H
 #define OPENDMR_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -34,9 +35,17 @@ extern "C" {
 #define OPENDMR_AMBE_FRAME_BITS     72      /* AMBE+2 frame size */
 #define OPENDMR_PCM_SAMPLES         160     /* 20ms @ 8kHz sample rate */
 #define OPENDMR_SAMPLE_RATE         8000    /* 8kHz audio */
+#define OPENDMR_IMBE_FRAME_BYTES    11      /* P25 IMBE u0..u7, 88 bits */
+#define OPENDMR_FRAME_US            20000   /* Frame period in microseconds */
+#define OPENDMR_MAX_RATE_SAMPLES    960     /* 20ms @ 48kHz, largest rate frame */
+#define OPENDMR_BURST_BYTES         33      /* DMR voice burst, 264 bits */
+#define OPENDMR_BURST_FRAMES        3       /* AMBE+2 frames per burst */
+#define OPENDMR_BURST_SAMPLES       480     /* 60ms @ 8kHz, one burst */
+#define OPENDMR_SLOTS               2       /* TDMA timeslots per DMR channel */
 
 /* Voice parameter sizes */
 #define OPENDMR_VOICE_PARAMS        49      /* 49-bit voice parameters */
+#define OPENDMR_MAX_BANDS           56      /* Maximum harmonic bands (L) */
 
 /*
  * ============================================================================
@@ -50,6 +59,81 @@ typedef struct opendmr_decoder opendmr_decoder_t;
 /* Encoder state - opaque handle */
 typedef struct opendmr_encoder opendmr_encoder_t;
 
+/* Two-timeslot decoder - opaque handle */
+typedef struct opendmr_dual_decoder opendmr_dual_decoder_t;
+
+/* Streaming re-framer - opaque handle */
+typedef struct opendmr_stream opendmr_stream_t;
+
+/* Parameter-domain gain rewriter - opaque handle */
+typedef struct opendmr_gain opendmr_gain_t;
+
+/* AMBE+2 <-> IMBE parameter transcoder - opaque handle */
+typedef struct opendmr_transcoder opendmr_transcoder_t;
+
+/* Tick scheduler - opaque handle */
+typedef struct opendmr_clock opendmr_clock_t;
+
+/* Conference mixer - opaque handle */
+typedef struct opendmr_mixer opendmr_mixer_t;
+
+/* Jitter buffer - opaque handle */
+typedef struct opendmr_jitterbuf opendmr_jitterbuf_t;
+
+/*
+ * ============================================================================
+ * Types
+ * ============================================================================
+ */
+
+/* Frame classification */
+typedef enum {
+    OPENDMR_FRAME_VOICE = 0,    /* Normal voice frame */
+    OPENDMR_FRAME_SILENCE,      /* Silence frame (b0 = 124/125) */
+    OPENDMR_FRAME_ERASURE,      /* Erasure frame (b0 = 120-123) */
+    OPENDMR_FRAME_TONE,         /* Tone frame */
+    OPENDMR_FRAME_REPEAT,       /* Too many bit errors: previous frame repeated */
+    OPENDMR_FRAME_MUTED         /* Too many repeats: output muted */
+} opendmr_frame_class_t;
+
+/* G.711 companding law */
+typedef enum {
+    OPENDMR_G711_ULAW = 0,      /* mu-law (North America, Japan) */
+    OPENDMR_G711_ALAW           /* A-law (Europe, international links) */
+} opendmr_g711_law_t;
+
+/* Encoder latency profiles (pitch look-ahead) */
+typedef enum {
+    OPENDMR_LATENCY_NORMAL = 0, /* Two frames of look-ahead (default) */
+    OPENDMR_LATENCY_LOW,        /* One frame of look-ahead, 20 ms less delay */
+    OPENDMR_LATENCY_MIN         /* Look-back tracking only, 40 ms less delay */
+} opendmr_latency_t;
+
+/* Encoder complexity levels (speech analysis search effort) */
+typedef enum {
+    OPENDMR_COMPLEXITY_HIGH = 0,    /* Full searches (default) */
+    OPENDMR_COMPLEXITY_MEDIUM,      /* Fewer pitch candidates, 1 frame tracking */
+    OPENDMR_COMPLEXITY_LOW          /* Fewer pitch candidates, look-back tracking */
+} opendmr_complexity_t;
+
+/* Decoded voice parameters of one frame */
+typedef struct {
+    int errs;                   /* Corrected bit errors (A + B blocks) */
+    opendmr_frame_class_t frame_class;
+    float w0;                   /* Fundamental frequency (radians/sample) */
+    int L;                      /* Number of harmonic bands (0 if none) */
+    uint64_t vuv;               /* Bit l-1 set = band l voiced */
+    float gain;                 /* Frame gain (log2 amplitude) */
+    float log2_ml[OPENDMR_MAX_BANDS]; /* Band log2 magnitudes [0..L-1] */
+} opendmr_params_t;
+
+/* Per-frame decode report */
+typedef struct {
+    int errs;                   /* Corrected bit errors (A + B blocks) */
+    opendmr_frame_class_t frame_class;
+    bool silent;                /* Output is digital silence (all zero) */
+} opendmr_frame_info_t;
+
 /*
  * ============================================================================
  * Decoder API
@@ -81,6 +165,9 @@ void opendmr_decoder_destroy(opendmr_decoder_t *dec);
  *
  * @return true on success, false on failure.
  *
+ * Frames with more than 3 corrected errors are concealed by repeating the
+ * previous frame's parameters; long runs are muted.
+ *
  * The decoder maintains state between frames for proper audio continuity.
  * For best results, decode frames in sequence without gaps.
  */
@@ -89,6 +176,103 @@ bool opendmr_decode(opendmr_decoder_t *dec,
                     int16_t pcm[OPENDMR_PCM_SAMPLES],
                     int *errs);
 
+/**
+ * Decode a DMR AMBE+2 frame to floating point audio.
+ *
+ * @param dec       Decoder instance.
+ * @param ambe      Input AMBE+2 frame (9 bytes / 72 bits).
+ * @param pcm       Output buffer (160 samples, full scale +/-1.0).
+ * @param errs      Optional: Number of corrected bit errors (may be NULL).
+ *
+ * @return true on success, false on failure.
+ *
+ * Uses the same output gain as opendmr_decode() (1.0 corresponds to an
+ * int16 value of 32768) but skips the 16-bit conversion and is not
+ * clipped, so peaks above 1.0 are preserved for downstream mixing.
+ */
+bool opendmr_decode_f32(opendmr_decoder_t *dec,
+                        const uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES],
+                        float pcm[OPENDMR_PCM_SAMPLES],
+                        int *errs);
+
+/**
+ * Decode a DMR AMBE+2 frame to PCM audio and report its frame class.
+ *
+ * @param dec       Decoder instance.
+ * @param ambe      Input AMBE+2 frame (9 bytes / 72 bits).
+ * @param pcm       Output PCM buffer (160 samples, 16-bit signed).
+ * @param info      Optional: error count, frame class and silence flag
+ *                  (may be NULL).
+ *
+ * @return true on success, false on failure.
+ *
+ * Output is identical to opendmr_decode(). Erasure, rejected tone and
+ * muted frames produce digital silence without synthesis and set
+ * info->silent. Silence frames (OPENDMR_FRAME_SILENCE) still carry the
+ * transmitted background noise and are synthesised; a mixer may skip
+ * them by class if it does not need comfort noise.
+ */
+bool opendmr_decode_ex(opendmr_decoder_t *dec,
+                       const uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES],
+                       int16_t pcm[OPENDMR_PCM_SAMPLES],
+                       opendmr_frame_info_t *info);
+
+/**
+ * Floating point variant of opendmr_decode_ex().
+ *
+ * @param dec       Decoder instance.
+ * @param ambe      Input AMBE+2 frame (9 bytes / 72 bits).
+ * @param pcm       Output buffer (160 samples, full scale +/-1.0).
+ * @param info      Optional: error count, frame class and silence flag
+ *                  (may be NULL).
+ *
+ * @return true on success, false on failure.
+ */
+bool opendmr_decode_f32_ex(opendmr_decoder_t *dec,
+                           const uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES],
+                           float pcm[OPENDMR_PCM_SAMPLES],
+                           opendmr_frame_info_t *info);
+
+/**
+ * Conceal a frame that was lost in transit (erasure entry).
+ *
+ * @param dec       Decoder instance.
+ * @param pcm       Output PCM buffer (160 samples, 16-bit signed).
+ * @param info      Optional: frame class (OPENDMR_FRAME_REPEAT, or
+ *                  OPENDMR_FRAME_MUTED once repeats run out) and silence
+ *                  flag; errs is 0 (may be NULL).
+ *
+ * @return true on success, false on failure.
+ *
+ * Call in place of opendmr_decode_ex() for each missing frame instead of
+ * passing a dummy frame. The previous parameters are repeated as for a
+ * frame with uncorrectable errors, so the decoder's repeat limit and
+ * muting apply unchanged; the error rate that drives muting is not
+ * raised, as no bits were received.
+ */
+bool opendmr_decode_lost(opendmr_decoder_t *dec,
+                         int16_t pcm[OPENDMR_PCM_SAMPLES],
+                         opendmr_frame_info_t *info);
+
+/**
+ * Decode a frame's voice parameters without synthesising audio.
+ *
+ * @param dec       Decoder instance.
+ * @param ambe      Input AMBE+2 frame (9 bytes / 72 bits).
+ * @param params    Output: error count, frame class and voice parameters.
+ *
+ * @return true on success, false on failure.
+ *
+ * Runs FEC and parameter decoding only, skipping speech synthesis. Decoder
+ * state advances exactly as with opendmr_decode(), so full decoding may
+ * resume on any later frame with identical output. Voice parameters are
+ * reported for voice, silence and repeated frames; for repeated frames
+ * they are the repeated values.
+ */
+bool opendmr_decode_params(opendmr_decoder_t *dec,
+                           const uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES],
+                           opendmr_params_t *params);
+
 /**
  * Reset decoder state (e.g., at start of new transmission).
  *
@@ -133,6 +317,22 @@ bool opendmr_encode(opendmr_encoder_t *enc,
                     const int16_t pcm[OPENDMR_PCM_SAMPLES],
                     uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES]);
 
+/**
+ * Encode floating point audio to a DMR AMBE+2 frame.
+ *
+ * @param enc       Encoder instance.
+ * @param pcm       Input buffer (160 samples, full scale +/-1.0, 8kHz).
+ * @param ambe      Output AMBE+2 frame (9 bytes / 72 bits).
+ *
+ * @return true on success, false on failure.
+ *
+ * The conversion to the encoder's fixed-point format is fused into its
+ * input filter; samples beyond +/-1.0 saturate.
+ */
+bool opendmr_encode_f32(opendmr_encoder_t *enc,
+                        const float pcm[OPENDMR_PCM_SAMPLES],
+                        uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES]);
+
 /**
  * Reset encoder state (e.g., at start of new transmission).
  *
@@ -150,6 +350,1062 @@ void opendmr_encoder_reset(opendmr_encoder_t *enc);
  */
 void opendmr_encoder_set_gain(opendmr_encoder_t *enc, int gain_db);
 
+/**
+ * Select the encoder's latency profile.
+ *
+ * @param enc       Encoder instance.
+ * @param latency   OPENDMR_LATENCY_NORMAL, _LOW or _MIN.
+ *
+ * @return true on success, false for an unknown profile.
+ *
+ * The pitch tracker normally looks two frames ahead of the frame it
+ * analyses, which delays the encoder output by 40 ms beyond the frame
+ * itself. The low-latency profiles analyse a frame closer to the newest
+ * input and track pitch over one frame of look-ahead, or none. Pitch is
+ * then less stable through onsets and vowel transitions (pitch and
+ * octave errors, heard as roughness), and the analysis does a third or
+ * two thirds less pitch estimation work. Kept across opendmr_encoder_reset();
+ * may be changed between frames.
+ */
+bool opendmr_encoder_set_latency(opendmr_encoder_t *enc, opendmr_latency_t latency);
+
+/**
+ * Select the encoder's complexity level.
+ *
+ * @param enc         Encoder instance.
+ * @param complexity  OPENDMR_COMPLEXITY_HIGH, _MEDIUM or _LOW.
+ *
+ * @return true on success, false for an unknown level.
+ *
+ * Most of the encoding time goes to pitch estimation. The lower levels
+ * refine the pitch over 7 candidates instead of 19 and track it over
+ * fewer frames of look-ahead (one, or none), cutting the encoding time
+ * by roughly a third or a half at some cost in pitch accuracy. The
+ * latency profile and output format are unchanged, so the level can be
+ * lowered between frames when a host is overloaded, rather than dropping
+ * channels. Kept across opendmr_encoder_reset().
+ */
+bool opendmr_encoder_set_complexity(opendmr_encoder_t *enc, opendmr_complexity_t complexity);
+
+/**
+ * Enable discontinuous transmission (voice activity detection).
+ *
+ * @param enc       Encoder instance.
+ * @param enable    true to send silence frames for silent input (default
+ *                  false).
+ *
+ * A voice activity detector compares each input frame's energy with the
+ * tracked noise floor, and its spectral flatness with that of noise. Frames
+ * it finds silent, including line noise and digital silence, are sent as
+ * the standard DMR silence frame (b0 = 124) without speech analysis, which
+ * costs a small fraction of a voice frame. Analysis resumes as speech
+ * enters the pitch look-ahead, so onsets are not clipped, and continues
+ * for 160 ms after the last speech. The first second or so of input is
+ * always analysed while the noise floor settles. Applies to PCM, float
+ * and G.711 input; kept across opendmr_encoder_reset().
+ */
+void opendmr_encoder_set_dtx(opendmr_encoder_t *enc, bool enable);
+
+/**
+ * Get the encoder's algorithmic delay for its latency profile.
+ *
+ * @param enc Encoder instance.
+ *
+ * @return Samples (8 kHz) by which the centre of the analysis window
+ *         trails the last input sample of the frame just encoded (470,
+ *         310 or 150); 0 if enc is NULL.
+ */
+unsigned int opendmr_encoder_delay(const opendmr_encoder_t *enc);
+
+/*
+ * ============================================================================
+ * Sample Rate API
+ * ============================================================================
+ *
+ * Decode to, and encode from, 16, 44.1 or 48 kHz audio without an external
+ * resampler. A polyphase filter runs inside the decoder or encoder on each
+ * 20 ms frame, with its history kept in the instance, so consecutive
+ * frames join seamlessly and nothing is allocated per frame. A frame at
+ * any rate covers 20 ms: 320 samples at 16 kHz, 882 at 44.1 kHz and 960
+ * at 48 kHz. 8 kHz is accepted too and bypasses the filter.
+ *
+ * The decoder synthesises 16 and 48 kHz directly: harmonics and unvoiced
+ * noise are generated at the output rate, so there is no filter and no
+ * added delay. 44.1 kHz output, and all encoder input, use the filter.
+ *
+ * The filter delays audio by 2 ms. Changing the rate of an instance
+ * restarts the filter or synthesis history; opendmr_decoder_reset() and
+ * opendmr_encoder_reset() clear it.
+ */
+
+/**
+ * Samples per 20 ms frame at a sample rate.
+ *
+ * @param rate  8000, 16000, 44100 or 48000.
+ *
+ * @return Frame length in samples, or 0 if the rate is not supported.
+ */
+size_t opendmr_rate_samples(unsigned int rate);
+
+/**
+ * Decode a DMR AMBE+2 frame to PCM audio at another sample rate.
+ *
+ * @param dec       Decoder instance.
+ * @param ambe      Input AMBE+2 frame (9 bytes / 72 bits).
+ * @param pcm       Output PCM buffer (opendmr_rate_samples(rate) samples,
+ *                  16-bit signed).
+ * @param rate      Output sample rate.
+ * @param info      Optional: error count, frame class and silence flag
+ *                  (may be NULL).
+ *
+ * @return true on success, false on failure or unsupported rate.
+ *
+ * Output level matches opendmr_decode().
+ */
+bool opendmr_decode_rate(opendmr_decoder_t *dec,
+                         const uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES],
+                         int16_t *pcm, unsigned int rate,
+                         opendmr_frame_info_t *info);
+
+/**
+ * Choose how opendmr_decode_rate() produces 16 and 48 kHz.
+ *
+ * @param dec       Decoder instance.
+ * @param enable    true (default) to synthesise at the output rate,
+ *                  false to decode at 8 kHz and resample.
+ */
+void opendmr_decoder_set_native_rate(opendmr_decoder_t *dec, bool enable);
+
+/**
+ * Encode PCM audio at another sample rate to a DMR AMBE+2 frame.
+ *
+ * @param enc       Encoder instance.
+ * @param pcm       Input PCM buffer (opendmr_rate_samples(rate) samples,
+ *                  16-bit signed).
+ * @param rate      Input sample rate.
+ * @param ambe      Output AMBE+2 frame (9 bytes / 72 bits).
+ *
+ * @return true on success, false on failure or unsupported rate.
+ *
+ * Content above 3.6 kHz is filtered out before encoding.
+ */
+bool opendmr_encode_rate(opendmr_encoder_t *enc,
+                         const int16_t *pcm, unsigned int rate,
+                         uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES]);
+
+/*
+ * ============================================================================
+ * G.711 API
+ * ============================================================================
+ *
+ * Decode to, and encode from, 8-bit G.711 (mu-law or A-law) audio at
+ * 8 kHz, for telephony gateways. Companding is table driven and fused
+ * into the codec's own sample loops: the decoder compresses straight from
+ * its float output stage and the encoder expands codes as its DC removal
+ * filter reads them, so no 16-bit frame is materialised in between.
+ */
+
+/**
+ * Decode a DMR AMBE+2 frame to G.711 audio.
+ *
+ * @param dec       Decoder instance.
+ * @param ambe      Input AMBE+2 frame (9 bytes / 72 bits).
+ * @param g711      Output buffer (160 G.711 codes).
+ * @param law       OPENDMR_G711_ULAW or OPENDMR_G711_ALAW.
+ * @param info      Optional: error count, frame class and silence flag
+ *                  (may be NULL).
+ *
+ * @return true on success, false on failure or unknown law.
+ *
+ * Output equals compressing the samples of opendmr_decode_ex() with the
+ * ITU-T G.711 reference conversion; silent frames are the law's zero code
+ * (0xFF for mu-law, 0xD5 for A-law).
+ */
+bool opendmr_decode_g711(opendmr_decoder_t *dec,
+                         const uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES],
+                         uint8_t g711[OPENDMR_PCM_SAMPLES],
+                         opendmr_g711_law_t law,
+                         opendmr_frame_info_t *info);
+
+/**
+ * Encode G.711 audio to a DMR AMBE+2 frame.
+ *
+ * @param enc       Encoder instance.
+ * @param g711      Input buffer (160 G.711 codes, 8kHz).
+ * @param law       OPENDMR_G711_ULAW or OPENDMR_G711_ALAW.
+ * @param ambe      Output AMBE+2 frame (9 bytes / 72 bits).
+ *
+ * @return true on success, false on failure or unknown law.
+ *
+ * Output equals opendmr_encode() on the expanded 16-bit samples.
+ */
+bool opendmr_encode_g711(opendmr_encoder_t *enc,
+                         const uint8_t g711[OPENDMR_PCM_SAMPLES],
+                         opendmr_g711_law_t law,
+                         uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES]);
+
+/*
+ * ============================================================================
+ * Voice Burst API
+ * ============================================================================
+ *
+ * Work on whole DMR voice bursts as sent on air (33 bytes, 264 bits):
+ * three AMBE+2 frames, each interleaved, with the 48-bit sync/EMB field
+ * in bits 108-155 between the halves of the second. Frames are
+ * (de)interleaved a byte at a time through a lookup table.
+ */
+
+/**
+ * Extract the three frames of a voice burst in DVSI order.
+ *
+ * @param burst     Input voice burst (33 bytes).
+ * @param frames    Output: three consecutive 9-byte AMBE+2 frames.
+ */
+void opendmr_burst_to_frames(const uint8_t burst[OPENDMR_BURST_BYTES],
+                             uint8_t frames[OPENDMR_BURST_FRAMES * OPENDMR_AMBE_FRAME_BYTES]);
+
+/**
+ * Interleave three DVSI-order frames into a voice burst.
+ *
+ * @param frames    Input: three consecutive 9-byte AMBE+2 frames.
+ * @param burst     Voice burst (33 bytes) to write.
+ *
+ * Only the 216 voice bits are written; the sync/EMB field (bits 108-155)
+ * keeps whatever the caller put there.
+ */
+void opendmr_frames_to_burst(const uint8_t frames[OPENDMR_BURST_FRAMES * OPENDMR_AMBE_FRAME_BYTES],
+                             uint8_t burst[OPENDMR_BURST_BYTES]);
+
+/**
+ * Decode a DMR voice burst to PCM audio.
+ *
+ * @param dec       Decoder instance.
+ * @param burst     Input voice burst (33 bytes).
+ * @param pcm       Output PCM buffer (480 samples, 16-bit signed).
+ * @param info      Optional: per-frame error count, frame class and
+ *                  silence flag (3 entries, may be NULL).
+ *
+ * @return true on success, false on failure.
+ *
+ * Output is identical to opendmr_decode_ex() on the three frames in turn.
+ */
+bool opendmr_decode_burst(opendmr_decoder_t *dec,
+                          const uint8_t burst[OPENDMR_BURST_BYTES],
+                          int16_t pcm[OPENDMR_BURST_SAMPLES],
+                          opendmr_frame_info_t info[OPENDMR_BURST_FRAMES]);
+
+/**
+ * Encode PCM audio to a DMR voice burst.
+ *
+ * @param enc       Encoder instance.
+ * @param pcm       Input PCM buffer (480 samples, 16-bit signed, 8kHz).
+ * @param burst     Voice burst (33 bytes) to write.
+ *
+ * @return true on success, false on failure.
+ *
+ * Writes the 216 voice bits as opendmr_frames_to_burst(); the sync/EMB
+ * field is left untouched.
+ */
+bool opendmr_encode_burst(opendmr_encoder_t *enc,
+                          const int16_t pcm[OPENDMR_BURST_SAMPLES],
+                          uint8_t burst[OPENDMR_BURST_BYTES]);
+
+/*
+ * ============================================================================
+ * Dual-Timeslot Decoder API
+ * ============================================================================
+ *
+ * Decode both timeslots of a DMR channel into one multichannel buffer, as
+ * a monitor or recorder does. The dual decoder owns a decoder per slot and
+ * writes each slot's samples at a caller-chosen stride, so interleaved
+ * stereo needs no separate interleave pass or copy. Decoding a frame pair
+ * synthesises both slots back to back and writes them in one pass.
+ *
+ * Slots are numbered 0 (TS1) and 1 (TS2).
+ */
+
+/**
+ * Create a dual-timeslot decoder.
+ *
+ * @return Pointer to dual decoder, or NULL on failure.
+ *         Must be freed with opendmr_dual_decoder_destroy().
+ */
+opendmr_dual_decoder_t *opendmr_dual_decoder_create(void);
+
+/**
+ * Destroy a dual-timeslot decoder.
+ *
+ * @param dd    Dual decoder to destroy (may be NULL).
+ */
+void opendmr_dual_decoder_destroy(opendmr_dual_decoder_t *dd);
+
+/**
+ * Reset one slot, as opendmr_decoder_reset(), e.g. at the end of a call.
+ *
+ * @param dd    Dual decoder.
+ * @param slot  Slot to reset (0 or 1).
+ */
+void opendmr_dual_decoder_reset(opendmr_dual_decoder_t *dd, int slot);
+
+/**
+ * Get the decoder of one slot, to use any other decode function on it.
+ *
+ * @param dd    Dual decoder.
+ * @param slot  Slot (0 or 1).
+ *
+ * @return The slot's decoder (owned by dd), or NULL if slot is invalid.
+ */
+opendmr_decoder_t *opendmr_dual_decoder_slot(opendmr_dual_decoder_t *dd, int slot);
+
+/**
+ * Decode a frame of one slot into a strided buffer.
+ *
+ * @param dd        Dual decoder.
+ * @param slot      Slot the frame belongs to (0 or 1).
+ * @param ambe      Input AMBE+2 frame (9 bytes).
+ * @param pcm       Output: sample n is written to pcm[n * stride]. For
+ *                  interleaved stereo pass the frame start plus slot.
+ * @param stride    Distance between consecutive samples (>= 1).
+ * @param info      Optional: error count, frame class and silence flag
+ *                  (may be NULL).
+ *
+ * @return true on success, false on failure.
+ *
+ * Samples are identical to opendmr_decode_ex() on the slot's decoder.
+ */
+bool opendmr_dual_decode(opendmr_dual_decoder_t *dd, int slot,
+                         const uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES],
+                         int16_t *pcm, size_t stride,
+                         opendmr_frame_info_t *info);
+
+/**
+ * Decode one frame of each slot into a multichannel buffer.
+ *
+ * @param dd        Dual decoder.
+ * @param ambe      Input frames of slots 0 and 1 (9 bytes each); an entry
+ *                  may be NULL when its slot has no frame this period.
+ * @param pcm       Output: sample n of slot k is written to
+ *                  pcm[n * stride + k].
+ * @param stride    Distance between consecutive samples of a slot (>= 2;
+ *                  2 is interleaved stereo).
+ * @param info      Optional: per-slot report (2 entries, may be NULL);
+ *                  entries of slots without a frame are not written.
+ *
+ * @return true on success, false on failure.
+ *
+ * A slot without a frame is written as silence and its decoder is left
+ * as it was.
+ */
+bool opendmr_dual_decode_pair(opendmr_dual_decoder_t *dd,
+                              const uint8_t *const ambe[OPENDMR_SLOTS],
+                              int16_t *pcm, size_t stride,
+                              opendmr_frame_info_t info[OPENDMR_SLOTS]);
+
+/*
+ * ============================================================================
+ * FEC Regeneration API
+ * ============================================================================
+ */
+
+/**
+ * Correct and re-encode the FEC of a frame without vocoding.
+ *
+ * @param in        Input AMBE+2 frame (9 bytes / 72 bits).
+ * @param out       Output frame with clean A/B codewords (may equal in).
+ * @param errs      Optional: corrected bit errors, or -1 if uncorrectable
+ *                  (may be NULL).
+ *
+ * @return true if the frame was regenerated cleanly, false if it is
+ *         uncorrectable or the arguments are invalid.
+ *
+ * The A and B blocks are Golay decoded and re-encoded (B with its PRNG
+ * scrambling); the unprotected C block is passed through. A frame is
+ * uncorrectable when it has more than 3 corrected errors, the threshold
+ * at which the decoder conceals it; out is still written, but a repeater
+ * should substitute an erasure or repeat frame.
+ */
+bool opendmr_regenerate(const uint8_t in[OPENDMR_AMBE_FRAME_BYTES],
+                        uint8_t out[OPENDMR_AMBE_FRAME_BYTES],
+                        int *errs);
+
+/**
+ * Regenerate a run of consecutive frames.
+ *
+ * @param in        Input frames (frames * 9 bytes).
+ * @param out       Output frames (frames * 9 bytes, may equal in).
+ * @param frames    Number of frames.
+ * @param errs      Optional: per-frame error counts as for
+ *                  opendmr_regenerate() (frames entries, may be NULL).
+ *
+ * @return Number of frames regenerated cleanly.
+ */
+size_t opendmr_regenerate_batch(const uint8_t *in, uint8_t *out,
+                                size_t frames, int *errs);
+
+/*
+ * ============================================================================
+ * Gain Rewriter API
+ * ============================================================================
+ */
+
+/**
+ * Create a gain rewriter for one stream of AMBE+2 frames.
+ *
+ * @return Pointer to rewriter, or NULL on failure.
+ *         Must be freed with opendmr_gain_destroy().
+ *
+ * The rewriter changes the level of frames without vocoding by
+ * re-quantising the differential gain index (b2) and re-applying FEC.
+ * It tracks the decoder's gain predictor, so each stream (call leg)
+ * needs its own instance and frames must be processed in order.
+ */
+opendmr_gain_t *opendmr_gain_create(void);
+
+/**
+ * Destroy a gain rewriter.
+ *
+ * @param g         Rewriter instance (may be NULL).
+ */
+void opendmr_gain_destroy(opendmr_gain_t *g);
+
+/**
+ * Reset predictor and AGC state (e.g., at start of new transmission).
+ *
+ * @param g         Rewriter instance.
+ */
+void opendmr_gain_reset(opendmr_gain_t *g);
+
+/**
+ * Set a fixed level offset, used while AGC is disabled.
+ *
+ * @param g         Rewriter instance.
+ * @param gain_db   Offset in dB (default 0).
+ *
+ * Gain is requantised closed-loop against the far-end decoder's predictor,
+ * so the offset holds on sustained speech. The b2 codebook limits how fast
+ * the level can fall, so fast decays and very quiet frames are cut less.
+ */
+void opendmr_gain_set_offset(opendmr_gain_t *g, float gain_db);
+
+/**
+ * Enable or disable automatic level control.
+ *
+ * @param g           Rewriter instance.
+ * @param enable      true to enable AGC (replaces the fixed offset).
+ * @param target_db   Target voice level in dB of frame gain
+ *                    (6.02 * opendmr_params_t.gain).
+ * @param max_gain_db Largest boost or cut applied, in dB (default 12).
+ *
+ * The level is tracked on voice frames only; silence frames receive the
+ * current offset without updating it.
+ */
+void opendmr_gain_set_agc(opendmr_gain_t *g, bool enable,
+                          float target_db, float max_gain_db);
+
+/**
+ * Apply the configured gain to one frame.
+ *
+ * @param g         Rewriter instance.
+ * @param in        Input AMBE+2 frame (9 bytes / 72 bits).
+ * @param out       Output AMBE+2 frame (may equal in).
+ * @param errs      Optional: corrected bit errors, or -1 if uncorrectable
+ *                  (may be NULL).
+ *
+ * @return true if the frame was rewritten, false if it is uncorrectable
+ *         (copied through unchanged) or the arguments are invalid.
+ *
+ * Correctable frames leave with regenerated FEC as for
+ * opendmr_regenerate(). Erasure and tone frames are not level-adjusted.
+ */
+bool opendmr_gain_process(opendmr_gain_t *g,
+                          const uint8_t in[OPENDMR_AMBE_FRAME_BYTES],
+                          uint8_t out[OPENDMR_AMBE_FRAME_BYTES],
+                          int *errs);
+
+/*
+ * ============================================================================
+ * Transcoder API
+ * ============================================================================
+ *
+ * Converts between AMBE+2 (DMR) and P25 full-rate IMBE in the model
+ * parameter domain: decoded pitch, voicing and band magnitudes of one codec
+ * are re-quantised directly by the other, with no PCM synthesis or pitch
+ * estimation in between. IMBE frames are the 88-bit u0..u7 parameter
+ * vectors as produced by the IMBE encoder (12, 12, 12, 12, 11, 11, 11 and
+ * 7 bits, MSB first); P25 channel coding is left to the caller.
+ */
+
+/**
+ * Create a transcoder for one call in both directions.
+ *
+ * @return Pointer to transcoder, or NULL on failure.
+ *         Must be freed with opendmr_transcoder_destroy().
+ *
+ * Both codecs predict from the previous frame, so each direction keeps its
+ * own state and frames must be passed in order.
+ */
+opendmr_transcoder_t *opendmr_transcoder_create(void);
+
+/**
+ * Destroy a transcoder.
+ *
+ * @param tc        Transcoder instance (may be NULL).
+ */
+void opendmr_transcoder_destroy(opendmr_transcoder_t *tc);
+
+/**
+ * Reset both directions (e.g., at start of new transmission).
+ *
+ * @param tc        Transcoder instance.
+ */
+void opendmr_transcoder_reset(opendmr_transcoder_t *tc);
+
+/**
+ * Transcode one AMBE+2 frame to an IMBE frame.
+ *
+ * @param tc        Transcoder instance.
+ * @param ambe      Input AMBE+2 frame (9 bytes / 72 bits).
+ * @param imbe      Output IMBE frame (11 bytes / 88 bits).
+ * @param errs      Optional: corrected bit errors in the AMBE+2 frame
+ *                  (may be NULL).
+ *
+ * @return true on success, false on invalid arguments.
+ *
+ * Repeated frames are re-quantised from the concealed parameters. Erasure,
+ * tone and muted frames produce a near-silent unvoiced IMBE frame.
+ */
+bool opendmr_ambe_to_imbe(opendmr_transcoder_t *tc,
+                          const uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES],
+                          uint8_t imbe[OPENDMR_IMBE_FRAME_BYTES],
+                          int *errs);
+
+/**
+ * Transcode one IMBE frame to an AMBE+2 frame.
+ *
+ * @param tc        Transcoder instance.
+ * @param imbe      Input IMBE frame (11 bytes / 88 bits).
+ * @param ambe      Output AMBE+2 frame (9 bytes / 72 bits).
+ *
+ * @return true if the IMBE frame was valid, false if its pitch code is
+ *         reserved (the previous parameters are repeated, then muted) or
+ *         the arguments are invalid.
+ */
+bool opendmr_imbe_to_ambe(opendmr_transcoder_t *tc,
+                          const uint8_t imbe[OPENDMR_IMBE_FRAME_BYTES],
+                          uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES]);
+
+/*
+ * ============================================================================
+ * Streaming API
+ * ============================================================================
+ *
+ * A stream accepts audio and AMBE data in chunks of any size and runs the
+ * codec whenever a whole frame is available. Internally each direction uses
+ * two rings sized in whole frames, so the codec works in place on ring
+ * memory. The span/commit functions expose that memory directly, letting
+ * callers fill or drain the rings without an intermediate copy.
+ *
+ * Spans are contiguous regions; when the data wraps, a second span call
+ * after committing returns the remainder. A stream is not thread-safe.
+ */
+
+/**
+ * Create a stream.
+ *
+ * @param enc       Encoder for the PCM -> AMBE direction (may be NULL).
+ * @param dec       Decoder for the AMBE -> PCM direction (may be NULL).
+ * @param frames    Ring capacity in frames for each ring (> 0).
+ *
+ * @return Stream handle, or NULL on failure (or if both enc and dec are
+ *         NULL). The codecs are borrowed and must outlive the stream.
+ */
+opendmr_stream_t *opendmr_stream_create(opendmr_encoder_t *enc,
+                                        opendmr_decoder_t *dec,
+                                        size_t frames);
+
+/**
+ * Destroy a stream (the borrowed codecs are not affected).
+ *
+ * @param s Stream (may be NULL).
+ */
+void opendmr_stream_destroy(opendmr_stream_t *s);
+
+/**
+ * Discard all buffered data (codec state is not reset).
+ *
+ * @param s Stream.
+ */
+void opendmr_stream_reset(opendmr_stream_t *s);
+
+/**
+ * Push PCM samples for encoding.
+ *
+ * @return Number of samples accepted; fewer than requested only when the
+ *         AMBE output ring is full and must be drained first.
+ */
+size_t opendmr_stream_push_pcm(opendmr_stream_t *s, const int16_t *pcm, size_t samples);
+
+/**
+ * Pull encoded AMBE bytes (any count; frames are 9 bytes each).
+ *
+ * @return Number of bytes copied.
+ */
+size_t opendmr_stream_pull_ambe(opendmr_stream_t *s, uint8_t *ambe, size_t bytes);
+
+/**
+ * Push AMBE bytes for decoding (any count, need not be frame aligned).
+ *
+ * @return Number of bytes accepted; fewer than requested only when the
+ *         PCM output ring is full and must be drained first.
+ */
+size_t opendmr_stream_push_ambe(opendmr_stream_t *s, const uint8_t *ambe, size_t bytes);
+
+/**
+ * Pull decoded PCM samples.
+ *
+ * @return Number of samples copied.
+ */
+size_t opendmr_stream_pull_pcm(opendmr_stream_t *s, int16_t *pcm, size_t samples);
+
+/**
+ * Zero-copy access. *_write_span() returns a contiguous writable region and
+ * its length; after filling n elements call *_write_commit(n), which runs
+ * the codec on any completed frames. *_read_span() returns a contiguous
+ * readable region; after consuming n elements call *_read_commit(n).
+ */
+int16_t *opendmr_stream_pcm_write_span(opendmr_stream_t *s, size_t *samples);
+void opendmr_stream_pcm_write_commit(opendmr_stream_t *s, size_t samples);
+const uint8_t *opendmr_stream_ambe_read_span(opendmr_stream_t *s, size_t *bytes);
+void opendmr_stream_ambe_read_commit(opendmr_stream_t *s, size_t bytes);
+
+uint8_t *opendmr_stream_ambe_write_span(opendmr_stream_t *s, size_t *bytes);
+void opendmr_stream_ambe_write_commit(opendmr_stream_t *s, size_t bytes);
+const int16_t *opendmr_stream_pcm_read_span(opendmr_stream_t *s, size_t *samples);
+void opendmr_stream_pcm_read_commit(opendmr_stream_t *s, size_t samples);
+
+/**
+ * Number of encoded AMBE bytes / decoded PCM samples ready to pull.
+ */
+size_t opendmr_stream_ambe_available(const opendmr_stream_t *s);
+size_t opendmr_stream_pcm_available(const opendmr_stream_t *s);
+
+/**
+ * Total corrected bit errors reported for frames decoded by the stream.
+ */
+unsigned long opendmr_stream_errors(const opendmr_stream_t *s);
+
+/*
+ * ============================================================================
+ * Jitter Buffer API
+ * ============================================================================
+ *
+ * Reorders frames received over a packet network and releases one per
+ * frame period for decoding. Frames are keyed by a 16-bit sequence number
+ * (one per 20 ms frame, wrapping) and their arrival time.
+ *
+ * The playout delay follows the measured interarrival jitter (RFC 3550
+ * estimator): playout of a talkspurt starts once the target delay has been
+ * buffered, a frame is dropped when the buffer has stayed deeper than the
+ * target for a second, and the playout point is held back one frame when
+ * the due frame is missing and less than the target delay is buffered
+ * behind it. Missing frames are reported as lost, and the decode helper
+ * conceals them through opendmr_decode_lost(). When the buffer has been
+ * empty for longer than the target delay, or the due frame has been held
+ * back for longer than the maximum delay, the talkspurt is taken to have
+ * ended.
+ *
+ * Arrival and playout times are in microseconds on any monotonic clock,
+ * the same for both. A jitter buffer is not thread-safe.
+ */
+
+/* Result of taking a frame out of the jitter buffer */
+typedef enum {
+    OPENDMR_JB_IDLE = 0,        /* Nothing to play: no talkspurt, or still buffering */
+    OPENDMR_JB_FRAME,           /* The due frame was copied out */
+    OPENDMR_JB_LOST             /* The due frame is missing: conceal it */
+} opendmr_jb_result_t;
+
+/* Jitter buffer counters */
+typedef struct {
+    unsigned long frames;       /* Frames played */
+    unsigned long lost;         /* Frame periods concealed (missing frames) */
+    unsigned long late;         /* Frames that arrived after their playout time */
+    unsigned long duplicates;   /* Frames received more than once */
+    unsigned long overflows;    /* Frames too far ahead to hold */
+    unsigned long dropped;      /* Frames discarded to reduce the delay */
+    unsigned long stretched;    /* Frame periods added to the delay on underrun */
+    uint32_t jitter_us;         /* Current interarrival jitter estimate */
+    uint32_t target_frames;     /* Current target delay in frames */
+    uint64_t wait_us;           /* Total time played frames spent buffered */
+} opendmr_jitterbuf_stats_t;
+
+/**
+ * Create a jitter buffer.
+ *
+ * @param max_frames    Largest playout delay in frames (1 to 8192);
+ *                      frames more than twice this far ahead are refused.
+ *
+ * @return Jitter buffer, or NULL on failure.
+ */
+opendmr_jitterbuf_t *opendmr_jitterbuf_create(size_t max_frames);
+
+/**
+ * Destroy a jitter buffer.
+ *
+ * @param jb Jitter buffer (may be NULL).
+ */
+void opendmr_jitterbuf_destroy(opendmr_jitterbuf_t *jb);
+
+/**
+ * Discard all buffered frames and the jitter estimate, e.g. at the start
+ * of a new stream whose sequence numbers are unrelated (counters are kept).
+ *
+ * @param jb Jitter buffer.
+ */
+void opendmr_jitterbuf_reset(opendmr_jitterbuf_t *jb);
+
+/**
+ * Bound the adaptive delay.
+ *
+ * @param jb            Jitter buffer.
+ * @param min_frames    Smallest target delay in frames (default 1).
+ * @param max_frames    Largest target delay in frames, at most the value
+ *                      given to opendmr_jitterbuf_create() (the default).
+ */
+void opendmr_jitterbuf_set_delay(opendmr_jitterbuf_t *jb, size_t min_frames, size_t max_frames);
+
+/**
+ * Add a received frame.
+ *
+ * @param jb            Jitter buffer.
+ * @param seq           Frame sequence number.
+ * @param arrival_us    Arrival time.
+ * @param ambe          AMBE+2 frame (9 bytes).
+ *
+ * @return true if the frame was buffered, false if it was late, a
+ *         duplicate or too far ahead.
+ */
+bool opendmr_jitterbuf_put(opendmr_jitterbuf_t *jb, uint16_t seq, uint64_t arrival_us,
+                           const uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES]);
+
+/**
+ * Take the frame due for playout. Call once per frame period.
+ *
+ * @param jb        Jitter buffer.
+ * @param now_us    Current time.
+ * @param ambe      Output: the frame, written for OPENDMR_JB_FRAME only.
+ *
+ * @return What to play for this frame period.
+ */
+opendmr_jb_result_t opendmr_jitterbuf_get(opendmr_jitterbuf_t *jb, uint64_t now_us,
+                                          uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES]);
+
+/**
+ * Take the frame due for playout and decode or conceal it. Call once per
+ * frame period.
+ *
+ * @param jb        Jitter buffer.
+ * @param dec       Decoder for the stream.
+ * @param now_us    Current time.
+ * @param pcm       Output PCM buffer (160 samples, 16-bit signed); silence
+ *                  for OPENDMR_JB_IDLE.
+ * @param info      Optional: report of the decoded or concealed frame,
+ *                  not written for OPENDMR_JB_IDLE (may be NULL).
+ *
+ * @return What was played for this frame period.
+ */
+opendmr_jb_result_t opendmr_jitterbuf_decode(opendmr_jitterbuf_t *jb, opendmr_decoder_t *dec,
+                                             uint64_t now_us, int16_t pcm[OPENDMR_PCM_SAMPLES],
+                                             opendmr_frame_info_t *info);
+
+/**
+ * Read or clear the jitter buffer counters.
+ */
+void opendmr_jitterbuf_get_stats(const opendmr_jitterbuf_t *jb, opendmr_jitterbuf_stats_t *stats);
+void opendmr_jitterbuf_reset_stats(opendmr_jitterbuf_t *jb);
+
+/*
+ * ============================================================================
+ * Tick Scheduler API
+ * ============================================================================
+ *
+ * Paces many streams at one frame per 20 ms from a single periodic timer
+ * (a timerfd on Linux). Each tick, every frame that has come due across
+ * all streams is passed to one callback as a batch, ordered earliest
+ * deadline first. A frame's deadline is one frame period after its slot
+ * time; frames dispatched later are counted as late, which shows how
+ * close the process is to capacity.
+ *
+ * A scheduler is not thread-safe; run it from one thread.
+ */
+
+/* Scheduler counters */
+typedef struct {
+    unsigned long ticks;        /* Ticks processed */
+    unsigned long missed_ticks; /* Timer expirations lost to overrunning ticks */
+    unsigned long frames;       /* Frames dispatched */
+    unsigned long late_frames;  /* Frames dispatched after their deadline */
+    unsigned long deferred;     /* Frames held over by the batch limit */
+    unsigned long skipped;      /* Frames dropped resynchronising far-behind streams */
+    uint32_t max_late_us;       /* Worst lateness past the deadline */
+    uint32_t max_batch;         /* Largest batch dispatched */
+    uint64_t busy_us;           /* Total time spent in the batch callback */
+} opendmr_clock_stats_t;
+
+/**
+ * Batch callback.
+ *
+ * @param ctx       Context given to opendmr_clock_create().
+ * @param streams   Stream pointers of the due frames, earliest deadline
+ *                  first. A stream that is catching up may appear more
+ *                  than once, in frame order.
+ * @param count     Number of due frames.
+ */
+typedef void (*opendmr_clock_fn)(void *ctx, void *const *streams, size_t count);
+
+/**
+ * Create a scheduler.
+ *
+ * @param tick_us       Tick period: OPENDMR_FRAME_US, or a sub-tick down
+ *                      to 1000 us to spread streams with different phases.
+ * @param max_streams   Maximum number of registered streams.
+ * @param fn            Batch callback.
+ * @param ctx           Passed to fn.
+ *
+ * @return Scheduler, or NULL on failure. The timer starts running now.
+ */
+opendmr_clock_t *opendmr_clock_create(unsigned int tick_us, size_t max_streams,
+                                      opendmr_clock_fn fn, void *ctx);
+
+/**
+ * Destroy a scheduler.
+ *
+ * @param clk Scheduler (may be NULL).
+ */
+void opendmr_clock_destroy(opendmr_clock_t *clk);
+
+/**
+ * Register a stream.
+ *
+ * @param clk       Scheduler.
+ * @param stream    Caller's stream pointer, passed back in batches.
+ * @param phase_us  Offset of the stream's first frame from now (taken
+ *                  modulo OPENDMR_FRAME_US).
+ *
+ * @return Stream ID for opendmr_clock_remove(), or -1 if full.
+ */
+int opendmr_clock_add(opendmr_clock_t *clk, void *stream, unsigned int phase_us);
+
+/**
+ * Unregister a stream. May be called from the batch callback; frames of the
+ * stream already in the current batch are still delivered.
+ *
+ * @param clk   Scheduler.
+ * @param id    ID returned by opendmr_clock_add().
+ */
+void opendmr_clock_remove(opendmr_clock_t *clk, int id);
+
+/**
+ * Cap the frames dispatched per tick (0 = unlimited, the default). When
+ * more are due, the earliest deadlines go first and the rest wait for the
+ * next tick.
+ *
+ * @param clk           Scheduler.
+ * @param max_frames    Batch limit.
+ */
+void opendmr_clock_set_batch_limit(opendmr_clock_t *clk, size_t max_frames);
+
+/**
+ * Timer file descriptor, readable when a tick is pending, for use with
+ * poll()/epoll. -1 on platforms without timerfd.
+ *
+ * @param clk Scheduler.
+ */
+int opendmr_clock_fd(const opendmr_clock_t *clk);
+
+/**
+ * Wait for the next tick (returns at once if one is pending) and dispatch
+ * the due frames.
+ *
+ * @param clk Scheduler.
+ *
+ * @return Number of frames dispatched.
+ */
+size_t opendmr_clock_tick(opendmr_clock_t *clk);
+
+/**
+ * Read or clear the scheduler counters.
+ */
+void opendmr_clock_get_stats(const opendmr_clock_t *clk, opendmr_clock_stats_t *stats);
+void opendmr_clock_reset_stats(opendmr_clock_t *clk);
+
+/*
+ * ============================================================================
+ * Conference Mixer API
+ * ============================================================================
+ *
+ * Builds the N-minus-one mix for every leg of a conference: each leg hears
+ * the sum of all other legs. Input frames come straight from
+ * opendmr_decode_f32_ex() and outputs go straight to opendmr_encode_f32(),
+ * with no 16-bit conversion in between.
+ *
+ * Legs that are not talking (no frame, a silent frame or a silence frame
+ * according to the decoder's frame info) are left out of the sum, so the
+ * mixing work follows the number of active talkers. Every output leg has
+ * its own peak limiter and is clipped to +/-1.0.
+ *
+ * A mixer is not thread-safe; use one per conference.
+ */
+
+/**
+ * Create a mixer.
+ *
+ * @param max_legs  Maximum number of legs per mix.
+ *
+ * @return Mixer, or NULL on failure.
+ */
+opendmr_mixer_t *opendmr_mixer_create(size_t max_legs);
+
+/**
+ * Destroy a mixer.
+ *
+ * @param mix Mixer (may be NULL).
+ */
+void opendmr_mixer_destroy(opendmr_mixer_t *mix);
+
+/**
+ * Configure the output limiters.
+ *
+ * @param mix           Mixer.
+ * @param threshold     Peak level the limiter holds outputs to (0 < t <= 1.0,
+ *                      default 0.891, -1 dBFS).
+ * @param release_ms    Time constant of the gain recovery (default 100 ms;
+ *                      0 = recover within one frame).
+ */
+void opendmr_mixer_set_limiter(opendmr_mixer_t *mix, float threshold, float release_ms);
+
+/**
+ * Mix one frame for every leg.
+ *
+ * @param mix   Mixer.
+ * @param in    Decoded frame of each leg (160 samples), or NULL for a leg
+ *              with no audio this frame.
+ * @param info  Optional: frame info of each leg from
+ *              opendmr_decode_f32_ex() (may be NULL to treat every frame
+ *              as voice).
+ * @param out   Output frame of each leg (160 samples, within +/-1.0).
+ *              Must not overlap the inputs.
+ * @param legs  Number of legs (at most max_legs). Leg i keeps its limiter
+ *              state between calls.
+ *
+ * @return Number of talking legs that were mixed.
+ */
+size_t opendmr_mixer_mix(opendmr_mixer_t *mix,
+                         const float *const *in,
+                         const opendmr_frame_info_t *info,
+                         float *const *out,
+                         size_t legs);
+
+/**
+ * Reset the limiter of one leg (e.g., when a participant joins), or of
+ * every leg.
+ */
+void opendmr_mixer_reset_leg(opendmr_mixer_t *mix, size_t leg);
+void opendmr_mixer_reset(opendmr_mixer_t *mix);
+
+/*
+ * ============================================================================
+ * Memory Placement API
+ * ============================================================================
+ *
+ * Decoder and encoder instances are single flat objects. Instead of using
+ * the *_create() functions they may be constructed in caller-owned memory
+ * (static arenas, shared memory, huge pages) with the *_init() functions.
+ *
+ * Instances created with *_init() hold no other resources: they must NOT be
+ * passed to *_destroy(); the caller simply releases the memory when done.
+ */
+
+/**
+ * Get the number of bytes required for a decoder instance.
+ *
+ * @return Size in bytes.
+ */
+size_t opendmr_decoder_size(void);
+
+/**
+ * Get the required alignment of a decoder instance.
+ *
+ * @return Alignment in bytes (a power of two).
+ */
+size_t opendmr_decoder_align(void);
+
+/**
+ * Initialise a decoder instance in caller-owned memory.
+ *
+ * @param mem   At least opendmr_decoder_size() bytes, aligned to
+ *              opendmr_decoder_align().
+ *
+ * @return Decoder handle (equal to mem), or NULL if mem is NULL or
+ *         misaligned.
+ */
+opendmr_decoder_t *opendmr_decoder_init(void *mem);
+
+/**
+ * Get the number of bytes required for an encoder instance.
+ *
+ * @return Size in bytes.
+ */
+size_t opendmr_encoder_size(void);
+
+/**
+ * Get the required alignment of an encoder instance.
+ *
+ * @return Alignment in bytes (a power of two).
+ */
+size_t opendmr_encoder_align(void);
+
+/**
+ * Initialise an encoder instance in caller-owned memory.
+ *
+ * @param mem   At least opendmr_encoder_size() bytes, aligned to
+ *              opendmr_encoder_align().
+ *
+ * @return Encoder handle (equal to mem), or NULL if mem is NULL or
+ *         misaligned.
+ */
+opendmr_encoder_t *opendmr_encoder_init(void *mem);
+
+/* Allocator hooks */
+typedef void *(*opendmr_alloc_fn)(size_t size);
+typedef void (*opendmr_free_fn)(void *ptr);
+
+/**
+ * Replace the allocator used for all internal allocations.
+ *
+ * This covers the *_create() functions and the per-thread synthesis
+ * plans the decoder allocates on the first decode in each thread (see
+ * opendmr_thread_release()). The allocator must return memory aligned
+ * for any standard type.
+ *
+ * @param alloc_fn  Allocation function (NULL restores malloc/free).
+ * @param free_fn   Matching release function (NULL restores malloc/free).
+ *
+ * Call before creating any instance. The hooks must not change while
+ * objects allocated through them are still alive.
+ */
+void opendmr_set_allocator(opendmr_alloc_fn alloc_fn, opendmr_free_fn free_fn);
+
+/**
+ * Release the calling thread's synthesis plans.
+ *
+ * Decoding allocates FFT plans per thread (one per output rate used)
+ * and keeps them for the life of the thread. Call this before a
+ * decoding thread exits, or before changing the allocator, to return
+ * them; a later decode in the same thread allocates them again.
+ */
+void opendmr_thread_release(void);
+
 /*
  * ============================================================================
  * Utility Functions
@@ -0,0 +1,159 @@
+/*
+ * OpenDMR - Open Source DMR (AMBE+2) Vocoder Library
+ *
+ * DMR voice bursts: three AMBE+2 frames interleaved around the 48-bit
+ * sync/EMB field of a 264-bit burst.
+ *
+ * Frame 1 occupies burst bits 0-71, frame 2 bits 72-107 and 156-191, and
+ * frame 3 bits 192-263. Within its 72 bits a frame is interleaved by the
+ * DMR_A/B/C tables of the encoder, which turn out to be an 18 x 4 bit
+ * transpose: DVSI bit j is sent as bit 4 * (j % 18) + j / 18. Each
+ * on-air byte therefore holds two bits of each of the four 18-bit DVSI
+ * quarters, and a 256-entry table regroups them, so a frame is
+ * (de)interleaved one byte at a time.
+ */
+
+#include "opendmr.h"
+#include "opendmr_internal.h"
+#include <cstring>
+
+/* Bits of one DVSI quarter (72 / 4) */
+#define QUARTER_BITS        18
+#define QUARTER_MASK        0x3FFFFU
+
+/* Byte offset of frame 3 in the burst */
+#define FRAME3_OFFSET       24
+
+/*
+ * split[v] regroups on-air byte v as four 2-bit fields, DVSI quarter 0 in
+ * the top bits; merge[] is its inverse.
+ */
+static uint8_t split[256];
+static uint8_t merge[256];
+
+static bool build_tables(void)
+{
+    for (int v = 0; v < 256; v++) {
+        int s = 0;
+        for (int r = 0; r < 4; r++) {
+            int pair = (((v >> (7 - r)) & 1) << 1) | ((v >> (3 - r)) & 1);
+            s |= pair << (6 - 2 * r);
+        }
+        split[v] = static_cast<uint8_t>(s);
+        merge[s] = static_cast<uint8_t>(v);
+    }
+    return true;
+}
+
+/* 72 on-air bits -> DVSI frame */
+static void deinterleave(const uint8_t air[OPENDMR_AMBE_FRAME_BYTES],
+                         uint8_t frame[OPENDMR_AMBE_FRAME_BYTES])
+{
+    uint64_t w0 = 0, w1 = 0, w2 = 0, w3 = 0;
+    for (int i = 0; i < OPENDMR_AMBE_FRAME_BYTES; i++) {
+        unsigned int s = split[air[i]];
+        w0 = (w0 << 2) | (s >> 6);
+        w1 = (w1 << 2) | ((s >> 4) & 3);
+        w2 = (w2 << 2) | ((s >> 2) & 3);
+        w3 = (w3 << 2) | (s & 3);
+    }
+
+    /* Quarters in order; the first 64 bits, then the last byte */
+    uint64_t top = (w0 << 46) | (w1 << 28) | (w2 << 10) | (w3 >> 8);
+    for (int i = 0; i < 8; i++)
+        frame[i] = static_cast<uint8_t>(top >> (56 - 8 * i));
+    frame[8] = static_cast<uint8_t>(w3);
+}
+
+/* DVSI frame -> 72 on-air bits */
+static void interleave(const uint8_t frame[OPENDMR_AMBE_FRAME_BYTES],
+                       uint8_t air[OPENDMR_AMBE_FRAME_BYTES])
+{
+    uint64_t top = 0;
+    for (int i = 0; i < 8; i++)
+        top = (top << 8) | frame[i];
+
+    uint64_t w0 = top >> 46;
+    uint64_t w1 = (top >> 28) & QUARTER_MASK;
+    uint64_t w2 = (top >> 10) & QUARTER_MASK;
+    uint64_t w3 = ((top & 0x3FF) << 8) | frame[8];
+
+    for (int i = 0; i < OPENDMR_AMBE_FRAME_BYTES; i++) {
+        int shift = QUARTER_BITS - 2 - 2 * i;
+        unsigned int s = static_cast<unsigned int>(((w0 >> shift) & 3) << 6 |
+                                                   ((w1 >> shift) & 3) << 4 |
+                                                   ((w2 >> shift) & 3) << 2 |
+                                                   ((w3 >> shift) & 3));
+        air[i] = merge[s];
+    }
+}
+
+void opendmr_burst_to_frames(const uint8_t burst[OPENDMR_BURST_BYTES],
+                             uint8_t frames[OPENDMR_BURST_FRAMES * OPENDMR_AMBE_FRAME_BYTES])
+{
+    opendmr_build_once<build_tables>();
+
+    /* Frame 2 is split by the sync field: bytes 9-12, two nibbles, 20-23 */
+    uint8_t air[OPENDMR_AMBE_FRAME_BYTES];
+    memcpy(air, burst + 9, 4);
+    air[4] = static_cast<uint8_t>((burst[13] & 0xF0) | (burst[19] & 0x0F));
+    memcpy(air + 5, burst + 20, 4);
+
+    deinterleave(burst, frames);
+    deinterleave(air, frames + OPENDMR_AMBE_FRAME_BYTES);
+    deinterleave(burst + FRAME3_OFFSET, frames + 2 * OPENDMR_AMBE_FRAME_BYTES);
+}
+
+void opendmr_frames_to_burst(const uint8_t frames[OPENDMR_BURST_FRAMES * OPENDMR_AMBE_FRAME_BYTES],
+                             uint8_t burst[OPENDMR_BURST_BYTES])
+{
+    opendmr_build_once<build_tables>();
+
+    uint8_t air[OPENDMR_AMBE_FRAME_BYTES];
+    interleave(frames, burst);
+    interleave(frames + 2 * OPENDMR_AMBE_FRAME_BYTES, burst + FRAME3_OFFSET);
+
+    /* Bits 108-155 (sync/EMB) are left as they are */
+    interleave(frames + OPENDMR_AMBE_FRAME_BYTES, air);
+    memcpy(burst + 9, air, 4);
+    burst[13] = static_cast<uint8_t>((air[4] & 0xF0) | (burst[13] & 0x0F));
+    burst[19] = static_cast<uint8_t>((burst[19] & 0xF0) | (air[4] & 0x0F));
+    memcpy(burst + 20, air + 5, 4);
+}
+
+bool opendmr_decode_burst(opendmr_decoder_t *dec,
+                          const uint8_t burst[OPENDMR_BURST_BYTES],
+                          int16_t pcm[OPENDMR_BURST_SAMPLES],
+                          opendmr_frame_info_t info[OPENDMR_BURST_FRAMES])
+{
+    if (!dec || !burst || !pcm)
+        return false;
+
+    uint8_t frames[OPENDMR_BURST_FRAMES * OPENDMR_AMBE_FRAME_BYTES];
+    opendmr_burst_to_frames(burst, frames);
+
+    for (int k = 0; k < OPENDMR_BURST_FRAMES; k++) {
+        if (!opendmr_decode_ex(dec, frames + k * OPENDMR_AMBE_FRAME_BYTES,
+                               pcm + k * OPENDMR_PCM_SAMPLES, info ? &info[k] : nullptr))
+            return false;
+    }
+    return true;
+}
+
+bool opendmr_encode_burst(opendmr_encoder_t *enc,
+                          const int16_t pcm[OPENDMR_BURST_SAMPLES],
+                          uint8_t burst[OPENDMR_BURST_BYTES])
+{
+    if (!enc || !pcm || !burst)
+        return false;
+
+    uint8_t frames[OPENDMR_BURST_FRAMES * OPENDMR_AMBE_FRAME_BYTES];
+    for (int k = 0; k < OPENDMR_BURST_FRAMES; k++) {
+        if (!opendmr_encode(enc, pcm + k * OPENDMR_PCM_SAMPLES,
+                            frames + k * OPENDMR_AMBE_FRAME_BYTES))
+            return false;
+    }
+
+    opendmr_frames_to_burst(frames, burst);
+    return true;
+}
@@ -0,0 +1,272 @@
+/*
+ * OpenDMR - Open Source DMR (AMBE+2) Vocoder Library
+ *
+ * Tick scheduler: paces any number of streams at one frame per 20 ms from
+ * a single periodic timer. Every tick collects the frames that have come
+ * due across all streams and hands them to the caller as one batch,
+ * earliest deadline first, so a controller wakes once per tick instead of
+ * once per stream and frame.
+ *
+ * A frame falls due at its stream's slot time and must be dispatched
+ * within one frame period of it; later dispatches are counted as late.
+ * Streams more than MAX_CATCHUP frames behind are resynchronised rather
+ * than replayed.
+ */
+
+#include "opendmr.h"
+#include "opendmr_internal.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/timerfd.h>
+#endif
+
+/* Frames one stream may contribute to a single tick when catching up */
+#define MAX_CATCHUP         4
+
+/* Shortest supported tick */
+#define MIN_TICK_US         1000
+
+struct clock_slot {
+    void *stream;
+    uint64_t due;               /* Slot time of the next frame (us) */
+    bool active;
+};
+
+/* One due frame; ordering by slot time is EDF (deadline = due + period) */
+struct clock_entry {
+    uint64_t due;
+    uint32_t slot;
+
+    bool operator<(const clock_entry &o) const
+    {
+        return due != o.due ? due < o.due : slot < o.slot;
+    }
+};
+
+struct opendmr_clock {
+    opendmr_clock_fn fn;
+    void *ctx;
+    uint32_t tick_us;
+    size_t batch_limit;         /* 0 = unlimited */
+
+    int fd;                     /* timerfd, or -1 where unavailable */
+    uint64_t next_tick;         /* Fallback timer: next expiry (us) */
+
+    size_t max_streams;
+    clock_slot *slots;
+    clock_entry *entries;       /* max_streams * MAX_CATCHUP */
+    void **batch;               /* Same capacity, passed to fn */
+
+    opendmr_clock_stats_t stats;
+};
+
+static uint64_t now_us(void)
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000u + static_cast<uint64_t>(ts.tv_nsec) / 1000u;
+}
+
+opendmr_clock_t *opendmr_clock_create(unsigned int tick_us, size_t max_streams,
+                                      opendmr_clock_fn fn, void *ctx)
+{
+    if (!fn || max_streams == 0 || tick_us < MIN_TICK_US || tick_us > OPENDMR_FRAME_US)
+        return nullptr;
+
+    opendmr_clock_t *clk = static_cast<opendmr_clock_t *>(
+        opendmr_mem_alloc(sizeof(opendmr_clock_t)));
+    if (!clk)
+        return nullptr;
+    memset(clk, 0, sizeof(*clk));
+    clk->fd = -1;
+
+    size_t cap = max_streams * MAX_CATCHUP;
+    clk->slots = static_cast<clock_slot *>(opendmr_mem_alloc(max_streams * sizeof(clock_slot)));
+    clk->entries = static_cast<clock_entry *>(opendmr_mem_alloc(cap * sizeof(clock_entry)));
+    clk->batch = static_cast<void **>(opendmr_mem_alloc(cap * sizeof(void *)));
+    if (!clk->slots || !clk->entries || !clk->batch) {
+        opendmr_clock_destroy(clk);
+        return nullptr;
+    }
+    memset(clk->slots, 0, max_streams * sizeof(clock_slot));
+
+    clk->fn = fn;
+    clk->ctx = ctx;
+    clk->tick_us = tick_us;
+    clk->max_streams = max_streams;
+
+#ifdef __linux__
+    clk->fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    if (clk->fd < 0) {
+        opendmr_clock_destroy(clk);
+        return nullptr;
+    }
+    itimerspec its;
+    its.it_interval.tv_sec = tick_us / 1000000u;
+    its.it_interval.tv_nsec = static_cast<long>(tick_us % 1000000u) * 1000L;
+    its.it_value = its.it_interval;
+    timerfd_settime(clk->fd, 0, &its, nullptr);
+#endif
+    clk->next_tick = now_us() + tick_us;
+    return clk;
+}
+
+void opendmr_clock_destroy(opendmr_clock_t *clk)
+{
+    if (!clk)
+        return;
+
+    if (clk->fd >= 0)
+        close(clk->fd);
+    opendmr_mem_free(clk->slots);
+    opendmr_mem_free(clk->entries);
+    opendmr_mem_free(clk->batch);
+    opendmr_mem_free(clk);
+}
+
+int opendmr_clock_add(opendmr_clock_t *clk, void *stream, unsigned int phase_us)
+{
+    if (!clk)
+        return -1;
+
+    for (size_t i = 0; i < clk->max_streams; i++) {
+        clock_slot *s = &clk->slots[i];
+        if (!s->active) {
+            s->stream = stream;
+            s->due = now_us() + phase_us % OPENDMR_FRAME_US;
+            s->active = true;
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void opendmr_clock_remove(opendmr_clock_t *clk, int id)
+{
+    if (clk && id >= 0 && static_cast<size_t>(id) < clk->max_streams)
+        clk->slots[id].active = false;
+}
+
+void opendmr_clock_set_batch_limit(opendmr_clock_t *clk, size_t max_frames)
+{
+    if (clk)
+        clk->batch_limit = max_frames;
+}
+
+int opendmr_clock_fd(const opendmr_clock_t *clk)
+{
+    return clk ? clk->fd : -1;
+}
+
+/* Block until the next tick; returns the number of expirations */
+static uint64_t wait_tick(opendmr_clock_t *clk)
+{
+    if (clk->fd >= 0) {
+        uint64_t expirations = 0;
+        while (read(clk->fd, &expirations, sizeof(expirations)) < 0) {
+            if (errno != EINTR)
+                return 1;
+        }
+        return expirations;
+    }
+
+    uint64_t now = now_us();
+    if (now < clk->next_tick) {
+        uint64_t wait = clk->next_tick - now;
+        timespec ts;
+        ts.tv_sec = static_cast<time_t>(wait / 1000000u);
+        ts.tv_nsec = static_cast<long>(wait % 1000000u) * 1000L;
+        while (nanosleep(&ts, &ts) < 0 && errno == EINTR) {
+        }
+        now = clk->next_tick;
+    }
+    uint64_t expirations = (now - clk->next_tick) / clk->tick_us + 1;
+    clk->next_tick += expirations * clk->tick_us;
+    return expirations;
+}
+
+size_t opendmr_clock_tick(opendmr_clock_t *clk)
+{
+    if (!clk)
+        return 0;
+
+    uint64_t expirations = wait_tick(clk);
+    uint64_t now = now_us();
+
+    clk->stats.ticks++;
+    if (expirations > 1)
+        clk->stats.missed_ticks += expirations - 1;
+
+    /* Collect every due frame */
+    size_t n = 0;
+    for (size_t i = 0; i < clk->max_streams; i++) {
+        clock_slot *s = &clk->slots[i];
+        if (!s->active || s->due > now)
+            continue;
+
+        uint64_t behind = (now - s->due) / OPENDMR_FRAME_US + 1;
+        if (behind > MAX_CATCHUP) {
+            uint64_t skip = behind - MAX_CATCHUP;
+            s->due += skip * OPENDMR_FRAME_US;
+            clk->stats.skipped += skip;
+        }
+        for (uint64_t t = s->due; t <= now; t += OPENDMR_FRAME_US) {
+            clk->entries[n].due = t;
+            clk->entries[n].slot = static_cast<uint32_t>(i);
+            n++;
+        }
+    }
+    if (n == 0)
+        return 0;
+
+    /* Earliest deadline first; under a batch limit the rest wait a tick */
+    size_t count = n;
+    if (clk->batch_limit && count > clk->batch_limit) {
+        count = clk->batch_limit;
+        std::partial_sort(clk->entries, clk->entries + count, clk->entries + n);
+        clk->stats.deferred += n - count;
+    } else {
+        std::sort(clk->entries, clk->entries + n);
+    }
+
+    for (size_t k = 0; k < count; k++) {
+        const clock_entry *e = &clk->entries[k];
+        clock_slot *s = &clk->slots[e->slot];
+
+        uint64_t deadline = e->due + OPENDMR_FRAME_US;
+        if (now > deadline) {
+            uint64_t late = now - deadline;
+            clk->stats.late_frames++;
+            if (late > clk->stats.max_late_us)
+                clk->stats.max_late_us = static_cast<uint32_t>(late);
+        }
+        /* A stream's frames are dispatched in slot order */
+        s->due = e->due + OPENDMR_FRAME_US;
+        clk->batch[k] = s->stream;
+    }
+
+    clk->stats.frames += count;
+    if (count > clk->stats.max_batch)
+        clk->stats.max_batch = static_cast<uint32_t>(count);
+
+    clk->fn(clk->ctx, clk->batch, count);
+    clk->stats.busy_us += now_us() - now;
+    return count;
+}
+
+void opendmr_clock_get_stats(const opendmr_clock_t *clk, opendmr_clock_stats_t *stats)
+{
+    if (clk && stats)
+        *stats = clk->stats;
+}
+
+void opendmr_clock_reset_stats(opendmr_clock_t *clk)
+{
+    if (clk)
+        memset(&clk->stats, 0, sizeof(clk->stats));
+}
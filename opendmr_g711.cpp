@@ -0,0 +1,148 @@
+/*
+ * OpenDMR - Open Source DMR (AMBE+2) Vocoder Library
+ *
+ * G.711 companding tables for opendmr_decode_g711() and
+ * opendmr_encode_g711().
+ *
+ * Both directions are table lookups. Expansion maps a code to its 16-bit
+ * linear value through a 256-entry table, which the encoder reads inside
+ * its DC removal filter. Compression indexes a table by the 16-bit sample
+ * shifted down to the law's resolution (14 bits for mu-law, 13 for
+ * A-law), so the decoder's output stage goes from float to code with one
+ * load per sample after the usual gain and clip.
+ *
+ * The tables follow the ITU-T G.711 reference conversions (as in the Sun
+ * g711.c) and are built once, on first use, and shared.
+ */
+
+#include "opendmr.h"
+#include "opendmr_internal.h"
+
+/* mu-law: bias added before segment search, and largest 14-bit magnitude */
+#define ULAW_BIAS           0x84
+#define ULAW_CLIP           8159
+
+/* Compression table sizes: one entry per 14-bit or 13-bit sample */
+#define ULAW_SIZE           16384
+#define ALAW_SIZE           8192
+
+static int16_t ulaw_expand[256];
+static int16_t alaw_expand[256];
+static uint8_t ulaw_compress[ULAW_SIZE];   /* Indexed by (pcm >> 2) + 8192 */
+static uint8_t alaw_compress[ALAW_SIZE];   /* Indexed by (pcm >> 3) + 4096 */
+
+/* Segment end points of the 14-bit (mu-law) and 13-bit (A-law) scales */
+static const int seg_uend[8] = { 0x3F, 0x7F, 0xFF, 0x1FF, 0x3FF, 0x7FF, 0xFFF, 0x1FFF };
+static const int seg_aend[8] = { 0x1F, 0x3F, 0x7F, 0xFF, 0x1FF, 0x3FF, 0x7FF, 0xFFF };
+
+static int segment(int val, const int *end)
+{
+    for (int i = 0; i < 8; i++) {
+        if (val <= end[i])
+            return i;
+    }
+    return 8;
+}
+
+/* 14-bit sample to mu-law */
+static uint8_t linear_to_ulaw(int val)
+{
+    int mask;
+    if (val < 0) {
+        val = -val;
+        mask = 0x7F;
+    } else {
+        mask = 0xFF;
+    }
+    if (val > ULAW_CLIP)
+        val = ULAW_CLIP;
+    val += ULAW_BIAS >> 2;
+
+    int seg = segment(val, seg_uend);
+    if (seg >= 8)
+        return static_cast<uint8_t>(0x7F ^ mask);
+    return static_cast<uint8_t>(((seg << 4) | ((val >> (seg + 1)) & 0x0F)) ^ mask);
+}
+
+/* 13-bit sample to A-law */
+static uint8_t linear_to_alaw(int val)
+{
+    int mask;
+    if (val >= 0) {
+        mask = 0xD5;
+    } else {
+        mask = 0x55;
+        val = -val - 1;
+    }
+
+    int seg = segment(val, seg_aend);
+    if (seg >= 8)
+        return static_cast<uint8_t>(0x7F ^ mask);
+
+    int aval = seg << 4;
+    aval |= seg < 2 ? (val >> 1) & 0x0F : (val >> seg) & 0x0F;
+    return static_cast<uint8_t>(aval ^ mask);
+}
+
+static int16_t ulaw_to_linear(uint8_t code)
+{
+    int u = ~code & 0xFF;
+    int t = ((u & 0x0F) << 3) + ULAW_BIAS;
+    t <<= (u & 0x70) >> 4;
+    return static_cast<int16_t>(u & 0x80 ? ULAW_BIAS - t : t - ULAW_BIAS);
+}
+
+static int16_t alaw_to_linear(uint8_t code)
+{
+    int a = code ^ 0x55;
+    int t = (a & 0x0F) << 4;
+    int seg = (a & 0x70) >> 4;
+    if (seg == 0)
+        t += 8;
+    else if (seg == 1)
+        t += 0x108;
+    else
+        t = (t + 0x108) << (seg - 1);
+    return static_cast<int16_t>(a & 0x80 ? t : -t);
+}
+
+static bool build_tables(void)
+{
+    for (int c = 0; c < 256; c++) {
+        ulaw_expand[c] = ulaw_to_linear(static_cast<uint8_t>(c));
+        alaw_expand[c] = alaw_to_linear(static_cast<uint8_t>(c));
+    }
+    for (int i = 0; i < ULAW_SIZE; i++)
+        ulaw_compress[i] = linear_to_ulaw(i - ULAW_SIZE / 2);
+    for (int i = 0; i < ALAW_SIZE; i++)
+        alaw_compress[i] = linear_to_alaw(i - ALAW_SIZE / 2);
+    return true;
+}
+
+const int16_t *opendmr_g711_expand_table(opendmr_g711_law_t law)
+{
+    opendmr_build_once<build_tables>();
+
+    switch (law) {
+    case OPENDMR_G711_ULAW:
+        return ulaw_expand;
+    case OPENDMR_G711_ALAW:
+        return alaw_expand;
+    }
+    return nullptr;
+}
+
+void opendmr_g711_compress(const float in[OPENDMR_PCM_SAMPLES], float scale,
+                           opendmr_g711_law_t law, uint8_t out[OPENDMR_PCM_SAMPLES])
+{
+    opendmr_build_once<build_tables>();
+
+    /* Gain, clip and truncation exactly as mbe_floattoshort(), then one load */
+    const uint8_t *table = law == OPENDMR_G711_ALAW ? alaw_compress : ulaw_compress;
+    const int shift = law == OPENDMR_G711_ALAW ? 3 : 2;
+    const int offset = law == OPENDMR_G711_ALAW ? ALAW_SIZE / 2 : ULAW_SIZE / 2;
+
+    for (int i = 0; i < OPENDMR_PCM_SAMPLES; i++) {
+        out[i] = table[(opendmr_clip_sample(in[i] * scale) >> shift) + offset];
+    }
+}
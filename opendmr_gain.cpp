@@ -0,0 +1,231 @@
+/*
+ * OpenDMR - Open Source DMR (AMBE+2) Vocoder Library
+ *
+ * Parameter-domain gain rewriter: changes the level of AMBE+2 frames by
+ * re-quantising the differential gain index b2, without vocoding.
+ *
+ * The decoder reconstructs the frame gain as
+ *     gamma = AmbeDg[b2] + 0.5 * gamma_prev
+ * and every band magnitude follows gamma one for one (log2 units), so a
+ * level change of d dB is a gamma offset of d / 6.02. Because of the
+ * prediction, b2 is chosen closed-loop against the gamma the far-end
+ * decoder will reconstruct from the rewritten stream, not the input one.
+ */
+
+#include "opendmr.h"
+#include "opendmr_internal.h"
+#include "cgolay24128.h"
+#include "ambe_prng.h"
+#include "ambe3600x2450_const.h"
+#include <cmath>
+#include <cstring>
+
+/* dB per log2 amplitude unit: 20 * log10(2) */
+#define DB_PER_LOG2         6.0206f
+
+/* Consecutive repeats after which the decoder mutes and resets */
+#define MAX_REPEATS         3
+
+/* AGC level tracker smoothing (per voice frame) */
+#define AGC_SMOOTHING       0.05f
+
+struct opendmr_gain {
+    float offset_db;            /* Fixed offset (AGC disabled) */
+
+    bool agc;
+    float agc_target_db;
+    float agc_max_db;
+    float agc_level_db;         /* Smoothed input level of voice frames */
+    bool agc_primed;
+
+    float gamma_in;             /* Decoder gain predictor, input stream */
+    float gamma_out;            /* Decoder gain predictor, output stream */
+    int repeats;                /* Consecutive concealed frames */
+};
+
+/* Frame types as seen by mbe_decodeAmbe2450Parms */
+enum gain_frame_kind {
+    KIND_VOICE,                 /* Voice or silence: carries b2 */
+    KIND_ERASURE,               /* b0 120-123, or b0 126/127 tone */
+    KIND_TONE                   /* Tone frame (C0 tone pattern) */
+};
+
+static gain_frame_kind frame_kind(uint32_t c0, uint32_t c)
+{
+    /* Same checks and order as mbe_decodeAmbe2450Parms */
+    if (((c0 >> 6) & 0x3f) == 63 && (c & 0xf) == 0)
+        return KIND_TONE;
+
+    int b0 = static_cast<int>(((c0 >> 8) & 0xf) << 3 | ((c >> 9) & 0x7));
+    if (b0 >= 120 && b0 <= 123)
+        return KIND_ERASURE;
+    if (b0 == 126 || b0 == 127)
+        return KIND_ERASURE;
+
+    return KIND_VOICE;
+}
+
+static void reset_predictors(opendmr_gain_t *g)
+{
+    g->gamma_in = 0.0f;
+    g->gamma_out = 0.0f;
+    g->repeats = 0;
+}
+
+/* The decoder repeats the previous parameters; after too many it resets */
+static void conceal(opendmr_gain_t *g)
+{
+    if (++g->repeats > MAX_REPEATS)
+        reset_predictors(g);
+}
+
+/* Offset to apply to a voice frame whose input gain is gamma_in */
+static float target_offset_db(opendmr_gain_t *g, bool is_silence)
+{
+    if (!g->agc)
+        return g->offset_db;
+
+    /* Track talker level on speech only, so background noise is not pumped */
+    if (!is_silence) {
+        float level = DB_PER_LOG2 * g->gamma_in;
+        if (!g->agc_primed) {
+            g->agc_level_db = level;
+            g->agc_primed = true;
+        } else {
+            g->agc_level_db += AGC_SMOOTHING * (level - g->agc_level_db);
+        }
+    }
+    if (!g->agc_primed)
+        return 0.0f;
+
+    float offset = g->agc_target_db - g->agc_level_db;
+    if (offset > g->agc_max_db)
+        offset = g->agc_max_db;
+    else if (offset < -g->agc_max_db)
+        offset = -g->agc_max_db;
+    return offset;
+}
+
+static int quantise_gain(float delta)
+{
+    int best = 0;
+    float best_err = fabsf(delta - AmbeDg[0]);
+    for (int i = 1; i < 32; i++) {
+        float err = fabsf(delta - AmbeDg[i]);
+        if (err < best_err) {
+            best_err = err;
+            best = i;
+        }
+    }
+    return best;
+}
+
+opendmr_gain_t *opendmr_gain_create(void)
+{
+    opendmr_gain_t *g = static_cast<opendmr_gain_t *>(
+        opendmr_mem_alloc(sizeof(opendmr_gain_t)));
+    if (!g)
+        return nullptr;
+
+    memset(g, 0, sizeof(*g));
+    g->agc_max_db = 12.0f;
+    return g;
+}
+
+void opendmr_gain_destroy(opendmr_gain_t *g)
+{
+    opendmr_mem_free(g);
+}
+
+void opendmr_gain_reset(opendmr_gain_t *g)
+{
+    if (g) {
+        reset_predictors(g);
+        g->agc_primed = false;
+        g->agc_level_db = 0.0f;
+    }
+}
+
+void opendmr_gain_set_offset(opendmr_gain_t *g, float gain_db)
+{
+    if (g)
+        g->offset_db = gain_db;
+}
+
+void opendmr_gain_set_agc(opendmr_gain_t *g, bool enable,
+                          float target_db, float max_gain_db)
+{
+    if (!g)
+        return;
+
+    g->agc = enable;
+    g->agc_target_db = target_db;
+    g->agc_max_db = max_gain_db < 0.0f ? -max_gain_db : max_gain_db;
+    g->agc_primed = false;
+}
+
+bool opendmr_gain_process(opendmr_gain_t *g,
+                          const uint8_t in[OPENDMR_AMBE_FRAME_BYTES],
+                          uint8_t out[OPENDMR_AMBE_FRAME_BYTES],
+                          int *errs)
+{
+    if (!g || !in || !out)
+        return false;
+
+    uint32_t a, b, c;
+    opendmr_unpack_blocks(in, &a, &b, &c);
+
+    unsigned int a_errs = 0;
+    uint32_t c0 = CGolay24128::decode24128(a, a_errs);
+
+    unsigned int b_errs = 0;
+    uint32_t c1 = CGolay24128::decode23127(b ^ ambe_prng_mask(c0), b_errs);
+
+    int n = static_cast<int>(a_errs + b_errs);
+    gain_frame_kind kind = frame_kind(c0, c);
+
+    if (n > OPENDMR_MAX_CORRECTED_ERRORS) {
+        /* Pass through untouched: the far end sees the same errors and
+         * conceals the frame exactly as the input would have been */
+        if (out != in)
+            memcpy(out, in, OPENDMR_AMBE_FRAME_BYTES);
+        if (kind == KIND_VOICE)
+            conceal(g);
+        else
+            reset_predictors(g);
+        if (errs)
+            *errs = -1;
+        return false;
+    }
+
+    if (kind == KIND_VOICE) {
+        /* b2 = C0[3:0] (ambe_d[8..11]) and C[12] (ambe_d[36]) */
+        int b2 = static_cast<int>(((c0 & 0xf) << 1) | ((c >> 12) & 1));
+        int b0 = static_cast<int>(((c0 >> 8) & 0xf) << 3 | ((c >> 9) & 0x7));
+
+        g->gamma_in = AmbeDg[b2] + 0.5f * g->gamma_in;
+        float offset = target_offset_db(g, b0 == 124 || b0 == 125) / DB_PER_LOG2;
+
+        int b2_out = quantise_gain(g->gamma_in + offset - 0.5f * g->gamma_out);
+        g->gamma_out = AmbeDg[b2_out] + 0.5f * g->gamma_out;
+        g->repeats = 0;
+
+        c0 = (c0 & ~0xfU) | static_cast<uint32_t>(b2_out >> 1);
+        c = (c & ~(1U << 12)) | (static_cast<uint32_t>(b2_out & 1) << 12);
+    } else if (kind == KIND_TONE && a_errs < 2 && n < 3) {
+        /* Clean tone frames are synthesised; the gain state carries over */
+        g->repeats = 0;
+    } else {
+        /* Erasures, and tones with too many errors, reset the decoder */
+        reset_predictors(g);
+    }
+
+    /* Re-apply FEC; B scrambling depends on the (possibly new) C0 */
+    a = CGolay24128::encode24128(c0);
+    b = (CGolay24128::encode23127(c1) >> 1) ^ ambe_prng_mask(c0);
+    opendmr_pack_blocks(a, b, c, out);
+
+    if (errs)
+        *errs = n;
+    return true;
+}
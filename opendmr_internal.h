@@ -0,0 +1,82 @@
+/*
+ * OpenDMR - Open Source DMR (AMBE+2) Vocoder Library
+ *
+ * Internal declarations shared between the library's translation units.
+ * Not part of the public API.
+ */
+
+#ifndef OPENDMR_INTERNAL_H
+#define OPENDMR_INTERNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Allocate/release through the hooks set with opendmr_set_allocator() */
+void *opendmr_mem_alloc(size_t size);
+void opendmr_mem_free(void *ptr);
+
+/*
+ * Tables computed at run time are filled by a builder that runs once, on
+ * the first call from any thread (a function-local static per builder).
+ */
+template <bool (*Build)(void)>
+inline void opendmr_build_once(void)
+{
+    static const bool built = Build();
+    (void)built;
+}
+
+/* 16-bit output clip, as mbe_floattoshort() */
+#define OPENDMR_CLIP_LEVEL (32767.0f * 0.95f)
+
+/* Clip a sample that already carries its output gain and truncate to int16 */
+static inline int16_t opendmr_clip_sample(float y)
+{
+    y = y > OPENDMR_CLIP_LEVEL ? OPENDMR_CLIP_LEVEL : y;
+    y = y < -OPENDMR_CLIP_LEVEL ? -OPENDMR_CLIP_LEVEL : y;
+    return static_cast<int16_t>(y);
+}
+
+/*
+ * Frames with more corrected errors than this are concealed by the decoder
+ * (mbelib repeats the previous parameters), so their payload is not trusted.
+ */
+#define OPENDMR_MAX_CORRECTED_ERRORS 3
+
+/* Split/assemble a 72-bit frame (DVSI order) into A (24), B (23), C (25) */
+void opendmr_unpack_blocks(const uint8_t *frame72,
+                           uint32_t *a_out, uint32_t *b_out, uint32_t *c_out);
+void opendmr_pack_blocks(uint32_t a, uint32_t b, uint32_t c, uint8_t *frame72);
+
+/* Pack b[9] voice parameters into a 72-bit frame with FEC */
+void opendmr_encode_ambe_frame(const int b[9], uint8_t *frame72);
+
+/*
+ * Polyphase resampler between 8 kHz and the rates of opendmr_rate_samples().
+ * The state is flat so it lives inside decoder and encoder instances.
+ */
+#define OPENDMR_RESAMPLE_HISTORY 192    /* Longest filter (48 kHz input) */
+
+struct opendmr_resampler {
+    unsigned int rate;          /* Rate of the history, 0 = none yet */
+    float hist[OPENDMR_RESAMPLE_HISTORY];
+};
+
+void opendmr_resampler_reset(opendmr_resampler *rs);
+
+/* One 8 kHz frame -> one frame at rate, multiplied by scale, as int16 */
+bool opendmr_resample_up(opendmr_resampler *rs, unsigned int rate,
+                         const float in[160], float scale, int16_t *out);
+
+/* One int16 frame at rate, multiplied by scale -> one 8 kHz frame */
+bool opendmr_resample_down(opendmr_resampler *rs, unsigned int rate,
+                           const int16_t *in, float scale, float out[160]);
+
+/* G.711 code -> 16-bit linear table (256 entries), NULL for an unknown law */
+const int16_t *opendmr_g711_expand_table(opendmr_g711_law_t law);
+
+/* One frame at mbelib's float scale, multiplied by scale, clipped as int16 -> G.711 */
+void opendmr_g711_compress(const float in[160], float scale,
+                           opendmr_g711_law_t law, uint8_t out[160]);
+
+#endif /* OPENDMR_INTERNAL_H */
@@ -0,0 +1,318 @@
+/*
+ * OpenDMR - Open Source DMR (AMBE+2) Vocoder Library
+ *
+ * Adaptive jitter buffer: reorders frames received over a packet network
+ * and releases one per frame period, concealing the ones that never come.
+ *
+ * Frames are held in a ring indexed by sequence number. The interarrival
+ * jitter is estimated as in RFC 3550 and sets the target delay in whole
+ * frames. A talkspurt starts playing once the target delay is buffered;
+ * after that the delay adapts in single frames: one is dropped when the
+ * buffer has stayed deeper than the target over a whole window, and the
+ * playout point is held back one frame period whenever the due frame is
+ * missing and fewer than the target are buffered behind it, so a late
+ * frame still plays instead of being lost. Once the buffer has run empty
+ * for longer than the target delay, the talkspurt ends.
+ */
+
+#include "opendmr.h"
+#include "opendmr_internal.h"
+#include <cstring>
+
+/* Target delay as a multiple of the jitter estimate */
+#define JITTER_MULT         4
+
+/* RFC 3550 estimator gain (1/16) */
+#define JITTER_SHIFT        4
+
+/* Frame periods over which the buffer depth must stay high to drop one */
+#define WINDOW_FRAMES       50
+
+#define DEFAULT_MIN_DELAY   1
+
+/* The ring is a power of two so slots stay consistent across seq wrap */
+#define MAX_RING            16384
+
+struct jb_slot {
+    uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES];
+    uint16_t seq;
+    bool valid;
+    uint64_t arrival_us;
+};
+
+struct opendmr_jitterbuf {
+    size_t cap;                 /* Ring slots, a power of two >= 2 * limit */
+    size_t limit;               /* Largest delay allowed at creation */
+    size_t min_delay, max_delay;
+    size_t target;              /* Target delay in frames */
+    jb_slot *slots;
+    size_t count;               /* Frames held */
+
+    bool started;               /* A talkspurt is buffered or playing */
+    bool playing;
+    uint16_t next_seq;          /* Next frame to play */
+    uint16_t newest;            /* Newest frame buffered in the talkspurt */
+    uint64_t start_us;          /* Arrival of the talkspurt's first frame */
+    size_t dry;                 /* Frame periods the playout point is held back */
+
+    size_t window;              /* Frame periods left in the depth window */
+    size_t window_min;          /* Smallest depth seen in the window */
+
+    bool have_last;             /* Jitter estimator: previous arrival */
+    uint16_t last_seq;
+    uint64_t last_us;
+    int64_t jitter;             /* Estimate in us << JITTER_SHIFT */
+
+    opendmr_jitterbuf_stats_t stats;
+};
+
+static int16_t seq_diff(uint16_t a, uint16_t b)
+{
+    return static_cast<int16_t>(static_cast<uint16_t>(a - b));
+}
+
+static void update_target(opendmr_jitterbuf_t *jb)
+{
+    int64_t jitter_us = jb->jitter >> JITTER_SHIFT;
+    size_t target = static_cast<size_t>(
+        (JITTER_MULT * jitter_us + OPENDMR_FRAME_US - 1) / OPENDMR_FRAME_US);
+
+    target = target < jb->min_delay ? jb->min_delay : target;
+    target = target > jb->max_delay ? jb->max_delay : target;
+    jb->target = target;
+
+    jb->stats.jitter_us = static_cast<uint32_t>(jitter_us);
+    jb->stats.target_frames = static_cast<uint32_t>(target);
+}
+
+static void restart_window(opendmr_jitterbuf_t *jb)
+{
+    jb->window = WINDOW_FRAMES;
+    jb->window_min = jb->cap;
+}
+
+opendmr_jitterbuf_t *opendmr_jitterbuf_create(size_t max_frames)
+{
+    if (max_frames == 0 || max_frames > MAX_RING / 2)
+        return nullptr;
+
+    opendmr_jitterbuf_t *jb = static_cast<opendmr_jitterbuf_t *>(
+        opendmr_mem_alloc(sizeof(opendmr_jitterbuf_t)));
+    if (!jb)
+        return nullptr;
+    memset(jb, 0, sizeof(*jb));
+
+    jb->cap = 2;
+    while (jb->cap < 2 * max_frames)
+        jb->cap <<= 1;
+    jb->slots = static_cast<jb_slot *>(opendmr_mem_alloc(jb->cap * sizeof(jb_slot)));
+    if (!jb->slots) {
+        opendmr_jitterbuf_destroy(jb);
+        return nullptr;
+    }
+
+    jb->limit = max_frames;
+    jb->min_delay = DEFAULT_MIN_DELAY < max_frames ? DEFAULT_MIN_DELAY : max_frames;
+    jb->max_delay = max_frames;
+    opendmr_jitterbuf_reset(jb);
+    return jb;
+}
+
+void opendmr_jitterbuf_destroy(opendmr_jitterbuf_t *jb)
+{
+    if (!jb)
+        return;
+
+    opendmr_mem_free(jb->slots);
+    opendmr_mem_free(jb);
+}
+
+/* Forget the current talkspurt; the jitter estimate carries over */
+static void end_talkspurt(opendmr_jitterbuf_t *jb)
+{
+    memset(jb->slots, 0, jb->cap * sizeof(jb_slot));
+    jb->count = 0;
+    jb->started = false;
+    jb->playing = false;
+    jb->dry = 0;
+}
+
+void opendmr_jitterbuf_reset(opendmr_jitterbuf_t *jb)
+{
+    if (!jb)
+        return;
+
+    end_talkspurt(jb);
+    jb->have_last = false;
+    jb->jitter = 0;
+    update_target(jb);
+}
+
+void opendmr_jitterbuf_set_delay(opendmr_jitterbuf_t *jb, size_t min_frames, size_t max_frames)
+{
+    if (!jb)
+        return;
+
+    max_frames = max_frames > jb->limit || max_frames == 0 ? jb->limit : max_frames;
+    jb->min_delay = min_frames > max_frames ? max_frames : min_frames;
+    jb->max_delay = max_frames;
+    update_target(jb);
+}
+
+bool opendmr_jitterbuf_put(opendmr_jitterbuf_t *jb, uint16_t seq, uint64_t arrival_us,
+                           const uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES])
+{
+    if (!jb || !ambe)
+        return false;
+
+    /* RFC 3550: J += (|D| - J) / 16, D the change in transit time */
+    if (jb->have_last) {
+        int64_t d = static_cast<int64_t>(arrival_us - jb->last_us) -
+                    static_cast<int64_t>(seq_diff(seq, jb->last_seq)) * OPENDMR_FRAME_US;
+        d = d < 0 ? -d : d;
+        jb->jitter += d - (jb->jitter >> JITTER_SHIFT);
+        update_target(jb);
+    }
+    jb->have_last = true;
+    jb->last_seq = seq;
+    jb->last_us = arrival_us;
+
+    if (!jb->started) {
+        jb->started = true;
+        jb->next_seq = seq;
+        jb->newest = seq;
+        jb->start_us = arrival_us;
+    }
+
+    int16_t ahead = seq_diff(seq, jb->next_seq);
+    if (ahead < 0 && !jb->playing &&
+        static_cast<size_t>(seq_diff(jb->newest, seq)) < jb->cap) {
+        /* Reordered before the first frame of a talkspurt not yet playing,
+         * and the ring still spans it and the newest frame */
+        jb->next_seq = seq;
+        ahead = 0;
+    }
+    if (ahead < 0) {
+        jb->stats.late++;
+        return false;
+    }
+    if (static_cast<size_t>(ahead) >= jb->cap) {
+        jb->stats.overflows++;
+        return false;
+    }
+
+    jb_slot *slot = &jb->slots[seq & (jb->cap - 1)];
+    if (slot->valid) {
+        jb->stats.duplicates++;
+        return false;
+    }
+    memcpy(slot->ambe, ambe, OPENDMR_AMBE_FRAME_BYTES);
+    slot->seq = seq;
+    slot->valid = true;
+    slot->arrival_us = arrival_us;
+    jb->count++;
+    if (seq_diff(seq, jb->newest) > 0)
+        jb->newest = seq;
+    return true;
+}
+
+/* Take the due frame out of its slot, if it has arrived; ambe NULL drops it */
+static bool take(opendmr_jitterbuf_t *jb, uint64_t now_us, uint8_t *ambe)
+{
+    jb_slot *slot = &jb->slots[jb->next_seq & (jb->cap - 1)];
+    if (!slot->valid || slot->seq != jb->next_seq)
+        return false;
+
+    if (ambe) {
+        memcpy(ambe, slot->ambe, OPENDMR_AMBE_FRAME_BYTES);
+        if (now_us > slot->arrival_us)
+            jb->stats.wait_us += now_us - slot->arrival_us;
+    }
+    slot->valid = false;
+    jb->count--;
+    jb->next_seq++;
+    return true;
+}
+
+opendmr_jb_result_t opendmr_jitterbuf_get(opendmr_jitterbuf_t *jb, uint64_t now_us,
+                                          uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES])
+{
+    if (!jb || !jb->started)
+        return OPENDMR_JB_IDLE;
+
+    if (!jb->playing) {
+        /* Start once the target delay is buffered or has elapsed */
+        if (jb->count <= jb->target &&
+            now_us - jb->start_us < static_cast<uint64_t>(jb->target) * OPENDMR_FRAME_US)
+            return OPENDMR_JB_IDLE;
+        jb->playing = true;
+        restart_window(jb);
+    }
+
+    /* Deeper than the target for a whole window: drop a frame */
+    if (jb->count < jb->window_min)
+        jb->window_min = jb->count;
+    if (--jb->window == 0) {
+        if (jb->window_min > jb->target + 1 && take(jb, now_us, nullptr))
+            jb->stats.dropped++;
+        restart_window(jb);
+    }
+
+    if (take(jb, now_us, ambe)) {
+        /* Periods held back for this talkspurt count once it resumes */
+        jb->stats.stretched += jb->dry;
+        jb->stats.lost += jb->dry;
+        jb->dry = 0;
+        jb->stats.frames++;
+        return OPENDMR_JB_FRAME;
+    }
+
+    if (jb->count > 0 && (jb->count >= jb->target || jb->dry >= jb->target)) {
+        /* Later frames are here and it has been waited for, so it is lost */
+        jb->next_seq++;
+        jb->stats.stretched += jb->dry;
+        jb->stats.lost += jb->dry + 1;
+        jb->dry = 0;
+        return OPENDMR_JB_LOST;
+    }
+
+    /* Shallower than the target: wait a frame period, or end the talkspurt.
+     * With nothing buffered the due frame is given the target delay (at a
+     * stream end nothing more comes); with later frames here, max_delay. */
+    if (++jb->dry > (jb->count == 0 ? jb->target : jb->max_delay)) {
+        end_talkspurt(jb);
+        return OPENDMR_JB_IDLE;
+    }
+    return OPENDMR_JB_LOST;
+}
+
+opendmr_jb_result_t opendmr_jitterbuf_decode(opendmr_jitterbuf_t *jb, opendmr_decoder_t *dec,
+                                             uint64_t now_us, int16_t pcm[OPENDMR_PCM_SAMPLES],
+                                             opendmr_frame_info_t *info)
+{
+    uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES];
+    opendmr_jb_result_t r = opendmr_jitterbuf_get(jb, now_us, ambe);
+
+    if (r == OPENDMR_JB_FRAME && dec && pcm)
+        opendmr_decode_ex(dec, ambe, pcm, info);
+    else if (r == OPENDMR_JB_LOST && dec && pcm)
+        opendmr_decode_lost(dec, pcm, info);
+    else if (pcm)
+        memset(pcm, 0, OPENDMR_PCM_SAMPLES * sizeof(int16_t));
+    return r;
+}
+
+void opendmr_jitterbuf_get_stats(const opendmr_jitterbuf_t *jb, opendmr_jitterbuf_stats_t *stats)
+{
+    if (jb && stats)
+        *stats = jb->stats;
+}
+
+void opendmr_jitterbuf_reset_stats(opendmr_jitterbuf_t *jb)
+{
+    if (!jb)
+        return;
+
+    memset(&jb->stats, 0, sizeof(jb->stats));
+    update_target(jb);
+}
@@ -0,0 +1,238 @@
+/*
+ * OpenDMR - Open Source DMR (AMBE+2) Vocoder Library
+ *
+ * Conference mixer: builds the N-minus-one mix for every leg of a
+ * conference from the decoders' floating point output.
+ *
+ * Only legs with audio are summed. Each leg then receives the total less
+ * its own contribution, so the summing work grows with the number of
+ * talkers rather than the number of participants; legs that are not
+ * talking all hear the same total, whose peak is measured once.
+ *
+ * Every output has its own peak limiter. The gain for a frame never
+ * exceeds what keeps that frame's peak at the threshold (instant attack)
+ * and recovers towards unity at the release rate, ramped linearly across
+ * the frame so there are no steps. A final clip to +/-1.0 catches
+ * anything the limiter lets through. The sample loops are written so the
+ * compiler vectorises them.
+ */
+
+#include "opendmr.h"
+#include "opendmr_internal.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+/* Defaults: limit at -1 dBFS, 100 ms release */
+#define DEFAULT_THRESHOLD   0.891f
+#define DEFAULT_RELEASE_MS  100.0f
+
+struct opendmr_mixer {
+    size_t max_legs;
+    float threshold;
+    float release;              /* Fraction of the gain deficit recovered per frame */
+
+    float *gain;                /* Limiter gain per leg at the end of the last frame */
+    float total[OPENDMR_PCM_SAMPLES];
+};
+
+static float release_coef(float release_ms)
+{
+    if (release_ms <= 0.0f)
+        return 1.0f;
+    return 1.0f - expf(-(OPENDMR_FRAME_US / 1000.0f) / release_ms);
+}
+
+opendmr_mixer_t *opendmr_mixer_create(size_t max_legs)
+{
+    if (max_legs == 0)
+        return nullptr;
+
+    opendmr_mixer_t *mix = static_cast<opendmr_mixer_t *>(
+        opendmr_mem_alloc(sizeof(opendmr_mixer_t)));
+    if (!mix)
+        return nullptr;
+    memset(mix, 0, sizeof(*mix));
+
+    mix->gain = static_cast<float *>(opendmr_mem_alloc(max_legs * sizeof(float)));
+    if (!mix->gain) {
+        opendmr_mixer_destroy(mix);
+        return nullptr;
+    }
+
+    mix->max_legs = max_legs;
+    mix->threshold = DEFAULT_THRESHOLD;
+    mix->release = release_coef(DEFAULT_RELEASE_MS);
+    opendmr_mixer_reset(mix);
+    return mix;
+}
+
+void opendmr_mixer_destroy(opendmr_mixer_t *mix)
+{
+    if (!mix)
+        return;
+
+    opendmr_mem_free(mix->gain);
+    opendmr_mem_free(mix);
+}
+
+void opendmr_mixer_set_limiter(opendmr_mixer_t *mix, float threshold, float release_ms)
+{
+    if (!mix)
+        return;
+
+    if (threshold > 0.0f && threshold <= 1.0f)
+        mix->threshold = threshold;
+    mix->release = release_coef(release_ms);
+}
+
+void opendmr_mixer_reset(opendmr_mixer_t *mix)
+{
+    if (!mix)
+        return;
+
+    for (size_t i = 0; i < mix->max_legs; i++)
+        mix->gain[i] = 1.0f;
+}
+
+void opendmr_mixer_reset_leg(opendmr_mixer_t *mix, size_t leg)
+{
+    if (mix && leg < mix->max_legs)
+        mix->gain[leg] = 1.0f;
+}
+
+/*
+ * Peak magnitudes are reduced on the float bit patterns: with the sign bit
+ * cleared, IEEE 754 values order the same as integers, and an integer max
+ * reduction vectorises where a float one would need -ffast-math.
+ */
+static inline int32_t magnitude_bits(float v)
+{
+    int32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return bits & 0x7fffffff;
+}
+
+static inline float bits_to_float(int32_t bits)
+{
+    float v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+/* Peak magnitude of a frame */
+static float frame_peak(const float *x)
+{
+    int32_t peak = 0;
+    for (int n = 0; n < OPENDMR_PCM_SAMPLES; n++) {
+        int32_t m = magnitude_bits(x[n]);
+        peak = m > peak ? m : peak;
+    }
+    return bits_to_float(peak);
+}
+
+/* out = total - own, returning the peak of out */
+static float subtract_peak(const float *__restrict total, const float *__restrict own,
+                           float *__restrict out)
+{
+    int32_t peak = 0;
+    for (int n = 0; n < OPENDMR_PCM_SAMPLES; n++) {
+        float v = total[n] - own[n];
+        out[n] = v;
+        int32_t m = magnitude_bits(v);
+        peak = m > peak ? m : peak;
+    }
+    return bits_to_float(peak);
+}
+
+/* out = clip(in * gain ramp); in and out may be the same buffer */
+static void apply_gain(const float *in, float *out, float g0, float g1)
+{
+    float step = (g1 - g0) / OPENDMR_PCM_SAMPLES;
+    for (int n = 0; n < OPENDMR_PCM_SAMPLES; n++) {
+        float v = in[n] * (g0 + step * static_cast<float>(n + 1));
+        v = v > 1.0f ? 1.0f : v;
+        v = v < -1.0f ? -1.0f : v;
+        out[n] = v;
+    }
+}
+
+/* Advance a leg's limiter for a frame with the given raw peak */
+static void limiter_gains(const opendmr_mixer_t *mix, float *gain, float peak,
+                          float *g0, float *g1)
+{
+    float limit = peak > mix->threshold ? mix->threshold / peak : 1.0f;
+    float g = *gain;
+    float recovered = g + (1.0f - g) * mix->release;
+
+    /* Both ramp ends stay at or below the limit, so no sample overshoots */
+    *g0 = g < limit ? g : limit;
+    *g1 = recovered < limit ? recovered : limit;
+    *gain = *g1;
+}
+
+/* Legs without a frame, and silent or silence-class frames, are not summed */
+static bool leg_talking(const float *const *in, const opendmr_frame_info_t *info, size_t i)
+{
+    if (!in[i])
+        return false;
+    return !info || !(info[i].silent || info[i].frame_class == OPENDMR_FRAME_SILENCE);
+}
+
+size_t opendmr_mixer_mix(opendmr_mixer_t *mix,
+                         const float *const *in,
+                         const opendmr_frame_info_t *info,
+                         float *const *out,
+                         size_t legs)
+{
+    if (!mix || !in || !out || legs > mix->max_legs)
+        return 0;
+
+    float *total = mix->total;
+    size_t talkers = 0;
+
+    for (size_t i = 0; i < legs; i++) {
+        if (!leg_talking(in, info, i))
+            continue;
+
+        const float *x = in[i];
+        if (talkers == 0) {
+            memcpy(total, x, sizeof(mix->total));
+        } else {
+            for (int n = 0; n < OPENDMR_PCM_SAMPLES; n++)
+                total[n] += x[n];
+        }
+        talkers++;
+    }
+
+    if (talkers == 0) {
+        for (size_t i = 0; i < legs; i++) {
+            float g0, g1;
+            limiter_gains(mix, &mix->gain[i], 0.0f, &g0, &g1);
+            memset(out[i], 0, OPENDMR_PCM_SAMPLES * sizeof(float));
+        }
+        return 0;
+    }
+
+    /* Listeners all hear the unmodified total */
+    float total_peak = frame_peak(total);
+
+    for (size_t i = 0; i < legs; i++) {
+        bool talking = leg_talking(in, info, i);
+        float g0, g1;
+
+        if (talking && talkers == 1) {
+            /* Sole talker: hears nobody */
+            limiter_gains(mix, &mix->gain[i], 0.0f, &g0, &g1);
+            memset(out[i], 0, OPENDMR_PCM_SAMPLES * sizeof(float));
+        } else if (talking) {
+            float peak = subtract_peak(total, in[i], out[i]);
+            limiter_gains(mix, &mix->gain[i], peak, &g0, &g1);
+            apply_gain(out[i], out[i], g0, g1);
+        } else {
+            limiter_gains(mix, &mix->gain[i], total_peak, &g0, &g1);
+            apply_gain(total, out[i], g0, g1);
+        }
+    }
+    return talkers;
+}
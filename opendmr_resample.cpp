@@ -0,0 +1,222 @@
+/*
+ * OpenDMR - Open Source DMR (AMBE+2) Vocoder Library
+ *
+ * Polyphase resampler between the codec's 8 kHz and 16, 44.1 or 48 kHz,
+ * used by opendmr_decode_rate() and opendmr_encode_rate().
+ *
+ * A conversion by L/M evaluates a Kaiser-windowed sinc prototype at L
+ * times the input rate, but only the taps that land on input samples:
+ * output m uses phase (m * M) % L of the filter against the input ending
+ * at (m * M) / L. Each phase is stored reversed so an output is one
+ * contiguous dot product over the input, which the compiler vectorises.
+ *
+ * Every rate converts whole 20 ms frames exactly (160 samples at 8 kHz to
+ * 320, 882 or 960), so the only state carried between frames is the input
+ * history. The filter banks are built once, on first use, and shared.
+ */
+
+#include "opendmr.h"
+#include "opendmr_internal.h"
+#include <cmath>
+#include <cstring>
+
+/* Filter span in 8 kHz samples; taps per phase scale with the input rate */
+#define SPAN_8K             32
+
+/* Lowpass cutoff (Hz) and Kaiser shape (about 60 dB stopband) */
+#define CUTOFF_HZ           3600.0
+#define KAISER_BETA         6.0
+
+/* Taps per phase are a multiple of the dot product lane count */
+#define DOT_LANES           8
+
+struct resample_bank {
+    unsigned int rate;          /* Non-8 kHz side */
+    bool up;                    /* 8 kHz -> rate */
+    int L, M;                   /* Output rate = input rate * L / M */
+    int taps;                   /* Taps per phase */
+    int in_samples;             /* Input samples per frame */
+    int out_samples;            /* Output samples per frame */
+    float *coef;                /* [L][taps], each phase reversed */
+};
+
+/* Storage for every bank (phases x taps) */
+alignas(32) static float coef_16k_up[2 * SPAN_8K];
+alignas(32) static float coef_16k_down[1 * SPAN_8K * 2];
+alignas(32) static float coef_48k_up[6 * SPAN_8K];
+alignas(32) static float coef_48k_down[1 * SPAN_8K * 6];
+alignas(32) static float coef_44k_up[441 * SPAN_8K];
+alignas(32) static float coef_44k_down[80 * 176];
+
+static resample_bank banks[] = {
+    { 16000, true,    2,   1, SPAN_8K,     160, 320, coef_16k_up },
+    { 16000, false,   1,   2, SPAN_8K * 2, 320, 160, coef_16k_down },
+    { 48000, true,    6,   1, SPAN_8K,     160, 960, coef_48k_up },
+    { 48000, false,   1,   6, SPAN_8K * 6, 960, 160, coef_48k_down },
+    { 44100, true,  441,  80, SPAN_8K,     160, 882, coef_44k_up },
+    { 44100, false,  80, 441, 176,         882, 160, coef_44k_down },
+};
+
+#define NUM_BANKS (sizeof(banks) / sizeof(banks[0]))
+
+/* Zeroth-order modified Bessel function of the first kind */
+static double bessel_i0(double x)
+{
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 50; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-12)
+            break;
+    }
+    return sum;
+}
+
+static void build_bank(resample_bank *bk)
+{
+    const int n = bk->L * bk->taps;
+    const double fs = (bk->up ? OPENDMR_SAMPLE_RATE : bk->rate) * bk->L;
+    const double center = (n - 1) / 2.0;
+    const double norm = bessel_i0(KAISER_BETA);
+
+    for (int p = 0; p < bk->L; p++) {
+        float *row = bk->coef + p * bk->taps;
+        double sum = 0.0;
+
+        /* Tap k of phase p is prototype tap p + L * k, stored reversed */
+        for (int k = 0; k < bk->taps; k++) {
+            int i = p + bk->L * k;
+            double t = (i - center) * 2.0 * CUTOFF_HZ / fs;
+            double sinc = t == 0.0 ? 1.0 : sin(M_PI * t) / (M_PI * t);
+            double r = 2.0 * i / (n - 1) - 1.0;
+            double w = bessel_i0(KAISER_BETA * sqrt(fmax(0.0, 1.0 - r * r))) / norm;
+            row[bk->taps - 1 - k] = static_cast<float>(sinc * w);
+            sum += sinc * w;
+        }
+
+        /* Unity DC gain per phase, so no phase ripples on the output */
+        for (int k = 0; k < bk->taps; k++)
+            row[k] = static_cast<float>(row[k] / sum);
+    }
+}
+
+static bool build_banks(void)
+{
+    for (size_t i = 0; i < NUM_BANKS; i++)
+        build_bank(&banks[i]);
+    return true;
+}
+
+static const resample_bank *find_bank(unsigned int rate, bool up)
+{
+    opendmr_build_once<build_banks>();
+
+    for (size_t i = 0; i < NUM_BANKS; i++) {
+        if (banks[i].rate == rate && banks[i].up == up)
+            return &banks[i];
+    }
+    return nullptr;
+}
+
+/* Dot product in independent lanes so it vectorises without -ffast-math */
+static inline float dot(const float *__restrict h, const float *__restrict x, int taps)
+{
+    float acc[DOT_LANES] = { 0.0f };
+    for (int k = 0; k < taps; k += DOT_LANES) {
+        for (int j = 0; j < DOT_LANES; j++)
+            acc[j] += h[k + j] * x[k + j];
+    }
+    return ((acc[0] + acc[4]) + (acc[1] + acc[5])) + ((acc[2] + acc[6]) + (acc[3] + acc[7]));
+}
+
+/*
+ * Run one frame through a bank. x holds taps - 1 history samples followed
+ * by the frame; out receives unscaled output samples via emit().
+ */
+template <typename Emit>
+static void run_bank(const resample_bank *bk, const float *x, Emit emit)
+{
+    const int step = bk->M / bk->L;
+    const int frac = bk->M % bk->L;
+    int base = 0, phase = 0;
+
+    for (int m = 0; m < bk->out_samples; m++) {
+        emit(m, dot(bk->coef + phase * bk->taps, x + base, bk->taps));
+        base += step;
+        phase += frac;
+        if (phase >= bk->L) {
+            phase -= bk->L;
+            base++;
+        }
+    }
+}
+
+/* Restart the history if the rate changed, then return it */
+static float *history(opendmr_resampler *rs, const resample_bank *bk)
+{
+    if (rs->rate != bk->rate) {
+        memset(rs->hist, 0, sizeof(rs->hist));
+        rs->rate = bk->rate;
+    }
+    return rs->hist;
+}
+
+void opendmr_resampler_reset(opendmr_resampler *rs)
+{
+    memset(rs, 0, sizeof(*rs));
+}
+
+size_t opendmr_rate_samples(unsigned int rate)
+{
+    if (rate == OPENDMR_SAMPLE_RATE)
+        return OPENDMR_PCM_SAMPLES;
+
+    const resample_bank *bk = find_bank(rate, true);
+    return bk ? static_cast<size_t>(bk->out_samples) : 0;
+}
+
+bool opendmr_resample_up(opendmr_resampler *rs, unsigned int rate,
+                         const float in[OPENDMR_PCM_SAMPLES], float scale, int16_t *out)
+{
+    const resample_bank *bk = find_bank(rate, true);
+    if (!bk)
+        return false;
+
+    const int hist_len = bk->taps - 1;
+    float *hist = history(rs, bk);
+    float x[OPENDMR_RESAMPLE_HISTORY + OPENDMR_PCM_SAMPLES];
+    memcpy(x, hist, hist_len * sizeof(float));
+    memcpy(x + hist_len, in, OPENDMR_PCM_SAMPLES * sizeof(float));
+
+    /* Output gain, clipping and 16-bit conversion fused into the filter */
+    run_bank(bk, x, [out, scale](int m, float y) {
+        out[m] = opendmr_clip_sample(y * scale);
+    });
+
+    memcpy(hist, x + OPENDMR_PCM_SAMPLES, hist_len * sizeof(float));
+    return true;
+}
+
+bool opendmr_resample_down(opendmr_resampler *rs, unsigned int rate,
+                           const int16_t *in, float scale, float out[OPENDMR_PCM_SAMPLES])
+{
+    const resample_bank *bk = find_bank(rate, false);
+    if (!bk)
+        return false;
+
+    const int hist_len = bk->taps - 1;
+    float *hist = history(rs, bk);
+    float x[OPENDMR_RESAMPLE_HISTORY + OPENDMR_MAX_RATE_SAMPLES];
+    memcpy(x, hist, hist_len * sizeof(float));
+
+    /* Input scaling and conversion fused into the history copy */
+    for (int i = 0; i < bk->in_samples; i++)
+        x[hist_len + i] = in[i] * scale;
+
+    run_bank(bk, x, [out](int m, float y) {
+        out[m] = y;
+    });
+
+    memcpy(hist, x + bk->in_samples, hist_len * sizeof(float));
+    return true;
+}
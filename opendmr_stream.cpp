@@ -0,0 +1,399 @@
+/*
+ * OpenDMR - Open Source DMR (AMBE+2) Vocoder Library
+ *
+ * Push/pull streaming layer: re-frames arbitrary chunk sizes into
+ * 160-sample / 9-byte codec frames.
+ *
+ * Each direction uses two rings whose capacities are whole multiples of
+ * the frame size they carry. Frames therefore never wrap, so the codec
+ * reads its input from and writes its output into the rings directly.
+ * Read and write positions are kept inside the ring rather than taken
+ * modulo its size, so a non power-of-two size stays frame aligned when a
+ * 32-bit counter would wrap (about 6 days of audio).
+ */
+
+#include "opendmr.h"
+#include "opendmr_internal.h"
+#include <cassert>
+#include <cstring>
+#include <new>
+
+/*
+ * ============================================================================
+ * Ring Buffer
+ * ============================================================================
+ */
+
+/*
+ * Single-threaded ring. rd and wr are positions in [0, cap) and count is
+ * the number of elements held, so a full ring (rd == wr) is distinct from
+ * an empty one.
+ */
+template <typename T>
+struct stream_ring {
+    T *buf;
+    size_t cap;
+    size_t rd;
+    size_t wr;
+    size_t count;
+
+    size_t fill() const { return count; }
+    size_t space() const { return cap - count; }
+
+    void clear() { rd = wr = count = 0; }
+
+    /* Advance past n elements written at wr (n <= space()) */
+    void produce(size_t n)
+    {
+        wr += n;
+        if (wr >= cap)
+            wr -= cap;
+        count += n;
+    }
+
+    /* Advance past n elements read at rd (n <= fill()) */
+    void consume(size_t n)
+    {
+        rd += n;
+        if (rd >= cap)
+            rd -= cap;
+        count -= n;
+    }
+
+    /* Contiguous readable region starting at rd */
+    T *read_span(size_t *n) const
+    {
+        size_t len = cap - rd;
+        if (len > count)
+            len = count;
+        *n = len;
+        return buf + rd;
+    }
+
+    /* Contiguous writable region starting at wr */
+    T *write_span(size_t *n) const
+    {
+        size_t len = cap - wr;
+        if (len > space())
+            len = space();
+        *n = len;
+        return buf + wr;
+    }
+
+    size_t write(const T *src, size_t n)
+    {
+        size_t done = 0;
+        while (done < n) {
+            size_t len;
+            T *dst = write_span(&len);
+            if (len == 0)
+                break;
+            if (len > n - done)
+                len = n - done;
+            memcpy(dst, src + done, len * sizeof(T));
+            produce(len);
+            done += len;
+        }
+        return done;
+    }
+
+    size_t read(T *dst, size_t n)
+    {
+        size_t done = 0;
+        while (done < n) {
+            size_t len;
+            T *src = read_span(&len);
+            if (len == 0)
+                break;
+            if (len > n - done)
+                len = n - done;
+            memcpy(dst + done, src, len * sizeof(T));
+            consume(len);
+            done += len;
+        }
+        return done;
+    }
+};
+
+/*
+ * ============================================================================
+ * Stream Implementation
+ * ============================================================================
+ */
+
+struct opendmr_stream {
+    opendmr_encoder_t *enc;
+    opendmr_decoder_t *dec;
+
+    /* Encode direction: PCM in -> AMBE out */
+    stream_ring<int16_t> pcm_in;
+    stream_ring<uint8_t> ambe_out;
+
+    /* Decode direction: AMBE in -> PCM out */
+    stream_ring<uint8_t> ambe_in;
+    stream_ring<int16_t> pcm_out;
+
+    /* Accumulated corrected bit errors from decoded frames */
+    unsigned long errs;
+};
+
+/* Encode every complete PCM frame that has room for its output */
+static void pump_encode(opendmr_stream_t *s)
+{
+    if (!s->enc)
+        return;
+
+    while (s->pcm_in.fill() >= OPENDMR_PCM_SAMPLES &&
+           s->ambe_out.space() >= OPENDMR_AMBE_FRAME_BYTES) {
+        size_t n_pcm, n_ambe;
+        const int16_t *pcm = s->pcm_in.read_span(&n_pcm);
+        uint8_t *ambe = s->ambe_out.write_span(&n_ambe);
+        assert(n_pcm >= OPENDMR_PCM_SAMPLES && n_ambe >= OPENDMR_AMBE_FRAME_BYTES);
+
+        opendmr_encode(s->enc, pcm, ambe);
+
+        s->pcm_in.consume(OPENDMR_PCM_SAMPLES);
+        s->ambe_out.produce(OPENDMR_AMBE_FRAME_BYTES);
+    }
+}
+
+/* Decode every complete AMBE frame that has room for its output */
+static void pump_decode(opendmr_stream_t *s)
+{
+    if (!s->dec)
+        return;
+
+    while (s->ambe_in.fill() >= OPENDMR_AMBE_FRAME_BYTES &&
+           s->pcm_out.space() >= OPENDMR_PCM_SAMPLES) {
+        size_t n_ambe, n_pcm;
+        const uint8_t *ambe = s->ambe_in.read_span(&n_ambe);
+        int16_t *pcm = s->pcm_out.write_span(&n_pcm);
+        assert(n_ambe >= OPENDMR_AMBE_FRAME_BYTES && n_pcm >= OPENDMR_PCM_SAMPLES);
+        int errs = 0;
+
+        opendmr_decode(s->dec, ambe, pcm, &errs);
+        s->errs += errs;
+
+        s->ambe_in.consume(OPENDMR_AMBE_FRAME_BYTES);
+        s->pcm_out.produce(OPENDMR_PCM_SAMPLES);
+    }
+}
+
+opendmr_stream_t *opendmr_stream_create(opendmr_encoder_t *enc,
+                                        opendmr_decoder_t *dec,
+                                        size_t frames)
+{
+    if ((!enc && !dec) || frames == 0)
+        return nullptr;
+
+    /* One block: stream header, then the 16-bit rings, then the byte rings */
+    size_t pcm_len = frames * OPENDMR_PCM_SAMPLES;
+    size_t ambe_len = frames * OPENDMR_AMBE_FRAME_BYTES;
+    size_t total = sizeof(opendmr_stream_t) +
+                   2 * pcm_len * sizeof(int16_t) +
+                   2 * ambe_len;
+
+    void *mem = opendmr_mem_alloc(total);
+    if (!mem)
+        return nullptr;
+
+    opendmr_stream_t *s = new (mem) opendmr_stream_t();
+    int16_t *pcm_mem = reinterpret_cast<int16_t *>(s + 1);
+    uint8_t *ambe_mem = reinterpret_cast<uint8_t *>(pcm_mem + 2 * pcm_len);
+
+    s->enc = enc;
+    s->dec = dec;
+    s->pcm_in = { pcm_mem, pcm_len, 0, 0, 0 };
+    s->pcm_out = { pcm_mem + pcm_len, pcm_len, 0, 0, 0 };
+    s->ambe_out = { ambe_mem, ambe_len, 0, 0, 0 };
+    s->ambe_in = { ambe_mem + ambe_len, ambe_len, 0, 0, 0 };
+    s->errs = 0;
+
+    return s;
+}
+
+void opendmr_stream_destroy(opendmr_stream_t *s)
+{
+    opendmr_mem_free(s);
+}
+
+void opendmr_stream_reset(opendmr_stream_t *s)
+{
+    if (s) {
+        s->pcm_in.clear();
+        s->ambe_out.clear();
+        s->ambe_in.clear();
+        s->pcm_out.clear();
+        s->errs = 0;
+    }
+}
+
+/*
+ * Encode direction
+ */
+
+size_t opendmr_stream_push_pcm(opendmr_stream_t *s, const int16_t *pcm, size_t samples)
+{
+    if (!s || !s->enc || !pcm)
+        return 0;
+
+    /* Interleave writes with encoding so chunks larger than the ring fit */
+    size_t done = 0;
+    for (;;) {
+        done += s->pcm_in.write(pcm + done, samples - done);
+        size_t before = s->pcm_in.fill();
+        pump_encode(s);
+        if (done == samples || s->pcm_in.fill() == before)
+            break;
+    }
+    return done;
+}
+
+size_t opendmr_stream_pull_ambe(opendmr_stream_t *s, uint8_t *ambe, size_t bytes)
+{
+    if (!s || !ambe)
+        return 0;
+
+    /* Keep draining while freed space lets further frames through */
+    size_t done = 0;
+    for (;;) {
+        size_t n = s->ambe_out.read(ambe + done, bytes - done);
+        done += n;
+        pump_encode(s);
+        if (done == bytes || n == 0)
+            break;
+    }
+    return done;
+}
+
+int16_t *opendmr_stream_pcm_write_span(opendmr_stream_t *s, size_t *samples)
+{
+    if (!s || !samples)
+        return nullptr;
+    if (!s->enc) {
+        *samples = 0;
+        return nullptr;
+    }
+    return s->pcm_in.write_span(samples);
+}
+
+void opendmr_stream_pcm_write_commit(opendmr_stream_t *s, size_t samples)
+{
+    if (!s || !s->enc)
+        return;
+    if (samples > s->pcm_in.space())
+        samples = s->pcm_in.space();
+    s->pcm_in.produce(samples);
+    pump_encode(s);
+}
+
+const uint8_t *opendmr_stream_ambe_read_span(opendmr_stream_t *s, size_t *bytes)
+{
+    if (!s || !bytes)
+        return nullptr;
+    return s->ambe_out.read_span(bytes);
+}
+
+void opendmr_stream_ambe_read_commit(opendmr_stream_t *s, size_t bytes)
+{
+    if (!s)
+        return;
+    if (bytes > s->ambe_out.fill())
+        bytes = s->ambe_out.fill();
+    s->ambe_out.consume(bytes);
+    pump_encode(s);
+}
+
+/*
+ * Decode direction
+ */
+
+size_t opendmr_stream_push_ambe(opendmr_stream_t *s, const uint8_t *ambe, size_t bytes)
+{
+    if (!s || !s->dec || !ambe)
+        return 0;
+
+    size_t done = 0;
+    for (;;) {
+        done += s->ambe_in.write(ambe + done, bytes - done);
+        size_t before = s->ambe_in.fill();
+        pump_decode(s);
+        if (done == bytes || s->ambe_in.fill() == before)
+            break;
+    }
+    return done;
+}
+
+size_t opendmr_stream_pull_pcm(opendmr_stream_t *s, int16_t *pcm, size_t samples)
+{
+    if (!s || !pcm)
+        return 0;
+
+    /* Keep draining while freed space lets further frames through */
+    size_t done = 0;
+    for (;;) {
+        size_t n = s->pcm_out.read(pcm + done, samples - done);
+        done += n;
+        pump_decode(s);
+        if (done == samples || n == 0)
+            break;
+    }
+    return done;
+}
+
+uint8_t *opendmr_stream_ambe_write_span(opendmr_stream_t *s, size_t *bytes)
+{
+    if (!s || !bytes)
+        return nullptr;
+    if (!s->dec) {
+        *bytes = 0;
+        return nullptr;
+    }
+    return s->ambe_in.write_span(bytes);
+}
+
+void opendmr_stream_ambe_write_commit(opendmr_stream_t *s, size_t bytes)
+{
+    if (!s || !s->dec)
+        return;
+    if (bytes > s->ambe_in.space())
+        bytes = s->ambe_in.space();
+    s->ambe_in.produce(bytes);
+    pump_decode(s);
+}
+
+const int16_t *opendmr_stream_pcm_read_span(opendmr_stream_t *s, size_t *samples)
+{
+    if (!s || !samples)
+        return nullptr;
+    return s->pcm_out.read_span(samples);
+}
+
+void opendmr_stream_pcm_read_commit(opendmr_stream_t *s, size_t samples)
+{
+    if (!s)
+        return;
+    if (samples > s->pcm_out.fill())
+        samples = s->pcm_out.fill();
+    s->pcm_out.consume(samples);
+    pump_decode(s);
+}
+
+/*
+ * Status
+ */
+
+size_t opendmr_stream_ambe_available(const opendmr_stream_t *s)
+{
+    return s ? s->ambe_out.fill() : 0;
+}
+
+size_t opendmr_stream_pcm_available(const opendmr_stream_t *s)
+{
+    return s ? s->pcm_out.fill() : 0;
+}
+
+unsigned long opendmr_stream_errors(const opendmr_stream_t *s)
+{
+    return s ? s->errs : 0;
+}
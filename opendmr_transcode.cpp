@@ -0,0 +1,209 @@
+/*
+ * OpenDMR - Open Source DMR (AMBE+2) Vocoder Library
+ *
+ * Parameter-domain transcoder between AMBE+2 (DMR) and P25 IMBE.
+ *
+ * Both codecs describe a frame with the same harmonic model: fundamental
+ * w0, L harmonics, per-band voicing and log2 harmonic magnitudes. AMBE+2
+ * frames are dequantised with mbelib and the model is fed straight into the
+ * IMBE spectral amplitude quantiser; IMBE frames are dequantised and fed
+ * into the same AMBE+2 quantiser the encoder uses after speech analysis.
+ * The magnitude scaling is the inverse of the one in encode_ambe(), so a
+ * round trip lands back on the same log2 magnitudes.
+ */
+
+#include "opendmr.h"
+#include "opendmr_internal.h"
+#include "mbeenc.h"
+#include "imbe_vocoder.h"
+#include "v_uv_det.h"
+#include <cmath>
+#include <cstring>
+#include <new>
+
+/* Consecutive invalid IMBE frames repeated before muting */
+#define MAX_REPEATS         3
+
+/* Pitch used before the first voice frame: 50 samples (160 Hz), Q8.8 */
+#define DEFAULT_REF_PITCH   (50 * 256)
+
+/*
+ * encode_ambe() subtracts its gain adjustment from the log2 frame gain.
+ * Keep the PCM encoder's default so IMBE transcodes at the same level as
+ * encoding the PCM directly; the AMBE+2 -> IMBE direction adds it back.
+ */
+#define LEVEL_OFFSET        1.0f
+
+/* IMBE ref_pitch (Q8.8) range covered by pitch codes b0 = 0..207 */
+#define REF_PITCH_MIN       0x1380
+#define REF_PITCH_MAX       (0x1380 + (207 << 7) + 0x7F)
+
+struct opendmr_transcoder {
+    /* AMBE+2 -> IMBE */
+    opendmr_decoder_t *dec;     /* Parameter-only decode */
+    imbe_vocoder imbe;          /* IMBE quantiser and dequantiser */
+    int16_t ref_pitch;          /* Last voice pitch, reused for gaps */
+
+    /* IMBE -> AMBE+2 */
+    MBEEncoder enc;
+    IMBE_PARAM last;            /* Last valid IMBE frame */
+    int repeats;                /* Consecutive invalid IMBE frames */
+};
+
+/* Unvoiced, near-zero magnitudes at the given pitch */
+static void silent_params(IMBE_PARAM *ip, int16_t ref_pitch)
+{
+    memset(ip, 0, sizeof(*ip));
+    ip->ref_pitch = ref_pitch;
+    get_num_harms(ip);
+    for (int l = 0; l < ip->num_harms; l++)
+        ip->sa[l] = 1;
+}
+
+static void init_directions(opendmr_transcoder_t *tc)
+{
+    tc->enc.set_gain_adjust(LEVEL_OFFSET);
+    tc->ref_pitch = DEFAULT_REF_PITCH;
+    silent_params(&tc->last, DEFAULT_REF_PITCH);
+    tc->repeats = 0;
+}
+
+opendmr_transcoder_t *opendmr_transcoder_create(void)
+{
+    void *mem = opendmr_mem_alloc(sizeof(opendmr_transcoder_t));
+    if (!mem)
+        return nullptr;
+
+    opendmr_transcoder_t *tc = new (mem) opendmr_transcoder_t();
+    tc->dec = opendmr_decoder_create();
+    if (!tc->dec) {
+        tc->~opendmr_transcoder_t();
+        opendmr_mem_free(mem);
+        return nullptr;
+    }
+    init_directions(tc);
+    return tc;
+}
+
+void opendmr_transcoder_destroy(opendmr_transcoder_t *tc)
+{
+    if (tc) {
+        opendmr_decoder_destroy(tc->dec);
+        tc->~opendmr_transcoder_t();
+        opendmr_mem_free(tc);
+    }
+}
+
+void opendmr_transcoder_reset(opendmr_transcoder_t *tc)
+{
+    if (!tc)
+        return;
+
+    opendmr_decoder_reset(tc->dec);
+
+    /* Re-construct the quantiser state in place */
+    tc->imbe.~imbe_vocoder();
+    new (&tc->imbe) imbe_vocoder();
+    tc->enc.~MBEEncoder();
+    new (&tc->enc) MBEEncoder();
+    init_directions(tc);
+}
+
+/*
+ * Map AMBE+2 model parameters onto the IMBE harmonic grid. The pitch is
+ * the same, so harmonic l maps to harmonic l; IMBE may carry a few more
+ * harmonics than AMBE+2, which repeat the top one.
+ *
+ * mbelib reconstructs log2Ml with a 0.5 * log2(L) term taken out of the
+ * frame gain, which encode_ambe() folds into its log amplitudes; undo
+ * both that and encode_ambe()'s voiced/unvoiced scaling to get sa.
+ */
+static void ambe_to_imbe_params(const opendmr_params_t *p, IMBE_PARAM *ip)
+{
+    float ref_pitch = 2.0f * static_cast<float>(M_PI) / p->w0 * 256.0f;
+    if (ref_pitch < REF_PITCH_MIN)
+        ref_pitch = REF_PITCH_MIN;
+    else if (ref_pitch > REF_PITCH_MAX)
+        ref_pitch = REF_PITCH_MAX;
+
+    memset(ip, 0, sizeof(*ip));
+    ip->ref_pitch = static_cast<int16_t>(ref_pitch);
+    get_num_harms(ip);
+
+    int L = ip->num_harms;
+    for (int l = 0; l < L; l++) {
+        int src = l < p->L ? l : p->L - 1;
+        ip->v_uv_dsn[l] = static_cast<int16_t>((p->vuv >> src) & 1);
+    }
+
+    /* Settle voicing first: the amplitude scale differs by class */
+    get_band_vuv(ip);
+
+    float level = 0.5f * log2f(static_cast<float>(p->L)) + LEVEL_OFFSET;
+    float log_l_2 = 0.5f * log2f(static_cast<float>(L));
+    float log_l_w0 = 0.5f * log2f(static_cast<float>(L) * p->w0) + 2.289f;
+    for (int l = 0; l < L; l++) {
+        int src = l < p->L ? l : p->L - 1;
+        float lsa = p->log2_ml[src] + level - (ip->v_uv_dsn[l] ? log_l_2 : log_l_w0);
+        float sa = exp2f(lsa);
+        if (sa < 1.0f)
+            sa = 1.0f;
+        else if (sa > 32767.0f)
+            sa = 32767.0f;
+        ip->sa[l] = static_cast<int16_t>(lrintf(sa));
+    }
+}
+
+bool opendmr_ambe_to_imbe(opendmr_transcoder_t *tc,
+                          const uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES],
+                          uint8_t imbe[OPENDMR_IMBE_FRAME_BYTES],
+                          int *errs)
+{
+    if (!tc || !ambe || !imbe)
+        return false;
+
+    opendmr_params_t p;
+    opendmr_decode_params(tc->dec, ambe, &p);
+
+    IMBE_PARAM ip;
+    switch (p.frame_class) {
+    case OPENDMR_FRAME_VOICE:
+    case OPENDMR_FRAME_SILENCE:
+    case OPENDMR_FRAME_REPEAT:
+        ambe_to_imbe_params(&p, &ip);
+        tc->ref_pitch = ip.ref_pitch;
+        break;
+    default:
+        /* Erasure, tone and muted frames carry no voice parameters */
+        silent_params(&ip, tc->ref_pitch);
+        break;
+    }
+
+    tc->imbe.encode_params_4400(&ip, imbe);
+
+    if (errs)
+        *errs = p.errs;
+    return true;
+}
+
+bool opendmr_imbe_to_ambe(opendmr_transcoder_t *tc,
+                          const uint8_t imbe[OPENDMR_IMBE_FRAME_BYTES],
+                          uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES])
+{
+    if (!tc || !imbe || !ambe)
+        return false;
+
+    IMBE_PARAM ip;
+    bool valid = tc->imbe.decode_params_4400(imbe, &ip);
+    if (valid) {
+        tc->last = ip;
+        tc->repeats = 0;
+    } else if (++tc->repeats > MAX_REPEATS) {
+        silent_params(&tc->last, tc->last.ref_pitch);
+    }
+
+    int b[9];
+    tc->enc.encode_dmr_params_imbe(&tc->last, b);
+    opendmr_encode_ambe_frame(b, ambe);
+    return valid;
+}
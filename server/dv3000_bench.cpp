@@ -0,0 +1,337 @@
+/*
+ * dv3000_bench - AMBE-3000R packet protocol test client
+ *
+ * Talks to an AMBE-3000R compatible device over a serial port / pty or
+ * an AMBEserver UDP port, selects the DMR rate, then streams decode
+ * (channel packets) or encode (speech packets) requests with a fixed
+ * number in flight. Reports packets per second and round-trip latency.
+ *
+ * Works against dv3000d as well as real hardware.
+ *
+ * Usage:
+ *   dv3000_bench [-e] [-n packets] [-w window] <device | host:port>
+ */
+
+#include "opendmr.h"
+#include "dv3000_proto.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#define DEFAULT_PACKETS     10000
+#define DEFAULT_WINDOW      1
+#define MAX_WINDOW          64
+
+/* Give up when no response arrives for this long */
+#define RESPONSE_TIMEOUT_MS 2000
+
+struct dv3k_link {
+    int fd;
+    bool udp;
+    dv3k_framer framer;
+};
+
+static double now_us(void)
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void print_usage(const char *prog)
+{
+    printf("OpenDMR AMBE-3000R test client v%s\n", opendmr_version());
+    printf("\n");
+    printf("Usage: %s [options] <device | host:port>\n", prog);
+    printf("  -e              Benchmark encoding (speech packets) instead of decoding\n");
+    printf("  -n packets      Packets to send (default %d)\n", DEFAULT_PACKETS);
+    printf("  -w window       Requests in flight (default %d, max %d)\n",
+           DEFAULT_WINDOW, MAX_WINDOW);
+    printf("\n");
+}
+
+static bool open_link(dv3k_link *l, const char *target)
+{
+    dv3k_framer_init(&l->framer);
+
+    const char *colon = strrchr(target, ':');
+    l->udp = target[0] != '/' && colon != nullptr;
+
+    if (!l->udp) {
+        l->fd = open(target, O_RDWR | O_NOCTTY);
+        if (l->fd < 0) {
+            fprintf(stderr, "Error: Cannot open '%s': %s\n", target, strerror(errno));
+            return false;
+        }
+        termios tio;
+        if (tcgetattr(l->fd, &tio) == 0) {
+            cfmakeraw(&tio);
+            cfsetspeed(&tio, B460800);
+            tcsetattr(l->fd, TCSANOW, &tio);
+        }
+        return true;
+    }
+
+    char host[64];
+    size_t hlen = static_cast<size_t>(colon - target);
+    if (hlen >= sizeof(host)) {
+        fprintf(stderr, "Error: Invalid address '%s'\n", target);
+        return false;
+    }
+    memcpy(host, target, hlen);
+    host[hlen] = '\0';
+
+    sockaddr_in sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons(static_cast<uint16_t>(atoi(colon + 1)));
+    if (inet_pton(AF_INET, host, &sa.sin_addr) != 1) {
+        fprintf(stderr, "Error: Invalid address '%s'\n", target);
+        return false;
+    }
+
+    l->fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (l->fd < 0 || connect(l->fd, reinterpret_cast<sockaddr *>(&sa), sizeof(sa)) < 0) {
+        fprintf(stderr, "Error: Cannot connect to '%s': %s\n", target, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+static bool send_packet(dv3k_link *l, const uint8_t *pkt, size_t len)
+{
+    while (len > 0) {
+        ssize_t w = write(l->fd, pkt, len);
+        if (w < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        if (l->udp)
+            return true;
+        pkt += w;
+        len -= static_cast<size_t>(w);
+    }
+    return true;
+}
+
+/* Wait up to timeout_ms for one packet; returns its length or 0 */
+static size_t recv_packet(dv3k_link *l, uint8_t *pkt, int timeout_ms)
+{
+    if (!l->udp) {
+        size_t len = dv3k_framer_next(&l->framer, 0, pkt);
+        if (len)
+            return len;
+    }
+
+    for (;;) {
+        pollfd pfd = { l->fd, POLLIN, 0 };
+        int r = poll(&pfd, 1, timeout_ms);
+        if (r <= 0)
+            return 0;
+
+        if (l->udp) {
+            ssize_t n = recv(l->fd, pkt, DV3K_MAX_PACKET, 0);
+            if (n >= DV3K_HEADER_LEN && pkt[0] == DV3K_START_BYTE)
+                return static_cast<size_t>(n);
+            continue;
+        }
+
+        size_t room;
+        uint8_t *tail = dv3k_framer_tail(&l->framer, &room);
+        ssize_t n = read(l->fd, tail, room);
+        if (n <= 0)
+            return 0;
+        size_t len = dv3k_framer_next(&l->framer, static_cast<size_t>(n), pkt);
+        if (len)
+            return len;
+    }
+}
+
+/* Send a control packet and return the response, or 0 on timeout */
+static size_t control(dv3k_link *l, const uint8_t *fields, size_t n, uint8_t *resp)
+{
+    dv3k_builder b;
+    dv3k_start(&b, DV3K_TYPE_CONTROL);
+    dv3k_put_bytes(&b, fields, n);
+    size_t len = dv3k_finish(&b, true);
+    if (!send_packet(l, b.buf, len))
+        return 0;
+
+    /* Skip any stale data responses still in flight */
+    for (;;) {
+        size_t r = recv_packet(l, resp, RESPONSE_TIMEOUT_MS);
+        if (r == 0 || resp[3] == DV3K_TYPE_CONTROL)
+            return r;
+    }
+}
+
+static bool setup(dv3k_link *l)
+{
+    uint8_t resp[DV3K_MAX_PACKET];
+
+    const uint8_t reset[] = { DV3K_CONTROL_RESET };
+    size_t len = control(l, reset, sizeof(reset), resp);
+    if (len < 5 || resp[4] != DV3K_CONTROL_READY) {
+        fprintf(stderr, "Error: No READY response to reset\n");
+        return false;
+    }
+
+    const uint8_t prodid[] = { DV3K_CONTROL_PRODID, DV3K_CONTROL_VERSTRING };
+    len = control(l, prodid, sizeof(prodid), resp);
+    if (len > 5) {
+        /* Fields are NUL-terminated strings after their identifiers */
+        const char *id = reinterpret_cast<const char *>(resp + 5);
+        size_t idlen = strnlen(id, len - 5);
+        size_t ver_at = 5 + idlen + 2;
+        const char *ver = ver_at < len ? reinterpret_cast<const char *>(resp + ver_at) : "";
+        size_t verlen = ver_at < len ? strnlen(ver, len - ver_at) : 0;
+        printf("Device: %.*s %.*s\n", static_cast<int>(idlen), id,
+               static_cast<int>(verlen), ver);
+    }
+
+    uint8_t ratep[1 + sizeof(DV3K_DMR_RATEP)];
+    ratep[0] = DV3K_CONTROL_RATEP;
+    memcpy(ratep + 1, DV3K_DMR_RATEP, sizeof(DV3K_DMR_RATEP));
+    len = control(l, ratep, sizeof(ratep), resp);
+    if (len < 6 || resp[4] != DV3K_CONTROL_RATEP || resp[5] != 0) {
+        fprintf(stderr, "Error: Device refused the DMR rate\n");
+        return false;
+    }
+    return true;
+}
+
+/* One second of 8 kHz test signal: a gliding two-tone "vowel" */
+static void make_test_pcm(std::vector<int16_t> &pcm)
+{
+    pcm.resize(8000);
+    for (size_t i = 0; i < pcm.size(); i++) {
+        double t = i / 8000.0;
+        double f0 = 120.0 + 40.0 * sin(2.0 * M_PI * 0.5 * t);
+        double v = 0.4 * sin(2.0 * M_PI * f0 * t) + 0.2 * sin(2.0 * M_PI * 3.0 * f0 * t);
+        pcm[i] = static_cast<int16_t>(v * 16384.0);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool encode = false;
+    long packets = DEFAULT_PACKETS;
+    int window = DEFAULT_WINDOW;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "en:w:h")) != -1) {
+        switch (opt) {
+        case 'e': encode = true; break;
+        case 'n': packets = atol(optarg); break;
+        case 'w': window = atoi(optarg); break;
+        default:
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (optind != argc - 1 || packets < 1 || window < 1 || window > MAX_WINDOW) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    dv3k_link l;
+    if (!open_link(&l, argv[optind]) || !setup(&l))
+        return 1;
+
+    /* Pre-build one request per 20 ms frame of the test signal */
+    std::vector<int16_t> pcm;
+    make_test_pcm(pcm);
+    size_t frames = pcm.size() / OPENDMR_PCM_SAMPLES;
+    std::vector<dv3k_builder> requests(frames);
+
+    opendmr_encoder_t *enc = opendmr_encoder_create();
+    for (size_t f = 0; f < frames; f++) {
+        const int16_t *in = &pcm[f * OPENDMR_PCM_SAMPLES];
+        dv3k_builder *b = &requests[f];
+        if (encode) {
+            dv3k_start(b, DV3K_TYPE_AUDIO);
+            dv3k_put(b, DV3K_AUDIO_SPCHD);
+            dv3k_put(b, OPENDMR_PCM_SAMPLES);
+            for (int s = 0; s < OPENDMR_PCM_SAMPLES; s++) {
+                dv3k_put(b, static_cast<uint8_t>(in[s] >> 8));
+                dv3k_put(b, static_cast<uint8_t>(in[s]));
+            }
+        } else {
+            uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES];
+            opendmr_encode(enc, in, ambe);
+            dv3k_start(b, DV3K_TYPE_AMBE);
+            dv3k_put(b, DV3K_AMBE_CHAND);
+            dv3k_put(b, OPENDMR_AMBE_FRAME_BYTES * 8);
+            dv3k_put_bytes(b, ambe, sizeof(ambe));
+        }
+        dv3k_finish(b, true);
+    }
+    opendmr_encoder_destroy(enc);
+
+    uint8_t expect = encode ? DV3K_TYPE_AMBE : DV3K_TYPE_AUDIO;
+    std::vector<double> rtt;
+    rtt.reserve(static_cast<size_t>(packets));
+    double sent_at[MAX_WINDOW];
+    long sent = 0, received = 0;
+    uint8_t resp[DV3K_MAX_PACKET];
+
+    double start = now_us();
+    while (received < packets) {
+        /* Responses come back in order, so sent_at is a FIFO */
+        while (sent < packets && sent - received < window) {
+            const dv3k_builder *b = &requests[static_cast<size_t>(sent) % frames];
+            sent_at[sent % MAX_WINDOW] = now_us();
+            if (!send_packet(&l, b->buf, b->len)) {
+                fprintf(stderr, "Error: Write failed: %s\n", strerror(errno));
+                return 1;
+            }
+            sent++;
+        }
+
+        size_t len = recv_packet(&l, resp, RESPONSE_TIMEOUT_MS);
+        if (len == 0) {
+            fprintf(stderr, "Error: Timed out with %ld of %ld responses\n",
+                    received, packets);
+            break;
+        }
+        if (resp[3] != expect)
+            continue;
+        rtt.push_back(now_us() - sent_at[received % MAX_WINDOW]);
+        received++;
+    }
+    double elapsed = (now_us() - start) / 1e6;
+    close(l.fd);
+
+    if (rtt.empty())
+        return 1;
+
+    std::sort(rtt.begin(), rtt.end());
+    double sum = 0.0;
+    for (double v : rtt)
+        sum += v;
+    size_t n = rtt.size();
+
+    printf("Mode:       %s, window %d\n", encode ? "encode" : "decode", window);
+    printf("Packets:    %zu in %.3f s\n", n, elapsed);
+    printf("Throughput: %.0f packets/s (%.1fx real time)\n",
+           n / elapsed, n / elapsed / 50.0);
+    printf("RTT (us):   mean %.0f  p50 %.0f  p90 %.0f  p99 %.0f  max %.0f\n",
+           sum / n, rtt[n / 2], rtt[n * 9 / 10], rtt[n * 99 / 100], rtt[n - 1]);
+
+    return received == packets ? 0 : 1;
+}
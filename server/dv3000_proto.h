@@ -0,0 +1,174 @@
+/*
+ * OpenDMR - Open Source DMR (AMBE+2) Vocoder Library
+ *
+ * DVSI AMBE-3000R packet protocol definitions, shared by the software
+ * vocoder server and its test client.
+ *
+ * Packet layout (same bytes on a serial line and in AMBEserver UDP
+ * datagrams):
+ *
+ *   0x61 | length (16-bit BE) | type | fields ... | [0x2F parity]
+ *
+ * length counts the bytes after the type byte, including the optional
+ * parity field. The parity byte is the XOR of every byte after the start
+ * byte up to and including the 0x2F field identifier.
+ */
+
+#ifndef DV3000_PROTO_H
+#define DV3000_PROTO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define DV3K_START_BYTE         0x61
+#define DV3K_HEADER_LEN         4
+#define DV3K_MAX_PACKET         512
+
+/* Packet types */
+#define DV3K_TYPE_CONTROL       0x00
+#define DV3K_TYPE_AMBE          0x01
+#define DV3K_TYPE_AUDIO         0x02
+
+/* Control packet fields */
+#define DV3K_CONTROL_ECMODE     0x05
+#define DV3K_CONTROL_DCMODE     0x06
+#define DV3K_CONTROL_RATET      0x09
+#define DV3K_CONTROL_RATEP      0x0A
+#define DV3K_CONTROL_INIT       0x0B
+#define DV3K_CONTROL_LOWPOWER   0x10
+#define DV3K_CONTROL_CHANFMT    0x15
+#define DV3K_CONTROL_SPCHFMT    0x16
+#define DV3K_CONTROL_PARITYBYTE 0x2F
+#define DV3K_CONTROL_PRODID     0x30
+#define DV3K_CONTROL_VERSTRING  0x31
+#define DV3K_CONTROL_COMPAND    0x32
+#define DV3K_CONTROL_RESET      0x33
+#define DV3K_CONTROL_RESETSOFTCFG 0x34
+#define DV3K_CONTROL_READY      0x39
+#define DV3K_CONTROL_PARITYMODE 0x3F
+#define DV3K_CONTROL_CHANNEL0   0x40
+#define DV3K_CONTROL_GAIN       0x4B
+
+/* Channel (AMBE) and speech packet fields */
+#define DV3K_AMBE_CHAND         0x01
+#define DV3K_AMBE_CMODE         0x02
+#define DV3K_AMBE_TONE          0x08
+#define DV3K_AUDIO_SPCHD        0x00
+
+/* DMR AMBE+2 3600x2450: rate table index and the equivalent RATEP words */
+#define DV3K_DMR_RATET          33
+static const uint8_t DV3K_DMR_RATEP[12] = {
+    0x04, 0x31, 0x07, 0x54, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00, 0x6F, 0x48
+};
+
+/* Parity over a packet of len bytes whose last byte is the parity byte */
+static inline uint8_t dv3k_parity(const uint8_t *pkt, size_t len)
+{
+    uint8_t p = 0;
+    for (size_t i = 1; i + 1 < len; i++)
+        p ^= pkt[i];
+    return p;
+}
+
+/* Packet builder: start, then append fields, then finish */
+struct dv3k_builder {
+    uint8_t buf[DV3K_MAX_PACKET];
+    size_t len;
+};
+
+static inline void dv3k_start(dv3k_builder *b, uint8_t type)
+{
+    b->buf[0] = DV3K_START_BYTE;
+    b->buf[3] = type;
+    b->len = DV3K_HEADER_LEN;
+}
+
+static inline void dv3k_put(dv3k_builder *b, uint8_t byte)
+{
+    if (b->len < DV3K_MAX_PACKET)
+        b->buf[b->len++] = byte;
+}
+
+static inline void dv3k_put_bytes(dv3k_builder *b, const void *data, size_t n)
+{
+    if (b->len + n <= DV3K_MAX_PACKET) {
+        memcpy(b->buf + b->len, data, n);
+        b->len += n;
+    }
+}
+
+/* Fill in the length and, if requested, append the parity field */
+static inline size_t dv3k_finish(dv3k_builder *b, bool parity)
+{
+    if (parity) {
+        dv3k_put(b, DV3K_CONTROL_PARITYBYTE);
+        dv3k_put(b, 0);
+    }
+    size_t payload = b->len - DV3K_HEADER_LEN;
+    b->buf[1] = static_cast<uint8_t>(payload >> 8);
+    b->buf[2] = static_cast<uint8_t>(payload);
+    if (parity)
+        b->buf[b->len - 1] = dv3k_parity(b->buf, b->len);
+    return b->len;
+}
+
+/*
+ * Byte-stream re-framer for serial/pty links. Bytes before a start byte
+ * and packets with an implausible length are skipped, so the reader
+ * resynchronises after line noise.
+ */
+struct dv3k_framer {
+    uint8_t buf[DV3K_MAX_PACKET * 2];
+    size_t fill;
+};
+
+static inline void dv3k_framer_init(dv3k_framer *f)
+{
+    f->fill = 0;
+}
+
+/* Space available for the next read() */
+static inline uint8_t *dv3k_framer_tail(dv3k_framer *f, size_t *room)
+{
+    *room = sizeof(f->buf) - f->fill;
+    return f->buf + f->fill;
+}
+
+/*
+ * Account for n bytes read into the tail, then extract one packet.
+ * Call with n = 0 to extract further packets already buffered.
+ * Returns the packet length (copied to pkt), or 0 if none is complete.
+ */
+static inline size_t dv3k_framer_next(dv3k_framer *f, size_t n, uint8_t *pkt)
+{
+    f->fill += n;
+    for (;;) {
+        size_t skip = 0;
+        while (skip < f->fill && f->buf[skip] != DV3K_START_BYTE)
+            skip++;
+        if (skip) {
+            memmove(f->buf, f->buf + skip, f->fill - skip);
+            f->fill -= skip;
+        }
+        if (f->fill < DV3K_HEADER_LEN)
+            return 0;
+
+        size_t total = DV3K_HEADER_LEN + ((size_t)f->buf[1] << 8 | f->buf[2]);
+        if (total > DV3K_MAX_PACKET) {
+            /* Not a real start byte: drop it and rescan */
+            memmove(f->buf, f->buf + 1, f->fill - 1);
+            f->fill -= 1;
+            continue;
+        }
+        if (f->fill < total)
+            return 0;
+
+        memcpy(pkt, f->buf, total);
+        memmove(f->buf, f->buf + total, f->fill - total);
+        f->fill -= total;
+        return total;
+    }
+}
+
+#endif /* DV3000_PROTO_H */
@@ -0,0 +1,669 @@
+/*
+ * dv3000d - Software AMBE-3000R vocoder server
+ *
+ * Emulates DVSI AMBE-3000R (DV3000 / ThumbDV) hardware on top of
+ * libopendmr so existing DMR gateway software can use it unchanged.
+ * Every virtual channel looks like one single-channel AMBE-3000R and is
+ * reachable both as a pseudo-terminal (the serial/USB protocol) and as a
+ * loopback UDP port (AMBEserver framing: one packet per datagram).
+ *
+ * Channels are owned by worker threads (channel % workers), so each
+ * channel's codec state is only ever touched by one thread and its
+ * packets are answered in order. Rate selection (RATET/RATEP), gain,
+ * parity mode and codec resets are tracked per channel. Only the DMR
+ * AMBE+2 3600x2450 rate is supported; other rates are refused with a
+ * non-zero status and data packets for that channel are dropped.
+ *
+ * Usage:
+ *   dv3000d [-n channels] [-t workers] [-a address] [-p port]
+ *           [-l link_prefix] [-P] [-U]
+ */
+
+#include "opendmr.h"
+#include "dv3000_proto.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define DEFAULT_CHANNELS        4
+#define DEFAULT_UDP_PORT        2460
+#define MAX_CHANNELS            256
+
+/* Packets queued per worker before new ones are dropped (device overrun) */
+#define MAX_QUEUE               1024
+
+#define DMR_FRAME_BITS          (OPENDMR_AMBE_FRAME_BYTES * 8)
+
+static const char PRODID[] = "AMBE3000R";
+
+struct channel {
+    int index;
+    opendmr_decoder_t *dec;
+    opendmr_encoder_t *enc;
+
+    /* Per-channel device configuration */
+    bool rate_ok;               /* DMR rate selected */
+    bool parity;                /* Append parity fields to responses */
+    float out_gain;             /* Decoder output gain (linear) */
+
+    /* Endpoints */
+    int pty_master;
+    int pty_slave;              /* Held open so the master never sees EOF */
+    int udp;
+    dv3k_framer framer;
+
+    /* Statistics, written by the owning worker only */
+    unsigned long decoded;
+    unsigned long encoded;
+    unsigned long control;
+    unsigned long rejected;
+    unsigned long dropped;      /* Queue overruns, written by the I/O thread */
+};
+
+struct job {
+    channel *ch;
+    bool udp;
+    sockaddr_storage from;
+    socklen_t fromlen;
+    size_t len;
+    uint8_t pkt[DV3K_MAX_PACKET];
+};
+
+struct worker {
+    std::thread thread;
+    std::mutex lock;
+    std::condition_variable ready;
+    std::deque<job> queue;
+};
+
+static volatile sig_atomic_t g_running = 1;
+static std::atomic<bool> g_stopping(false);
+
+static void on_signal(int)
+{
+    g_running = 0;
+}
+
+static void print_usage(const char *prog)
+{
+    printf("OpenDMR AMBE-3000R server v%s\n", opendmr_version());
+    printf("\n");
+    printf("Usage: %s [options]\n", prog);
+    printf("  -n channels     Virtual channels (default %d, max %d)\n",
+           DEFAULT_CHANNELS, MAX_CHANNELS);
+    printf("  -t workers      Worker threads (default: CPU count)\n");
+    printf("  -a address      UDP bind address (default 127.0.0.1)\n");
+    printf("  -p port         UDP port of channel 0; channel n uses port+n (default %d)\n",
+           DEFAULT_UDP_PORT);
+    printf("  -l prefix       Symlink channel n's pty to <prefix>n\n");
+    printf("  -P              Disable pty endpoints\n");
+    printf("  -U              Disable UDP endpoints\n");
+    printf("\n");
+}
+
+/*
+ * ============================================================================
+ * Packet handling (worker threads)
+ * ============================================================================
+ */
+
+static void reset_channel(channel *ch)
+{
+    opendmr_decoder_reset(ch->dec);
+    opendmr_encoder_reset(ch->enc);
+    opendmr_encoder_set_gain(ch->enc, 0);
+    ch->rate_ok = true;
+    ch->parity = true;
+    ch->out_gain = 1.0f;
+}
+
+static void handle_control(channel *ch, const uint8_t *p, size_t n, dv3k_builder *out)
+{
+    bool parity_after = ch->parity;
+    size_t i = 0;
+
+    dv3k_start(out, DV3K_TYPE_CONTROL);
+    while (i < n) {
+        uint8_t field = p[i++];
+        size_t left = n - i;
+
+        switch (field) {
+        case DV3K_CONTROL_RATET:
+            if (left < 1)
+                return;
+            ch->rate_ok = p[i] == DV3K_DMR_RATET;
+            dv3k_put(out, field);
+            dv3k_put(out, ch->rate_ok ? 0 : 1);
+            i += 1;
+            break;
+
+        case DV3K_CONTROL_RATEP:
+            if (left < sizeof(DV3K_DMR_RATEP))
+                return;
+            ch->rate_ok = memcmp(p + i, DV3K_DMR_RATEP, sizeof(DV3K_DMR_RATEP)) == 0;
+            dv3k_put(out, field);
+            dv3k_put(out, ch->rate_ok ? 0 : 1);
+            i += sizeof(DV3K_DMR_RATEP);
+            break;
+
+        case DV3K_CONTROL_INIT:
+            if (left < 1)
+                return;
+            if (p[i] & 1)
+                opendmr_encoder_reset(ch->enc);
+            if (p[i] & 2)
+                opendmr_decoder_reset(ch->dec);
+            dv3k_put(out, field);
+            dv3k_put(out, 0);
+            i += 1;
+            break;
+
+        case DV3K_CONTROL_GAIN: {
+            if (left < 2)
+                return;
+            int in_db = static_cast<int8_t>(p[i]);
+            int out_db = static_cast<int8_t>(p[i + 1]);
+            opendmr_encoder_set_gain(ch->enc, in_db);
+            ch->out_gain = powf(10.0f, out_db / 20.0f);
+            dv3k_put(out, field);
+            dv3k_put(out, 0);
+            i += 2;
+            break;
+        }
+
+        case DV3K_CONTROL_PARITYMODE:
+            if (left < 1)
+                return;
+            parity_after = p[i] != 0;
+            dv3k_put(out, field);
+            dv3k_put(out, p[i] <= 1 ? 0 : 1);
+            i += 1;
+            break;
+
+        case DV3K_CONTROL_COMPAND:
+            /* Only linear 16-bit samples are supported */
+            if (left < 1)
+                return;
+            dv3k_put(out, field);
+            dv3k_put(out, (p[i] & 1) ? 1 : 0);
+            i += 1;
+            break;
+
+        case DV3K_CONTROL_ECMODE:
+        case DV3K_CONTROL_DCMODE:
+        case DV3K_CONTROL_CHANFMT:
+        case DV3K_CONTROL_SPCHFMT:
+            /* Accepted, no effect on this codec */
+            if (left < 2)
+                return;
+            dv3k_put(out, field);
+            dv3k_put(out, 0);
+            i += 2;
+            break;
+
+        case DV3K_CONTROL_LOWPOWER:
+            if (left < 1)
+                return;
+            dv3k_put(out, field);
+            dv3k_put(out, 0);
+            i += 1;
+            break;
+
+        case DV3K_CONTROL_CHANNEL0:
+            dv3k_put(out, field);
+            dv3k_put(out, 0);
+            break;
+
+        case DV3K_CONTROL_PRODID:
+            dv3k_put(out, field);
+            dv3k_put_bytes(out, PRODID, sizeof(PRODID));
+            break;
+
+        case DV3K_CONTROL_VERSTRING: {
+            char ver[48];
+            int len = snprintf(ver, sizeof(ver), "OpenDMR V%s", opendmr_version());
+            dv3k_put(out, field);
+            dv3k_put_bytes(out, ver, static_cast<size_t>(len) + 1);
+            break;
+        }
+
+        case DV3K_CONTROL_RESETSOFTCFG:
+            if (left < 6)
+                return;
+            i += 6;
+            /* fall through */
+        case DV3K_CONTROL_RESET:
+            reset_channel(ch);
+            parity_after = ch->parity;
+            dv3k_put(out, DV3K_CONTROL_READY);
+            break;
+
+        default:
+            /* Unknown field: its length is unknown, stop here */
+            ch->parity = parity_after;
+            return;
+        }
+    }
+    ch->control++;
+    ch->parity = parity_after;
+}
+
+static bool handle_ambe(channel *ch, const uint8_t *p, size_t n, dv3k_builder *out)
+{
+    size_t i = 0;
+    while (i < n) {
+        uint8_t field = p[i++];
+        if (field == DV3K_CONTROL_CHANNEL0)
+            continue;
+        if (field == DV3K_AMBE_CMODE) {
+            i += 2;
+            continue;
+        }
+        if (field != DV3K_AMBE_CHAND || i >= n)
+            return false;
+
+        size_t bits = p[i++];
+        if (bits != DMR_FRAME_BITS || n - i < OPENDMR_AMBE_FRAME_BYTES || !ch->rate_ok)
+            return false;
+
+        int16_t pcm[OPENDMR_PCM_SAMPLES];
+        opendmr_decode(ch->dec, p + i, pcm, nullptr);
+
+        dv3k_start(out, DV3K_TYPE_AUDIO);
+        dv3k_put(out, DV3K_AUDIO_SPCHD);
+        dv3k_put(out, OPENDMR_PCM_SAMPLES);
+        for (int s = 0; s < OPENDMR_PCM_SAMPLES; s++) {
+            int v = pcm[s];
+            if (ch->out_gain != 1.0f) {
+                v = static_cast<int>(lrintf(v * ch->out_gain));
+                v = v > 32767 ? 32767 : (v < -32768 ? -32768 : v);
+            }
+            dv3k_put(out, static_cast<uint8_t>(v >> 8));
+            dv3k_put(out, static_cast<uint8_t>(v));
+        }
+        ch->decoded++;
+        return true;
+    }
+    return false;
+}
+
+static bool handle_audio(channel *ch, const uint8_t *p, size_t n, dv3k_builder *out)
+{
+    size_t i = 0;
+    while (i < n) {
+        uint8_t field = p[i++];
+        if (field == DV3K_CONTROL_CHANNEL0)
+            continue;
+        if (field == DV3K_AMBE_CMODE) {
+            i += 2;
+            continue;
+        }
+        if (field != DV3K_AUDIO_SPCHD || i >= n)
+            return false;
+
+        size_t samples = p[i++];
+        if (samples != OPENDMR_PCM_SAMPLES || n - i < 2 * samples || !ch->rate_ok)
+            return false;
+
+        int16_t pcm[OPENDMR_PCM_SAMPLES];
+        for (int s = 0; s < OPENDMR_PCM_SAMPLES; s++)
+            pcm[s] = static_cast<int16_t>(p[i + 2 * s] << 8 | p[i + 2 * s + 1]);
+
+        uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES];
+        opendmr_encode(ch->enc, pcm, ambe);
+
+        dv3k_start(out, DV3K_TYPE_AMBE);
+        dv3k_put(out, DV3K_AMBE_CHAND);
+        dv3k_put(out, DMR_FRAME_BITS);
+        dv3k_put_bytes(out, ambe, sizeof(ambe));
+        ch->encoded++;
+        return true;
+    }
+    return false;
+}
+
+/* Returns the response length, or 0 if the packet gets no response */
+static size_t handle_packet(channel *ch, const uint8_t *pkt, size_t len, dv3k_builder *out)
+{
+    if (len < DV3K_HEADER_LEN || pkt[0] != DV3K_START_BYTE)
+        return 0;
+
+    size_t n = len - DV3K_HEADER_LEN;
+    const uint8_t *p = pkt + DV3K_HEADER_LEN;
+
+    /* Parity is optional on input; verify and strip it when present */
+    if (n >= 2 && p[n - 2] == DV3K_CONTROL_PARITYBYTE) {
+        if (dv3k_parity(pkt, len) != pkt[len - 1]) {
+            ch->rejected++;
+            return 0;
+        }
+        n -= 2;
+    }
+
+    bool ok;
+    switch (pkt[3]) {
+    case DV3K_TYPE_CONTROL:
+        handle_control(ch, p, n, out);
+        ok = out->len > DV3K_HEADER_LEN;
+        break;
+    case DV3K_TYPE_AMBE:
+        ok = handle_ambe(ch, p, n, out);
+        break;
+    case DV3K_TYPE_AUDIO:
+        ok = handle_audio(ch, p, n, out);
+        break;
+    default:
+        ok = false;
+        break;
+    }
+
+    if (!ok) {
+        ch->rejected++;
+        return 0;
+    }
+    return dv3k_finish(out, ch->parity);
+}
+
+static void write_all(int fd, const uint8_t *buf, size_t len)
+{
+    while (len > 0) {
+        ssize_t w = write(fd, buf, len);
+        if (w < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN) {
+                pollfd pfd = { fd, POLLOUT, 0 };
+                poll(&pfd, 1, 100);
+                continue;
+            }
+            return;
+        }
+        buf += w;
+        len -= static_cast<size_t>(w);
+    }
+}
+
+static void worker_main(worker *w)
+{
+    dv3k_builder out;
+    for (;;) {
+        job j;
+        {
+            std::unique_lock<std::mutex> lk(w->lock);
+            w->ready.wait(lk, [w] { return !w->queue.empty() || g_stopping; });
+            if (w->queue.empty())
+                break;
+            j = w->queue.front();
+            w->queue.pop_front();
+        }
+
+        size_t len = handle_packet(j.ch, j.pkt, j.len, &out);
+        if (len == 0)
+            continue;
+        if (j.udp)
+            sendto(j.ch->udp, out.buf, len, 0,
+                   reinterpret_cast<sockaddr *>(&j.from), j.fromlen);
+        else
+            write_all(j.ch->pty_master, out.buf, len);
+    }
+    opendmr_thread_release();
+}
+
+/*
+ * ============================================================================
+ * Endpoints and I/O loop
+ * ============================================================================
+ */
+
+static bool open_pty(channel *ch, const char *link_prefix)
+{
+    int m = posix_openpt(O_RDWR | O_NOCTTY);
+    if (m < 0 || grantpt(m) < 0 || unlockpt(m) < 0) {
+        perror("posix_openpt");
+        if (m >= 0)
+            close(m);
+        return false;
+    }
+
+    const char *name = ptsname(m);
+    int s = name ? open(name, O_RDWR | O_NOCTTY) : -1;
+    if (s < 0) {
+        perror("open pty");
+        close(m);
+        return false;
+    }
+
+    /* Raw 8-bit line in both directions */
+    termios tio;
+    if (tcgetattr(s, &tio) == 0) {
+        cfmakeraw(&tio);
+        tcsetattr(s, TCSANOW, &tio);
+    }
+    fcntl(m, F_SETFL, fcntl(m, F_GETFL) | O_NONBLOCK);
+
+    ch->pty_master = m;
+    ch->pty_slave = s;
+
+    if (link_prefix) {
+        char link[256];
+        snprintf(link, sizeof(link), "%s%d", link_prefix, ch->index);
+        unlink(link);
+        if (symlink(name, link) < 0)
+            perror("symlink");
+        printf("channel %d: pty %s -> %s\n", ch->index, link, name);
+    } else {
+        printf("channel %d: pty %s\n", ch->index, name);
+    }
+    return true;
+}
+
+static bool open_udp(channel *ch, const char *addr, int port)
+{
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return false;
+    }
+
+    sockaddr_in sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, addr, &sa.sin_addr) != 1) {
+        fprintf(stderr, "Error: Invalid address '%s'\n", addr);
+        close(fd);
+        return false;
+    }
+    if (bind(fd, reinterpret_cast<sockaddr *>(&sa), sizeof(sa)) < 0) {
+        fprintf(stderr, "Error: Cannot bind %s:%d: %s\n", addr, port, strerror(errno));
+        close(fd);
+        return false;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    ch->udp = fd;
+    printf("channel %d: udp %s:%d\n", ch->index, addr, port);
+    return true;
+}
+
+static void dispatch(worker *w, job &j)
+{
+    {
+        std::lock_guard<std::mutex> lk(w->lock);
+        if (w->queue.size() >= MAX_QUEUE) {
+            j.ch->dropped++;
+            return;
+        }
+        w->queue.push_back(j);
+    }
+    w->ready.notify_one();
+}
+
+int main(int argc, char **argv)
+{
+    int num_channels = DEFAULT_CHANNELS;
+    int num_workers = static_cast<int>(std::thread::hardware_concurrency());
+    const char *addr = "127.0.0.1";
+    int port = DEFAULT_UDP_PORT;
+    const char *link_prefix = nullptr;
+    bool use_pty = true;
+    bool use_udp = true;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:t:a:p:l:PUh")) != -1) {
+        switch (opt) {
+        case 'n': num_channels = atoi(optarg); break;
+        case 't': num_workers = atoi(optarg); break;
+        case 'a': addr = optarg; break;
+        case 'p': port = atoi(optarg); break;
+        case 'l': link_prefix = optarg; break;
+        case 'P': use_pty = false; break;
+        case 'U': use_udp = false; break;
+        default:
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (num_channels < 1 || num_channels > MAX_CHANNELS || (!use_pty && !use_udp)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (num_workers < 1)
+        num_workers = 1;
+    if (num_workers > num_channels)
+        num_workers = num_channels;
+
+    std::vector<channel> channels(static_cast<size_t>(num_channels));
+    for (int c = 0; c < num_channels; c++) {
+        channel *ch = &channels[static_cast<size_t>(c)];
+        memset(ch, 0, sizeof(*ch));
+        ch->index = c;
+        ch->pty_master = ch->pty_slave = ch->udp = -1;
+        ch->dec = opendmr_decoder_create();
+        ch->enc = opendmr_encoder_create();
+        if (!ch->dec || !ch->enc) {
+            fprintf(stderr, "Error: Cannot create codec for channel %d\n", c);
+            return 1;
+        }
+        reset_channel(ch);
+        dv3k_framer_init(&ch->framer);
+
+        if (use_pty && !open_pty(ch, link_prefix))
+            return 1;
+        if (use_udp && !open_udp(ch, addr, port + c))
+            return 1;
+    }
+    printf("%d channel(s), %d worker(s)\n", num_channels, num_workers);
+    fflush(stdout);
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    signal(SIGPIPE, SIG_IGN);
+
+    std::vector<worker> workers(static_cast<size_t>(num_workers));
+    for (auto &w : workers)
+        w.thread = std::thread(worker_main, &w);
+
+    /* One poll set over every endpoint; fds[k] belongs to owner[k] */
+    std::vector<pollfd> fds;
+    std::vector<channel *> owner;
+    for (auto &ch : channels) {
+        if (ch.pty_master >= 0) {
+            fds.push_back(pollfd{ ch.pty_master, POLLIN, 0 });
+            owner.push_back(&ch);
+        }
+        if (ch.udp >= 0) {
+            fds.push_back(pollfd{ ch.udp, POLLIN, 0 });
+            owner.push_back(&ch);
+        }
+    }
+
+    job j;
+    while (g_running) {
+        int r = poll(fds.data(), fds.size(), 500);
+        if (r <= 0)
+            continue;
+
+        for (size_t k = 0; k < fds.size(); k++) {
+            if (!(fds[k].revents & POLLIN))
+                continue;
+            channel *ch = owner[k];
+            worker *w = &workers[static_cast<size_t>(ch->index % num_workers)];
+            j.ch = ch;
+
+            if (fds[k].fd == ch->udp) {
+                for (;;) {
+                    j.fromlen = sizeof(j.from);
+                    ssize_t n = recvfrom(ch->udp, j.pkt, sizeof(j.pkt), 0,
+                                         reinterpret_cast<sockaddr *>(&j.from), &j.fromlen);
+                    if (n <= 0)
+                        break;
+                    j.udp = true;
+                    j.len = static_cast<size_t>(n);
+                    dispatch(w, j);
+                }
+            } else {
+                size_t room;
+                uint8_t *tail = dv3k_framer_tail(&ch->framer, &room);
+                ssize_t n = read(ch->pty_master, tail, room);
+                if (n <= 0)
+                    continue;
+                j.udp = false;
+                size_t got = static_cast<size_t>(n);
+                while ((j.len = dv3k_framer_next(&ch->framer, got, j.pkt)) > 0) {
+                    got = 0;
+                    dispatch(w, j);
+                }
+            }
+        }
+    }
+
+    g_stopping = true;
+    for (auto &w : workers) {
+        {
+            /* Pairs with the predicate check in worker_main() */
+            std::lock_guard<std::mutex> lk(w.lock);
+        }
+        w.ready.notify_all();
+        w.thread.join();
+    }
+
+    printf("\n%-8s %10s %10s %8s %8s %8s\n",
+           "channel", "decoded", "encoded", "control", "rejected", "dropped");
+    for (auto &ch : channels) {
+        printf("%-8d %10lu %10lu %8lu %8lu %8lu\n", ch.index, ch.decoded,
+               ch.encoded, ch.control, ch.rejected, ch.dropped);
+        opendmr_decoder_destroy(ch.dec);
+        opendmr_encoder_destroy(ch.enc);
+        if (ch.pty_master >= 0)
+            close(ch.pty_master);
+        if (ch.pty_slave >= 0)
+            close(ch.pty_slave);
+        if (ch.udp >= 0)
+            close(ch.udp);
+        if (link_prefix && ch.pty_master >= 0) {
+            char link[256];
+            snprintf(link, sizeof(link), "%s%d", link_prefix, ch.index);
+            unlink(link);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,284 @@
+/*
+ * OpenDMR - Open Source DMR (AMBE+2) Vocoder Library
+ *
+ * Client side of the shared-memory transcoding service: segment attach,
+ * stream slot claiming and the producer/consumer ends of the rings.
+ */
+
+#include "opendmr_shm.h"
+#include "shm_layout.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <new>
+
+static_assert(OPENDMR_SHM_RING_FRAMES == SHM_RING_FRAMES, "ring size mismatch");
+
+#define RING_MASK   (SHM_RING_FRAMES - 1)
+
+struct opendmr_shm {
+    shm_header *hdr;
+    size_t size;
+    opendmr_shm_stream_t *streams;  /* Open streams, closed on detach */
+};
+
+struct opendmr_shm_stream {
+    opendmr_shm_t *shm;
+    shm_slot *slot;
+    shm_worker *worker;
+    opendmr_shm_mode_t mode;
+    uint32_t seq;
+    opendmr_shm_stream_t *next;
+};
+
+opendmr_shm_t *opendmr_shm_attach(const char *name)
+{
+    int fd = shm_open(name ? name : OPENDMR_SHM_DEFAULT_NAME, O_RDWR, 0);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(shm_header)) {
+        close(fd);
+        return nullptr;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void *mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED)
+        return nullptr;
+
+    shm_header *hdr = static_cast<shm_header *>(mem);
+    if (__atomic_load_n(&hdr->magic, __ATOMIC_ACQUIRE) != SHM_MAGIC ||
+        hdr->version != SHM_VERSION || hdr->num_workers == 0 ||
+        shm_segment_size(hdr->num_slots) > size) {
+        munmap(mem, size);
+        return nullptr;
+    }
+
+    opendmr_shm_t *shm = new (std::nothrow) opendmr_shm_t;
+    if (!shm) {
+        munmap(mem, size);
+        return nullptr;
+    }
+    shm->hdr = hdr;
+    shm->size = size;
+    shm->streams = nullptr;
+    return shm;
+}
+
+void opendmr_shm_detach(opendmr_shm_t *shm)
+{
+    if (!shm)
+        return;
+
+    while (shm->streams)
+        opendmr_shm_stream_close(shm->streams);
+    munmap(shm->hdr, shm->size);
+    delete shm;
+}
+
+opendmr_shm_stream_t *opendmr_shm_stream_open(opendmr_shm_t *shm, opendmr_shm_mode_t mode)
+{
+    if (!shm || (mode != OPENDMR_SHM_DECODE && mode != OPENDMR_SHM_ENCODE))
+        return nullptr;
+
+    opendmr_shm_stream_t *s = new (std::nothrow) opendmr_shm_stream_t;
+    if (!s)
+        return nullptr;
+
+    shm_header *hdr = shm->hdr;
+    for (uint32_t i = 0; i < hdr->num_slots; i++) {
+        shm_slot *slot = &hdr->slots[i];
+        uint32_t expected = SHM_SLOT_FREE;
+        if (!slot->state.compare_exchange_strong(expected, SHM_SLOT_CLAIMED))
+            continue;
+
+        /* The service ignores claimed slots, so this is safe to reset */
+        slot->mode = mode;
+        slot->owner = getpid();
+        slot->req.head.store(0, std::memory_order_relaxed);
+        slot->req.tail.store(0, std::memory_order_relaxed);
+        slot->resp.head.store(0, std::memory_order_relaxed);
+        slot->resp.tail.store(0, std::memory_order_relaxed);
+        slot->resp_sleeping.store(0, std::memory_order_relaxed);
+        slot->generation.fetch_add(1, std::memory_order_relaxed);
+        slot->state.store(SHM_SLOT_OPEN, std::memory_order_release);
+
+        s->shm = shm;
+        s->slot = slot;
+        s->worker = &hdr->workers[shm_slot_worker(hdr, i)];
+        s->mode = mode;
+        s->seq = 0;
+        s->next = shm->streams;
+        shm->streams = s;
+        return s;
+    }
+
+    delete s;
+    return nullptr;
+}
+
+void opendmr_shm_stream_close(opendmr_shm_stream_t *s)
+{
+    if (!s)
+        return;
+
+    for (opendmr_shm_stream_t **p = &s->shm->streams; *p; p = &(*p)->next) {
+        if (*p == s) {
+            *p = s->next;
+            break;
+        }
+    }
+
+    /* The owning worker frees the slot; its codec is reset when the next
+     * owner opens it under a new generation */
+    s->slot->state.store(SHM_SLOT_CLOSING);
+    shm_futex_notify(&s->worker->doorbell, &s->worker->sleeping);
+    delete s;
+}
+
+/*
+ * ============================================================================
+ * Ring ends
+ * ============================================================================
+ */
+
+/* Producer end of the request ring; fill(rec, i) writes frame i */
+template <typename Fill>
+static size_t push_frames(opendmr_shm_stream_t *s, size_t frames, Fill fill)
+{
+    shm_ring *r = &s->slot->req;
+    uint32_t tail = r->tail.load(std::memory_order_relaxed);
+    uint32_t head = r->head.load(std::memory_order_acquire);
+
+    size_t space = SHM_RING_FRAMES - (tail - head);
+    size_t n = frames < space ? frames : space;
+    if (n == 0)
+        return 0;
+
+    for (size_t i = 0; i < n; i++) {
+        shm_record *rec = &r->rec[(tail + i) & RING_MASK];
+        rec->seq = s->seq++;
+        fill(rec, i);
+    }
+
+    /* Sequentially consistent: pairs with the worker's sleep announcement */
+    r->tail.store(tail + static_cast<uint32_t>(n));
+    shm_futex_notify(&s->worker->doorbell, &s->worker->sleeping);
+    return n;
+}
+
+/* Consumer end of the response ring; take(rec, i) reads frame i */
+template <typename Take>
+static size_t pull_frames(opendmr_shm_stream_t *s, size_t frames, Take take)
+{
+    shm_ring *r = &s->slot->resp;
+    uint32_t head = r->head.load(std::memory_order_relaxed);
+    uint32_t tail = r->tail.load(std::memory_order_acquire);
+
+    size_t fill = tail - head;
+    size_t n = frames < fill ? frames : fill;
+    if (n == 0)
+        return 0;
+
+    for (size_t i = 0; i < n; i++)
+        take(&r->rec[(head + i) & RING_MASK], i);
+
+    /* A worker stalled on a full response ring may be asleep */
+    r->head.store(head + static_cast<uint32_t>(n));
+    shm_futex_notify(&s->worker->doorbell, &s->worker->sleeping);
+    return n;
+}
+
+size_t opendmr_shm_push_ambe(opendmr_shm_stream_t *s, const uint8_t *ambe, size_t frames)
+{
+    if (!s || !ambe || s->mode != OPENDMR_SHM_DECODE)
+        return 0;
+
+    return push_frames(s, frames, [ambe](shm_record *rec, size_t i) {
+        memcpy(rec->ambe, ambe + i * OPENDMR_AMBE_FRAME_BYTES, OPENDMR_AMBE_FRAME_BYTES);
+    });
+}
+
+size_t opendmr_shm_push_pcm(opendmr_shm_stream_t *s, const int16_t *pcm, size_t frames)
+{
+    if (!s || !pcm || s->mode != OPENDMR_SHM_ENCODE)
+        return 0;
+
+    return push_frames(s, frames, [pcm](shm_record *rec, size_t i) {
+        memcpy(rec->pcm, pcm + i * OPENDMR_PCM_SAMPLES, sizeof(rec->pcm));
+    });
+}
+
+size_t opendmr_shm_pull_pcm(opendmr_shm_stream_t *s, int16_t *pcm, size_t frames, int *errs)
+{
+    if (!s || !pcm || s->mode != OPENDMR_SHM_DECODE)
+        return 0;
+
+    return pull_frames(s, frames, [pcm, errs](const shm_record *rec, size_t i) {
+        memcpy(pcm + i * OPENDMR_PCM_SAMPLES, rec->pcm, sizeof(rec->pcm));
+        if (errs)
+            errs[i] = static_cast<int>(rec->errs);
+    });
+}
+
+size_t opendmr_shm_pull_ambe(opendmr_shm_stream_t *s, uint8_t *ambe, size_t frames)
+{
+    if (!s || !ambe || s->mode != OPENDMR_SHM_ENCODE)
+        return 0;
+
+    return pull_frames(s, frames, [ambe](const shm_record *rec, size_t i) {
+        memcpy(ambe + i * OPENDMR_AMBE_FRAME_BYTES, rec->ambe, OPENDMR_AMBE_FRAME_BYTES);
+    });
+}
+
+size_t opendmr_shm_available(const opendmr_shm_stream_t *s)
+{
+    if (!s)
+        return 0;
+
+    const shm_ring *r = &s->slot->resp;
+    return r->tail.load(std::memory_order_acquire) - r->head.load(std::memory_order_relaxed);
+}
+
+static long elapsed_ms(const timespec &start)
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start.tv_sec) * 1000L + (now.tv_nsec - start.tv_nsec) / 1000000L;
+}
+
+bool opendmr_shm_wait(opendmr_shm_stream_t *s, int timeout_ms)
+{
+    if (!s)
+        return false;
+    if (opendmr_shm_available(s))
+        return true;
+
+    timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    shm_slot *slot = s->slot;
+    for (;;) {
+        uint32_t v = slot->resp_futex.load();
+        slot->resp_sleeping.store(1);
+        if (opendmr_shm_available(s))
+            break;
+
+        int left = -1;
+        if (timeout_ms >= 0) {
+            left = timeout_ms - static_cast<int>(elapsed_ms(start));
+            if (left <= 0)
+                break;
+        }
+        shm_futex_wait(&slot->resp_futex, v, left);
+    }
+    slot->resp_sleeping.store(0);
+    return opendmr_shm_available(s) > 0;
+}
@@ -0,0 +1,141 @@
+/*
+ * OpenDMR - Open Source DMR (AMBE+2) Vocoder Library
+ *
+ * Client library for opendmr-shmd, the shared-memory transcoding service.
+ *
+ * Co-located processes open streams on the service instead of running
+ * their own codec instances. Frames travel through per-stream
+ * single-producer/single-consumer rings in a shared memory segment; the
+ * service's pinned workers run the codecs. Pushing and pulling frames
+ * make no system calls unless the service worker is asleep (one futex
+ * wake) or the client chooses to block in opendmr_shm_wait().
+ *
+ * A stream is not thread-safe; use one stream per producing thread.
+ */
+
+#ifndef OPENDMR_SHM_H
+#define OPENDMR_SHM_H
+
+#include "opendmr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Default segment name used by opendmr-shmd */
+#define OPENDMR_SHM_DEFAULT_NAME    "/opendmr-shm"
+
+/* Frames each stream can have queued in one direction */
+#define OPENDMR_SHM_RING_FRAMES     32
+
+typedef enum {
+    OPENDMR_SHM_DECODE = 1,     /* AMBE+2 in, PCM out */
+    OPENDMR_SHM_ENCODE = 2      /* PCM in, AMBE+2 out */
+} opendmr_shm_mode_t;
+
+typedef struct opendmr_shm opendmr_shm_t;
+typedef struct opendmr_shm_stream opendmr_shm_stream_t;
+
+/**
+ * Attach to a running service.
+ *
+ * @param name  Segment name (NULL for OPENDMR_SHM_DEFAULT_NAME).
+ *
+ * @return Connection, or NULL if the service is not running.
+ */
+opendmr_shm_t *opendmr_shm_attach(const char *name);
+
+/**
+ * Detach from the service. Streams still open are closed.
+ *
+ * @param shm Connection (may be NULL).
+ */
+void opendmr_shm_detach(opendmr_shm_t *shm);
+
+/**
+ * Open a stream with fresh codec state.
+ *
+ * @param shm   Connection.
+ * @param mode  Direction.
+ *
+ * @return Stream, or NULL if every service slot is in use.
+ */
+opendmr_shm_stream_t *opendmr_shm_stream_open(opendmr_shm_t *shm, opendmr_shm_mode_t mode);
+
+/**
+ * Close a stream and release its service slot.
+ *
+ * @param s Stream (may be NULL).
+ */
+void opendmr_shm_stream_close(opendmr_shm_stream_t *s);
+
+/**
+ * Queue AMBE+2 frames on a decode stream.
+ *
+ * @param s         Decode stream.
+ * @param ambe      Frames, 9 bytes each.
+ * @param frames    Number of frames.
+ *
+ * @return Frames queued; fewer than requested when the ring is full.
+ *
+ * The whole batch is published with a single store and at most one
+ * wakeup.
+ */
+size_t opendmr_shm_push_ambe(opendmr_shm_stream_t *s, const uint8_t *ambe, size_t frames);
+
+/**
+ * Queue PCM frames on an encode stream.
+ *
+ * @param s         Encode stream.
+ * @param pcm       Audio, 160 samples per frame.
+ * @param frames    Number of frames.
+ *
+ * @return Frames queued; fewer than requested when the ring is full.
+ */
+size_t opendmr_shm_push_pcm(opendmr_shm_stream_t *s, const int16_t *pcm, size_t frames);
+
+/**
+ * Collect decoded PCM frames.
+ *
+ * @param s         Decode stream.
+ * @param pcm       Output, 160 samples per frame.
+ * @param frames    Maximum frames to collect.
+ * @param errs      Optional: corrected bit errors per frame (may be NULL).
+ *
+ * @return Frames collected (0 if none are ready).
+ */
+size_t opendmr_shm_pull_pcm(opendmr_shm_stream_t *s, int16_t *pcm, size_t frames, int *errs);
+
+/**
+ * Collect encoded AMBE+2 frames.
+ *
+ * @param s         Encode stream.
+ * @param ambe      Output, 9 bytes per frame.
+ * @param frames    Maximum frames to collect.
+ *
+ * @return Frames collected (0 if none are ready).
+ */
+size_t opendmr_shm_pull_ambe(opendmr_shm_stream_t *s, uint8_t *ambe, size_t frames);
+
+/**
+ * Number of results ready to pull.
+ *
+ * @param s Stream.
+ */
+size_t opendmr_shm_available(const opendmr_shm_stream_t *s);
+
+/**
+ * Block until a result is ready.
+ *
+ * @param s             Stream.
+ * @param timeout_ms    Maximum wait (-1 waits forever).
+ *
+ * @return true if at least one result is ready.
+ */
+bool opendmr_shm_wait(opendmr_shm_stream_t *s, int timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OPENDMR_SHM_H */
@@ -0,0 +1,359 @@
+/*
+ * opendmr-shmd - Shared-memory transcoding service
+ *
+ * Creates a shared memory segment of stream slots (see shm_layout.h) and
+ * runs the codecs for every client stream on a set of pinned worker
+ * threads. Each slot belongs to one worker for its whole life, so codec
+ * state is never shared between threads. A worker sweeps all of its open
+ * streams per pass, handling a batch of frames from each, then spins
+ * briefly and finally sleeps on its futex doorbell until a client
+ * publishes more work.
+ *
+ * Slots of clients that exit without closing their streams are reclaimed.
+ *
+ * Usage:
+ *   opendmr-shmd [-n slots] [-t workers] [-s name] [-P]
+ */
+
+#include "opendmr.h"
+#include "opendmr_shm.h"
+#include "shm_layout.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <thread>
+#include <vector>
+
+#define DEFAULT_SLOTS       64
+#define MAX_SLOTS           4096
+
+/* Frames taken from one stream per pass, so busy streams cannot starve others */
+#define BATCH_FRAMES        8
+
+/* Empty passes (each followed by a yield) before a worker sleeps */
+#define SPIN_PASSES         200
+
+/* Longest futex sleep, bounding how late dead clients are noticed */
+#define SLEEP_MS            1000
+
+/* Interval between checks for clients that exited with open streams */
+#define REAP_INTERVAL_MS    1000
+
+#define RING_MASK           (SHM_RING_FRAMES - 1)
+
+/* Worker-private state for one slot */
+struct slot_codec {
+    uint32_t index;
+    uint32_t generation;
+    opendmr_decoder_t *dec;
+    opendmr_encoder_t *enc;
+};
+
+struct worker_ctx {
+    uint32_t id;
+    int cpu;                    /* -1: not pinned */
+    shm_header *hdr;
+    std::vector<slot_codec> slots;
+    unsigned long frames;
+    unsigned long passes;
+    unsigned long sleeps;
+    unsigned long reaped;
+};
+
+static volatile sig_atomic_t g_running = 1;
+
+static void on_signal(int)
+{
+    g_running = 0;
+}
+
+static void print_usage(const char *prog)
+{
+    printf("OpenDMR shared-memory transcoding service v%s\n", opendmr_version());
+    printf("\n");
+    printf("Usage: %s [options]\n", prog);
+    printf("  -n slots        Stream slots (default %d, max %d)\n", DEFAULT_SLOTS, MAX_SLOTS);
+    printf("  -t workers      Worker threads (default: CPU count, max %d)\n", SHM_MAX_WORKERS);
+    printf("  -s name         Segment name (default %s)\n", OPENDMR_SHM_DEFAULT_NAME);
+    printf("  -P              Do not pin workers to CPUs\n");
+    printf("\n");
+}
+
+static long now_ms(void)
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000L + ts.tv_nsec / 1000000L;
+}
+
+/* Process up to BATCH_FRAMES requests; returns the number handled */
+static size_t service_slot(shm_slot *slot, slot_codec *sc)
+{
+    shm_ring *req = &slot->req;
+    shm_ring *resp = &slot->resp;
+
+    uint32_t rq_head = req->head.load(std::memory_order_relaxed);
+    uint32_t rq_tail = req->tail.load(std::memory_order_acquire);
+    uint32_t rs_tail = resp->tail.load(std::memory_order_relaxed);
+    uint32_t rs_head = resp->head.load(std::memory_order_acquire);
+
+    size_t n = rq_tail - rq_head;
+    size_t space = SHM_RING_FRAMES - (rs_tail - rs_head);
+    if (n > space)
+        n = space;
+    if (n > BATCH_FRAMES)
+        n = BATCH_FRAMES;
+    if (n == 0)
+        return 0;
+
+    for (size_t i = 0; i < n; i++) {
+        const shm_record *in = &req->rec[(rq_head + i) & RING_MASK];
+        shm_record *out = &resp->rec[(rs_tail + i) & RING_MASK];
+        out->seq = in->seq;
+        if (slot->mode == OPENDMR_SHM_DECODE) {
+            int errs = 0;
+            opendmr_decode(sc->dec, in->ambe, out->pcm, &errs);
+            out->errs = static_cast<uint32_t>(errs);
+        } else {
+            opendmr_encode(sc->enc, in->pcm, out->ambe);
+            out->errs = 0;
+        }
+    }
+
+    resp->tail.store(rs_tail + static_cast<uint32_t>(n));
+    req->head.store(rq_head + static_cast<uint32_t>(n), std::memory_order_release);
+    shm_futex_notify(&slot->resp_futex, &slot->resp_sleeping);
+    return n;
+}
+
+/* True if any owned slot has something the worker could do right now */
+static bool has_work(const worker_ctx *w)
+{
+    for (const slot_codec &sc : w->slots) {
+        const shm_slot *slot = &w->hdr->slots[sc.index];
+        uint32_t state = slot->state.load();
+        if (state == SHM_SLOT_CLOSING)
+            return true;
+        if (state != SHM_SLOT_OPEN)
+            continue;
+        uint32_t pending = slot->req.tail.load() - slot->req.head.load();
+        uint32_t queued = slot->resp.tail.load() - slot->resp.head.load();
+        if (pending && queued < SHM_RING_FRAMES)
+            return true;
+    }
+    return false;
+}
+
+static void reap_dead_clients(worker_ctx *w)
+{
+    for (slot_codec &sc : w->slots) {
+        shm_slot *slot = &w->hdr->slots[sc.index];
+        if (slot->state.load(std::memory_order_acquire) != SHM_SLOT_OPEN)
+            continue;
+        if (kill(slot->owner, 0) < 0 && errno == ESRCH) {
+            slot->state.store(SHM_SLOT_FREE);
+            w->reaped++;
+        }
+    }
+}
+
+static void worker_main(worker_ctx *w)
+{
+    if (w->cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(w->cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+
+    shm_worker *bell = &w->hdr->workers[w->id];
+    long next_reap = now_ms() + REAP_INTERVAL_MS;
+    int idle = 0;
+
+    while (g_running) {
+        size_t done = 0;
+        for (slot_codec &sc : w->slots) {
+            shm_slot *slot = &w->hdr->slots[sc.index];
+            uint32_t state = slot->state.load(std::memory_order_acquire);
+
+            if (state == SHM_SLOT_CLOSING) {
+                slot->state.store(SHM_SLOT_FREE);
+                continue;
+            }
+            if (state != SHM_SLOT_OPEN)
+                continue;
+
+            /* A new owner: start from fresh codec state */
+            uint32_t gen = slot->generation.load(std::memory_order_relaxed);
+            if (gen != sc.generation) {
+                opendmr_decoder_reset(sc.dec);
+                opendmr_encoder_reset(sc.enc);
+                sc.generation = gen;
+            }
+            done += service_slot(slot, &sc);
+        }
+        w->frames += done;
+        w->passes++;
+
+        if (done) {
+            idle = 0;
+            continue;
+        }
+
+        long now = now_ms();
+        if (now >= next_reap) {
+            reap_dead_clients(w);
+            next_reap = now + REAP_INTERVAL_MS;
+        }
+
+        if (++idle < SPIN_PASSES) {
+            sched_yield();
+            continue;
+        }
+
+        /* Announce the sleep, then re-check so no publish is missed */
+        uint32_t v = bell->doorbell.load();
+        bell->sleeping.store(1);
+        if (!has_work(w) && g_running) {
+            shm_futex_wait(&bell->doorbell, v, SLEEP_MS);
+            w->sleeps++;
+        }
+        bell->sleeping.store(0);
+        idle = 0;
+    }
+    opendmr_thread_release();
+}
+
+int main(int argc, char **argv)
+{
+    int num_slots = DEFAULT_SLOTS;
+    int ncpu = static_cast<int>(std::thread::hardware_concurrency());
+    int num_workers = ncpu;
+    const char *name = OPENDMR_SHM_DEFAULT_NAME;
+    bool pin = true;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:t:s:Ph")) != -1) {
+        switch (opt) {
+        case 'n': num_slots = atoi(optarg); break;
+        case 't': num_workers = atoi(optarg); break;
+        case 's': name = optarg; break;
+        case 'P': pin = false; break;
+        default:
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (num_slots < 1 || num_slots > MAX_SLOTS) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (num_workers < 1)
+        num_workers = 1;
+    if (num_workers > SHM_MAX_WORKERS)
+        num_workers = SHM_MAX_WORKERS;
+    if (num_workers > num_slots)
+        num_workers = num_slots;
+    if (ncpu < 1)
+        ncpu = 1;
+
+    /* Replace any segment left behind by a previous instance */
+    shm_unlink(name);
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0660);
+    if (fd < 0) {
+        fprintf(stderr, "Error: Cannot create segment '%s': %s\n", name, strerror(errno));
+        return 1;
+    }
+    size_t size = shm_segment_size(static_cast<uint32_t>(num_slots));
+    if (ftruncate(fd, static_cast<off_t>(size)) < 0) {
+        fprintf(stderr, "Error: Cannot size segment: %s\n", strerror(errno));
+        close(fd);
+        shm_unlink(name);
+        return 1;
+    }
+    void *mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) {
+        fprintf(stderr, "Error: Cannot map segment: %s\n", strerror(errno));
+        shm_unlink(name);
+        return 1;
+    }
+
+    /* The segment is zero-filled: every slot is free and every ring empty */
+    shm_header *hdr = static_cast<shm_header *>(mem);
+    hdr->version = SHM_VERSION;
+    hdr->num_slots = static_cast<uint32_t>(num_slots);
+    hdr->num_workers = static_cast<uint32_t>(num_workers);
+    hdr->service = getpid();
+
+    std::vector<worker_ctx> ctx(static_cast<size_t>(num_workers));
+    for (int i = 0; i < num_workers; i++) {
+        worker_ctx *w = &ctx[static_cast<size_t>(i)];
+        w->id = static_cast<uint32_t>(i);
+        w->cpu = pin ? i % ncpu : -1;
+        w->hdr = hdr;
+        w->frames = w->passes = w->sleeps = w->reaped = 0;
+    }
+    for (uint32_t s = 0; s < static_cast<uint32_t>(num_slots); s++) {
+        slot_codec sc;
+        sc.index = s;
+        sc.generation = 0;
+        sc.dec = opendmr_decoder_create();
+        sc.enc = opendmr_encoder_create();
+        if (!sc.dec || !sc.enc) {
+            fprintf(stderr, "Error: Cannot create codec for slot %u\n", s);
+            shm_unlink(name);
+            return 1;
+        }
+        ctx[shm_slot_worker(hdr, s)].slots.push_back(sc);
+    }
+
+    /* Publish: clients check the magic before touching anything else */
+    __atomic_store_n(&hdr->magic, SHM_MAGIC, __ATOMIC_RELEASE);
+
+    printf("Segment %s: %d slot(s), %d worker(s)%s\n", name, num_slots, num_workers,
+           pin ? ", pinned" : "");
+    fflush(stdout);
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    std::vector<std::thread> threads;
+    for (auto &w : ctx)
+        threads.push_back(std::thread(worker_main, &w));
+
+    while (g_running)
+        pause();
+
+    /* Stop accepting streams, then wake every sleeping worker */
+    shm_unlink(name);
+    for (int i = 0; i < num_workers; i++) {
+        hdr->workers[i].doorbell.fetch_add(1);
+        shm_futex_notify(&hdr->workers[i].doorbell, &hdr->workers[i].sleeping);
+    }
+    for (auto &t : threads)
+        t.join();
+
+    printf("\n%-8s %6s %12s %12s %10s %8s\n",
+           "worker", "cpu", "frames", "passes", "sleeps", "reaped");
+    for (auto &w : ctx) {
+        printf("%-8u %6d %12lu %12lu %10lu %8lu\n", w.id, w.cpu, w.frames,
+               w.passes, w.sleeps, w.reaped);
+        for (slot_codec &sc : w.slots) {
+            opendmr_decoder_destroy(sc.dec);
+            opendmr_encoder_destroy(sc.enc);
+        }
+    }
+    munmap(mem, size);
+    return 0;
+}
@@ -0,0 +1,415 @@
+/*
+ * opendmr-udpgw - UDP transcoding gateway
+ *
+ * Receives AMBE+2 or PCM datagrams tagged with a stream ID (udpgw_proto.h),
+ * decodes, encodes or regenerates them and sends the result back to the
+ * sender.
+ *
+ * One socket per worker thread is bound to the same port with
+ * SO_REUSEPORT. A classic BPF program on the reuseport group picks the
+ * socket from the stream ID in the payload (stream % workers), so every
+ * datagram of a stream reaches the same worker no matter which source
+ * port it came from. Each worker is pinned to a CPU and owns the codec
+ * state of its streams outright: streams never cross threads and no
+ * locks are taken. If the kernel refuses the steering program, the
+ * default 4-tuple hash still keeps each client address on one worker.
+ *
+ * I/O is batched with recvmmsg()/sendmmsg(): a worker drains up to
+ * BATCH datagrams per call, processes them in arrival order and answers
+ * them with a single send call.
+ *
+ * Usage:
+ *   opendmr-udpgw [-a address] [-p port] [-t workers] [-i idle_seconds] [-P]
+ */
+
+#include "opendmr.h"
+#include "udpgw_proto.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <linux/filter.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifndef SO_ATTACH_REUSEPORT_CBPF
+#define SO_ATTACH_REUSEPORT_CBPF 51
+#endif
+
+/* Datagrams per recvmmsg()/sendmmsg() call */
+#define BATCH                   32
+
+#define MAX_WORKERS             256
+#define DEFAULT_IDLE_SECONDS    30
+
+/* Receive timeout, bounding shutdown and idle-stream sweep latency */
+#define RECV_TIMEOUT_MS         250
+
+#define MAX_DATAGRAM            UDPGW_PCM_DATAGRAM
+
+struct gw_stream {
+    opendmr_decoder_t *dec;
+    opendmr_encoder_t *enc;
+    time_t last_used;
+};
+
+struct gw_worker {
+    int id;
+    int cpu;                    /* -1: not pinned */
+    int fd;
+    std::unordered_map<uint32_t, gw_stream> streams;
+
+    unsigned long packets;
+    unsigned long batches;
+    unsigned long errors;
+    unsigned long foreign;      /* Streams steered by hash, not stream ID */
+    unsigned long expired;
+};
+
+static volatile sig_atomic_t g_running = 1;
+static int g_num_workers;
+static int g_idle_seconds = DEFAULT_IDLE_SECONDS;
+
+static void on_signal(int)
+{
+    g_running = 0;
+}
+
+static void print_usage(const char *prog)
+{
+    printf("OpenDMR UDP transcoding gateway v%s\n", opendmr_version());
+    printf("\n");
+    printf("Usage: %s [options]\n", prog);
+    printf("  -a address      Bind address (default 127.0.0.1)\n");
+    printf("  -p port         UDP port (default %d)\n", UDPGW_DEFAULT_PORT);
+    printf("  -t workers      Worker threads (default: CPU count)\n");
+    printf("  -i seconds      Release streams idle this long (default %d)\n",
+           DEFAULT_IDLE_SECONDS);
+    printf("  -P              Do not pin workers to CPUs\n");
+    printf("\n");
+}
+
+/*
+ * ============================================================================
+ * Sockets
+ * ============================================================================
+ */
+
+/* Socket index = stream ID % workers, read from the UDP payload */
+static bool attach_steering(int fd, int workers)
+{
+    sock_filter code[] = {
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, UDPGW_STREAM_OFFSET),
+        BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, static_cast<uint32_t>(workers)),
+        BPF_STMT(BPF_RET | BPF_A, 0),
+    };
+    sock_fprog prog;
+    prog.len = sizeof(code) / sizeof(code[0]);
+    prog.filter = code;
+    return setsockopt(fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) == 0;
+}
+
+static int open_socket(const char *addr, int port)
+{
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+
+    int buf = 4 << 20;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &buf, sizeof(buf));
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &buf, sizeof(buf));
+
+    timeval tv;
+    tv.tv_sec = 0;
+    tv.tv_usec = RECV_TIMEOUT_MS * 1000;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    sockaddr_in sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, addr, &sa.sin_addr) != 1) {
+        fprintf(stderr, "Error: Invalid address '%s'\n", addr);
+        close(fd);
+        return -1;
+    }
+    if (bind(fd, reinterpret_cast<sockaddr *>(&sa), sizeof(sa)) < 0) {
+        fprintf(stderr, "Error: Cannot bind %s:%d: %s\n", addr, port, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/*
+ * ============================================================================
+ * Workers
+ * ============================================================================
+ */
+
+static void release_stream(gw_stream *st)
+{
+    opendmr_decoder_destroy(st->dec);
+    opendmr_encoder_destroy(st->enc);
+}
+
+static gw_stream *find_stream(gw_worker *w, uint32_t id, time_t now)
+{
+    auto it = w->streams.find(id);
+    if (it == w->streams.end()) {
+        gw_stream st;
+        st.dec = nullptr;
+        st.enc = nullptr;
+        it = w->streams.emplace(id, st).first;
+        if (static_cast<int>(id % static_cast<uint32_t>(g_num_workers)) != w->id)
+            w->foreign++;
+    }
+    it->second.last_used = now;
+    return &it->second;
+}
+
+static void expire_streams(gw_worker *w, time_t now)
+{
+    for (auto it = w->streams.begin(); it != w->streams.end();) {
+        if (now - it->second.last_used > g_idle_seconds) {
+            release_stream(&it->second);
+            it = w->streams.erase(it);
+            w->expired++;
+        } else {
+            ++it;
+        }
+    }
+}
+
+/* Build the response for one request in place; returns its length or 0 */
+static size_t handle(gw_worker *w, uint8_t *pkt, size_t len, time_t now)
+{
+    if (len < UDPGW_HEADER_LEN || pkt[0] != UDPGW_VERSION)
+        return 0;
+
+    uint8_t op = pkt[1];
+    uint32_t id = udpgw_get32(pkt + UDPGW_STREAM_OFFSET);
+    uint32_t seq = udpgw_get32(pkt + 8);
+    uint8_t *payload = pkt + UDPGW_HEADER_LEN;
+    uint8_t status = 0;
+    bool ok = false;
+    size_t out_len = UDPGW_HEADER_LEN;
+
+    switch (op) {
+    case UDPGW_OP_DECODE: {
+        if (len != UDPGW_AMBE_DATAGRAM)
+            break;
+        gw_stream *st = find_stream(w, id, now);
+        if (!st->dec && !(st->dec = opendmr_decoder_create()))
+            break;
+
+        uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES];
+        memcpy(ambe, payload, sizeof(ambe));
+        int16_t pcm[OPENDMR_PCM_SAMPLES];
+        int errs = 0;
+        opendmr_decode(st->dec, ambe, pcm, &errs);
+        for (int i = 0; i < OPENDMR_PCM_SAMPLES; i++) {
+            payload[2 * i] = static_cast<uint8_t>(pcm[i]);
+            payload[2 * i + 1] = static_cast<uint8_t>(pcm[i] >> 8);
+        }
+        status = static_cast<uint8_t>(errs);
+        out_len = UDPGW_PCM_DATAGRAM;
+        ok = true;
+        break;
+    }
+
+    case UDPGW_OP_ENCODE: {
+        if (len != UDPGW_PCM_DATAGRAM)
+            break;
+        gw_stream *st = find_stream(w, id, now);
+        if (!st->enc && !(st->enc = opendmr_encoder_create()))
+            break;
+
+        int16_t pcm[OPENDMR_PCM_SAMPLES];
+        for (int i = 0; i < OPENDMR_PCM_SAMPLES; i++)
+            pcm[i] = static_cast<int16_t>(payload[2 * i] | payload[2 * i + 1] << 8);
+        opendmr_encode(st->enc, pcm, payload);
+        out_len = UDPGW_AMBE_DATAGRAM;
+        ok = true;
+        break;
+    }
+
+    case UDPGW_OP_REGENERATE: {
+        if (len != UDPGW_AMBE_DATAGRAM)
+            break;
+        /* Uncorrectable frames are still returned, flagged with an error status */
+        int errs = 0;
+        opendmr_regenerate(payload, payload, &errs);
+        status = errs < 0 ? UDPGW_STATUS_ERROR : static_cast<uint8_t>(errs);
+        out_len = UDPGW_AMBE_DATAGRAM;
+        ok = true;
+        break;
+    }
+
+    case UDPGW_OP_CLOSE: {
+        auto it = w->streams.find(id);
+        if (it != w->streams.end()) {
+            release_stream(&it->second);
+            w->streams.erase(it);
+        }
+        ok = true;
+        break;
+    }
+
+    default:
+        break;
+    }
+
+    if (!ok) {
+        w->errors++;
+        status = UDPGW_STATUS_ERROR;
+        out_len = UDPGW_HEADER_LEN;
+    }
+    udpgw_header(pkt, static_cast<uint8_t>(op | UDPGW_OP_RESPONSE), status, id, seq);
+    return out_len;
+}
+
+static void worker_main(gw_worker *w)
+{
+    if (w->cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(w->cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+
+    static_assert(MAX_DATAGRAM <= 512, "datagram buffers sized for PCM frames");
+    uint8_t bufs[BATCH][512];
+    sockaddr_in addrs[BATCH];
+    iovec iov[BATCH];
+    mmsghdr msgs[BATCH];
+    mmsghdr out[BATCH];
+    time_t next_sweep = time(nullptr) + 1;
+
+    while (g_running) {
+        for (int i = 0; i < BATCH; i++) {
+            iov[i].iov_base = bufs[i];
+            iov[i].iov_len = sizeof(bufs[i]);
+            memset(&msgs[i].msg_hdr, 0, sizeof(msgs[i].msg_hdr));
+            msgs[i].msg_hdr.msg_name = &addrs[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int n = recvmmsg(w->fd, msgs, BATCH, MSG_WAITFORONE, nullptr);
+        time_t now = time(nullptr);
+
+        if (n > 0) {
+            int m = 0;
+            for (int i = 0; i < n; i++) {
+                size_t len = handle(w, bufs[i], msgs[i].msg_len, now);
+                if (len == 0)
+                    continue;
+                iov[i].iov_len = len;
+                out[m].msg_hdr = msgs[i].msg_hdr;
+                out[m].msg_hdr.msg_iov = &iov[i];
+                m++;
+            }
+            for (int sent = 0; sent < m;) {
+                int r = sendmmsg(w->fd, out + sent, static_cast<unsigned int>(m - sent), 0);
+                if (r <= 0)
+                    break;
+                sent += r;
+            }
+            w->packets += static_cast<unsigned long>(n);
+            w->batches++;
+        }
+
+        if (now >= next_sweep) {
+            expire_streams(w, now);
+            next_sweep = now + 1;
+        }
+    }
+
+    for (auto &kv : w->streams)
+        release_stream(&kv.second);
+    opendmr_thread_release();
+}
+
+int main(int argc, char **argv)
+{
+    const char *addr = "127.0.0.1";
+    int port = UDPGW_DEFAULT_PORT;
+    int ncpu = static_cast<int>(std::thread::hardware_concurrency());
+    int num_workers = ncpu;
+    bool pin = true;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "a:p:t:i:Ph")) != -1) {
+        switch (opt) {
+        case 'a': addr = optarg; break;
+        case 'p': port = atoi(optarg); break;
+        case 't': num_workers = atoi(optarg); break;
+        case 'i': g_idle_seconds = atoi(optarg); break;
+        case 'P': pin = false; break;
+        default:
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (num_workers < 1)
+        num_workers = 1;
+    if (num_workers > MAX_WORKERS)
+        num_workers = MAX_WORKERS;
+    if (ncpu < 1)
+        ncpu = 1;
+    g_num_workers = num_workers;
+
+    /* Bind in order: worker k's socket is index k in the reuseport group */
+    std::vector<gw_worker> workers(static_cast<size_t>(num_workers));
+    for (int i = 0; i < num_workers; i++) {
+        gw_worker *w = &workers[static_cast<size_t>(i)];
+        w->id = i;
+        w->cpu = pin ? i % ncpu : -1;
+        w->packets = w->batches = w->errors = w->foreign = w->expired = 0;
+        w->fd = open_socket(addr, port);
+        if (w->fd < 0)
+            return 1;
+    }
+    bool steered = attach_steering(workers[0].fd, num_workers);
+
+    printf("Listening on %s:%d, %d worker(s)%s, %s\n", addr, port, num_workers,
+           pin ? " pinned" : "", steered ? "steered by stream ID" : "hash steering");
+    fflush(stdout);
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    std::vector<std::thread> threads;
+    for (auto &w : workers)
+        threads.push_back(std::thread(worker_main, &w));
+    for (auto &t : threads)
+        t.join();
+
+    printf("\n%-8s %6s %12s %10s %8s %8s %8s %8s\n", "worker", "cpu", "packets",
+           "batches", "avg", "errors", "foreign", "expired");
+    for (auto &w : workers) {
+        printf("%-8d %6d %12lu %10lu %8.1f %8lu %8lu %8lu\n", w.id, w.cpu, w.packets,
+               w.batches, w.batches ? static_cast<double>(w.packets) / w.batches : 0.0,
+               w.errors, w.foreign, w.expired);
+        close(w.fd);
+    }
+    return 0;
+}
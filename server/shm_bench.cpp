@@ -0,0 +1,185 @@
+/*
+ * shm_bench - Load generator for opendmr-shmd
+ *
+ * Opens a number of streams on the service from one thread, keeps a
+ * window of frames in flight on each, and reports frames per second and
+ * per-frame latency (push to pull). By default the client spins on its
+ * rings like a hot-path caller would; -b blocks in opendmr_shm_wait()
+ * instead, exercising the futex wakeups.
+ *
+ * Usage:
+ *   shm_bench [-e] [-b] [-s streams] [-n frames] [-w window] [-m name]
+ */
+
+#include "opendmr.h"
+#include "opendmr_shm.h"
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#define DEFAULT_STREAMS     8
+#define DEFAULT_FRAMES      2000
+#define DEFAULT_WINDOW      4
+
+struct bench_stream {
+    opendmr_shm_stream_t *s;
+    long sent;
+    long received;
+    double sent_at[OPENDMR_SHM_RING_FRAMES];
+};
+
+static double now_us(void)
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void print_usage(const char *prog)
+{
+    printf("OpenDMR shared-memory service load generator v%s\n", opendmr_version());
+    printf("\n");
+    printf("Usage: %s [options]\n", prog);
+    printf("  -e              Encode streams (default: decode)\n");
+    printf("  -b              Block in opendmr_shm_wait() instead of spinning\n");
+    printf("  -s streams      Concurrent streams (default %d)\n", DEFAULT_STREAMS);
+    printf("  -n frames       Frames per stream (default %d)\n", DEFAULT_FRAMES);
+    printf("  -w window       Frames in flight per stream (default %d, max %d)\n",
+           DEFAULT_WINDOW, OPENDMR_SHM_RING_FRAMES);
+    printf("  -m name         Segment name (default %s)\n", OPENDMR_SHM_DEFAULT_NAME);
+    printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+    bool encode = false;
+    bool block = false;
+    int num_streams = DEFAULT_STREAMS;
+    long frames = DEFAULT_FRAMES;
+    int window = DEFAULT_WINDOW;
+    const char *name = nullptr;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "ebs:n:w:m:h")) != -1) {
+        switch (opt) {
+        case 'e': encode = true; break;
+        case 'b': block = true; break;
+        case 's': num_streams = atoi(optarg); break;
+        case 'n': frames = atol(optarg); break;
+        case 'w': window = atoi(optarg); break;
+        case 'm': name = optarg; break;
+        default:
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (num_streams < 1 || frames < 1 || window < 1 || window > OPENDMR_SHM_RING_FRAMES) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    opendmr_shm_t *shm = opendmr_shm_attach(name);
+    if (!shm) {
+        fprintf(stderr, "Error: Service not running\n");
+        return 1;
+    }
+
+    /* One second of test signal, and its AMBE+2 encoding for decode runs */
+    const size_t test_frames = 50;
+    std::vector<int16_t> pcm(test_frames * OPENDMR_PCM_SAMPLES);
+    for (size_t i = 0; i < pcm.size(); i++) {
+        double t = i / 8000.0;
+        double f0 = 120.0 + 40.0 * sin(2.0 * M_PI * 0.5 * t);
+        pcm[i] = static_cast<int16_t>(8000.0 * sin(2.0 * M_PI * f0 * t));
+    }
+    std::vector<uint8_t> ambe(test_frames * OPENDMR_AMBE_FRAME_BYTES);
+    opendmr_encoder_t *enc = opendmr_encoder_create();
+    for (size_t f = 0; f < test_frames; f++)
+        opendmr_encode(enc, &pcm[f * OPENDMR_PCM_SAMPLES], &ambe[f * OPENDMR_AMBE_FRAME_BYTES]);
+    opendmr_encoder_destroy(enc);
+
+    std::vector<bench_stream> streams(static_cast<size_t>(num_streams));
+    for (auto &bs : streams) {
+        bs.s = opendmr_shm_stream_open(shm, encode ? OPENDMR_SHM_ENCODE : OPENDMR_SHM_DECODE);
+        if (!bs.s) {
+            fprintf(stderr, "Error: No free stream slots\n");
+            return 1;
+        }
+        bs.sent = bs.received = 0;
+    }
+
+    std::vector<double> lat;
+    lat.reserve(static_cast<size_t>(frames * num_streams));
+    int16_t out_pcm[OPENDMR_SHM_RING_FRAMES * OPENDMR_PCM_SAMPLES];
+    uint8_t out_ambe[OPENDMR_SHM_RING_FRAMES * OPENDMR_AMBE_FRAME_BYTES];
+    long remaining = frames * num_streams;
+
+    double start = now_us();
+    while (remaining > 0) {
+        bool progress = false;
+        bench_stream *oldest = nullptr;
+
+        for (auto &bs : streams) {
+            /* Top up the window with one batch */
+            long want = std::min<long>(window - (bs.sent - bs.received), frames - bs.sent);
+            if (want > 0) {
+                size_t f = static_cast<size_t>(bs.sent) % test_frames;
+                size_t n = std::min<size_t>(static_cast<size_t>(want), test_frames - f);
+                double t = now_us();
+                n = encode ? opendmr_shm_push_pcm(bs.s, &pcm[f * OPENDMR_PCM_SAMPLES], n)
+                           : opendmr_shm_push_ambe(bs.s, &ambe[f * OPENDMR_AMBE_FRAME_BYTES], n);
+                for (size_t i = 0; i < n; i++)
+                    bs.sent_at[(bs.sent + i) % OPENDMR_SHM_RING_FRAMES] = t;
+                bs.sent += n;
+                progress |= n > 0;
+            }
+
+            size_t got = encode ? opendmr_shm_pull_ambe(bs.s, out_ambe, OPENDMR_SHM_RING_FRAMES)
+                                : opendmr_shm_pull_pcm(bs.s, out_pcm, OPENDMR_SHM_RING_FRAMES, nullptr);
+            if (got) {
+                double t = now_us();
+                for (size_t i = 0; i < got; i++)
+                    lat.push_back(t - bs.sent_at[(bs.received + i) % OPENDMR_SHM_RING_FRAMES]);
+                bs.received += got;
+                remaining -= static_cast<long>(got);
+                progress = true;
+            }
+            if (bs.received < bs.sent && !oldest)
+                oldest = &bs;
+        }
+
+        if (!progress && oldest) {
+            if (block) {
+                if (!opendmr_shm_wait(oldest->s, 2000)) {
+                    fprintf(stderr, "Error: Timed out waiting for the service\n");
+                    break;
+                }
+            } else {
+                sched_yield();
+            }
+        }
+    }
+    double elapsed = (now_us() - start) / 1e6;
+    opendmr_shm_detach(shm);
+
+    if (lat.empty())
+        return 1;
+
+    std::sort(lat.begin(), lat.end());
+    size_t n = lat.size();
+    printf("Mode:       %s, %d stream(s), window %d, %s\n", encode ? "encode" : "decode",
+           num_streams, window, block ? "blocking" : "spinning");
+    printf("Frames:     %zu in %.3f s\n", n, elapsed);
+    printf("Throughput: %.0f frames/s (%.1f real-time streams)\n", n / elapsed, n / elapsed / 50.0);
+    printf("Latency:    p50 %.0f us  p90 %.0f us  p99 %.0f us  max %.0f us\n",
+           lat[n / 2], lat[n * 9 / 10], lat[n * 99 / 100], lat[n - 1]);
+    return remaining == 0 ? 0 : 1;
+}
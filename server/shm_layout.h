@@ -0,0 +1,126 @@
+/*
+ * OpenDMR - Open Source DMR (AMBE+2) Vocoder Library
+ *
+ * Shared memory layout used between opendmr-shmd and the client library.
+ * Not part of the public client API.
+ *
+ * The segment holds a header, one doorbell per service worker and a table
+ * of stream slots. Each slot carries two single-producer/single-consumer
+ * rings: requests (client -> service) and responses (service -> client).
+ * Ring counters are free-running 32-bit values; fill = tail - head.
+ *
+ * Wakeups use process-shared futexes and are only issued when the other
+ * side has announced that it is about to sleep, so a busy pipeline runs
+ * without system calls:
+ *
+ *   producer: publish tail; if (peer sleeping) { bump futex; FUTEX_WAKE }
+ *   consumer: v = futex; set sleeping; re-check ring; FUTEX_WAIT(v)
+ *
+ * All flag accesses are sequentially consistent, which closes the window
+ * between the consumer's re-check and the producer's flag test.
+ */
+
+#ifndef OPENDMR_SHM_LAYOUT_H
+#define OPENDMR_SHM_LAYOUT_H
+
+#include "opendmr.h"
+#include <atomic>
+#include <linux/futex.h>
+#include <stdint.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SHM_MAGIC               0x534D444FU    /* "ODMS" */
+#define SHM_VERSION             1
+
+#define SHM_MAX_WORKERS         64
+#define SHM_RING_FRAMES         32              /* Power of two */
+#define SHM_CACHE_LINE          64
+
+/* Slot states */
+#define SHM_SLOT_FREE           0
+#define SHM_SLOT_CLAIMED        1               /* Client is initialising it */
+#define SHM_SLOT_OPEN           2
+#define SHM_SLOT_CLOSING        3               /* Service reclaims it */
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "process-shared rings need lock-free atomics");
+
+/* One frame in either direction; seq is echoed back unchanged */
+struct shm_record {
+    uint32_t seq;
+    uint32_t errs;                              /* Decode: corrected errors */
+    union {
+        uint8_t ambe[OPENDMR_AMBE_FRAME_BYTES];
+        int16_t pcm[OPENDMR_PCM_SAMPLES];
+    };
+};
+
+struct shm_ring {
+    alignas(SHM_CACHE_LINE) std::atomic<uint32_t> head;    /* Consumer */
+    alignas(SHM_CACHE_LINE) std::atomic<uint32_t> tail;    /* Producer */
+    alignas(SHM_CACHE_LINE) shm_record rec[SHM_RING_FRAMES];
+};
+
+struct shm_slot {
+    alignas(SHM_CACHE_LINE) std::atomic<uint32_t> state;
+    uint32_t mode;                              /* OPENDMR_SHM_DECODE/ENCODE */
+    pid_t owner;                                /* Reclaimed when it exits */
+    std::atomic<uint32_t> generation;           /* Bumped on every open */
+
+    /* Response wakeups for a blocked client */
+    alignas(SHM_CACHE_LINE) std::atomic<uint32_t> resp_futex;
+    std::atomic<uint32_t> resp_sleeping;
+
+    shm_ring req;
+    shm_ring resp;
+};
+
+struct shm_worker {
+    alignas(SHM_CACHE_LINE) std::atomic<uint32_t> doorbell;
+    std::atomic<uint32_t> sleeping;
+};
+
+struct shm_header {
+    uint32_t magic;                             /* Written last by the service */
+    uint32_t version;
+    uint32_t num_slots;
+    uint32_t num_workers;
+    pid_t service;
+    shm_worker workers[SHM_MAX_WORKERS];
+    shm_slot slots[1];                          /* num_slots entries */
+};
+
+static inline size_t shm_segment_size(uint32_t num_slots)
+{
+    return sizeof(shm_header) + (num_slots - 1) * sizeof(shm_slot);
+}
+
+/* Streams are assigned to workers statically so their state never moves */
+static inline uint32_t shm_slot_worker(const shm_header *h, uint32_t slot)
+{
+    return slot % h->num_workers;
+}
+
+/* Process-shared futex wait; returns early on wake, timeout or signal */
+static inline void shm_futex_wait(std::atomic<uint32_t> *word, uint32_t expected, int timeout_ms)
+{
+    timespec ts;
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = (timeout_ms % 1000) * 1000000L;
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAIT, expected,
+            timeout_ms < 0 ? nullptr : &ts, nullptr, 0);
+}
+
+/* Wake a sleeping peer, if it announced it was going to sleep */
+static inline void shm_futex_notify(std::atomic<uint32_t> *word, std::atomic<uint32_t> *sleeping)
+{
+    if (sleeping->load()) {
+        word->fetch_add(1);
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAKE, 1,
+                nullptr, nullptr, 0);
+    }
+}
+
+#endif /* OPENDMR_SHM_LAYOUT_H */
@@ -0,0 +1,283 @@
+/*
+ * udpgw_load - Load generator for opendmr-udpgw
+ *
+ * Drives many concurrent streams through the gateway from one socket,
+ * batching sends with sendmmsg() and receives with recvmmsg(). Each stream
+ * keeps a window of frames in flight and may be paced to a fixed rate
+ * (50 packets/s is a real-time voice call). Reports packets per second and
+ * round-trip latency percentiles.
+ *
+ * Usage:
+ *   udpgw_load [-e | -g] [-a address] [-p port] [-s streams] [-n packets]
+ *              [-w window] [-r rate] [-i first_stream]
+ */
+
+#include "opendmr.h"
+#include "udpgw_proto.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#define DEFAULT_STREAMS     64
+#define DEFAULT_PACKETS     500
+#define DEFAULT_WINDOW      4
+#define MAX_WINDOW          64
+
+#define BATCH               32
+#define TEST_FRAMES         50
+
+/* Stop when no response has arrived for this long */
+#define STALL_TIMEOUT_US    2000000.0
+
+struct load_stream {
+    uint32_t id;
+    long sent;
+    long received;
+    double next_send;           /* Paced mode: earliest time of next send */
+    double sent_at[MAX_WINDOW];
+};
+
+static double now_us(void)
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void print_usage(const char *prog)
+{
+    printf("OpenDMR UDP gateway load generator v%s\n", opendmr_version());
+    printf("\n");
+    printf("Usage: %s [options]\n", prog);
+    printf("  -e              Encode (PCM in, AMBE+2 out)\n");
+    printf("  -g              Regenerate FEC (AMBE+2 in and out)\n");
+    printf("                  Default: decode (AMBE+2 in, PCM out)\n");
+    printf("  -a address      Gateway address (default 127.0.0.1)\n");
+    printf("  -p port         Gateway port (default %d)\n", UDPGW_DEFAULT_PORT);
+    printf("  -s streams      Concurrent streams (default %d)\n", DEFAULT_STREAMS);
+    printf("  -n packets      Packets per stream (default %d)\n", DEFAULT_PACKETS);
+    printf("  -w window       Packets in flight per stream (default %d, max %d)\n",
+           DEFAULT_WINDOW, MAX_WINDOW);
+    printf("  -r rate         Packets/s per stream, 0 = unpaced (default 0)\n");
+    printf("  -i id           First stream ID (default 1)\n");
+    printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+    uint8_t op = UDPGW_OP_DECODE;
+    const char *addr = "127.0.0.1";
+    int port = UDPGW_DEFAULT_PORT;
+    int num_streams = DEFAULT_STREAMS;
+    long packets = DEFAULT_PACKETS;
+    int window = DEFAULT_WINDOW;
+    double rate = 0.0;
+    uint32_t first_id = 1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "ega:p:s:n:w:r:i:h")) != -1) {
+        switch (opt) {
+        case 'e': op = UDPGW_OP_ENCODE; break;
+        case 'g': op = UDPGW_OP_REGENERATE; break;
+        case 'a': addr = optarg; break;
+        case 'p': port = atoi(optarg); break;
+        case 's': num_streams = atoi(optarg); break;
+        case 'n': packets = atol(optarg); break;
+        case 'w': window = atoi(optarg); break;
+        case 'r': rate = atof(optarg); break;
+        case 'i': first_id = static_cast<uint32_t>(strtoul(optarg, nullptr, 0)); break;
+        default:
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (num_streams < 1 || packets < 1 || window < 1 || window > MAX_WINDOW || rate < 0.0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    sockaddr_in sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, addr, &sa.sin_addr) != 1) {
+        fprintf(stderr, "Error: Invalid address '%s'\n", addr);
+        return 1;
+    }
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr *>(&sa), sizeof(sa)) < 0) {
+        fprintf(stderr, "Error: Cannot connect to %s:%d: %s\n", addr, port, strerror(errno));
+        return 1;
+    }
+    int buf = 4 << 20;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &buf, sizeof(buf));
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &buf, sizeof(buf));
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    /* Payloads: one second of test signal, as PCM (little-endian) or AMBE+2 */
+    std::vector<uint8_t> pcm_bytes(TEST_FRAMES * OPENDMR_PCM_SAMPLES * 2);
+    std::vector<uint8_t> ambe(TEST_FRAMES * OPENDMR_AMBE_FRAME_BYTES);
+    opendmr_encoder_t *enc = opendmr_encoder_create();
+    for (int f = 0; f < TEST_FRAMES; f++) {
+        int16_t pcm[OPENDMR_PCM_SAMPLES];
+        for (int i = 0; i < OPENDMR_PCM_SAMPLES; i++) {
+            double t = (f * OPENDMR_PCM_SAMPLES + i) / 8000.0;
+            double f0 = 120.0 + 40.0 * sin(2.0 * M_PI * 0.5 * t);
+            pcm[i] = static_cast<int16_t>(8000.0 * sin(2.0 * M_PI * f0 * t));
+            pcm_bytes[(f * OPENDMR_PCM_SAMPLES + i) * 2] = static_cast<uint8_t>(pcm[i]);
+            pcm_bytes[(f * OPENDMR_PCM_SAMPLES + i) * 2 + 1] = static_cast<uint8_t>(pcm[i] >> 8);
+        }
+        opendmr_encode(enc, pcm, &ambe[f * OPENDMR_AMBE_FRAME_BYTES]);
+    }
+    opendmr_encoder_destroy(enc);
+
+    bool pcm_in = op == UDPGW_OP_ENCODE;
+    size_t payload_len = pcm_in ? OPENDMR_PCM_SAMPLES * 2 : OPENDMR_AMBE_FRAME_BYTES;
+    const uint8_t *payloads = pcm_in ? pcm_bytes.data() : ambe.data();
+
+    std::vector<load_stream> streams(static_cast<size_t>(num_streams));
+    double start = now_us();
+    for (int i = 0; i < num_streams; i++) {
+        load_stream *s = &streams[static_cast<size_t>(i)];
+        s->id = first_id + static_cast<uint32_t>(i);
+        s->sent = s->received = 0;
+        /* Spread paced streams over one period so they do not send in lockstep */
+        s->next_send = rate > 0.0 ? start + 1e6 / rate * i / num_streams : start;
+    }
+
+    uint8_t tx[BATCH][UDPGW_PCM_DATAGRAM];
+    uint8_t rx[BATCH][UDPGW_PCM_DATAGRAM];
+    iovec tx_iov[BATCH], rx_iov[BATCH];
+    mmsghdr tx_msg[BATCH], rx_msg[BATCH];
+    memset(tx_msg, 0, sizeof(tx_msg));
+    memset(rx_msg, 0, sizeof(rx_msg));
+    for (int i = 0; i < BATCH; i++) {
+        tx_iov[i].iov_base = tx[i];
+        tx_msg[i].msg_hdr.msg_iov = &tx_iov[i];
+        tx_msg[i].msg_hdr.msg_iovlen = 1;
+        rx_iov[i].iov_base = rx[i];
+        rx_iov[i].iov_len = sizeof(rx[i]);
+        rx_msg[i].msg_hdr.msg_iov = &rx_iov[i];
+        rx_msg[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    std::vector<double> lat;
+    lat.reserve(static_cast<size_t>(packets * num_streams));
+    long total = packets * num_streams;
+    long sent = 0, received = 0, errors = 0, send_calls = 0, recv_calls = 0;
+    size_t cursor = 0;
+    double last_rx = now_us();
+
+    while (received < total) {
+        /* Fill one send batch, round-robin over the streams */
+        double now = now_us();
+        int n = 0;
+        double next_due = now + 1000.0;
+        for (size_t k = 0; k < streams.size() && n < BATCH; k++) {
+            load_stream *s = &streams[(cursor + k) % streams.size()];
+            if (s->sent >= packets || s->sent - s->received >= window)
+                continue;
+            if (rate > 0.0 && s->next_send > now) {
+                next_due = std::min(next_due, s->next_send);
+                continue;
+            }
+
+            size_t f = static_cast<size_t>(s->sent) % TEST_FRAMES;
+            udpgw_header(tx[n], op, 0, s->id, static_cast<uint32_t>(s->sent));
+            memcpy(tx[n] + UDPGW_HEADER_LEN, payloads + f * payload_len, payload_len);
+            tx_iov[n].iov_len = UDPGW_HEADER_LEN + payload_len;
+            s->sent_at[s->sent % MAX_WINDOW] = now;
+            s->sent++;
+            if (rate > 0.0)
+                s->next_send += 1e6 / rate;
+            n++;
+        }
+        cursor = (cursor + 1) % streams.size();
+
+        for (int done = 0; done < n;) {
+            int r = sendmmsg(fd, tx_msg + done, static_cast<unsigned int>(n - done), 0);
+            if (r < 0) {
+                if (errno == EAGAIN || errno == EINTR) {
+                    pollfd pfd = { fd, POLLOUT, 0 };
+                    poll(&pfd, 1, 10);
+                    continue;
+                }
+                fprintf(stderr, "Error: sendmmsg: %s\n", strerror(errno));
+                return 1;
+            }
+            done += r;
+            send_calls++;
+        }
+        sent += n;
+
+        int r = recvmmsg(fd, rx_msg, BATCH, MSG_DONTWAIT, nullptr);
+        if (r > 0) {
+            double t = now_us();
+            recv_calls++;
+            for (int i = 0; i < r; i++) {
+                const uint8_t *p = rx[i];
+                if (rx_msg[i].msg_len < UDPGW_HEADER_LEN || p[1] != (op | UDPGW_OP_RESPONSE))
+                    continue;
+                uint32_t idx = udpgw_get32(p + UDPGW_STREAM_OFFSET) - first_id;
+                if (idx >= streams.size())
+                    continue;
+                load_stream *s = &streams[idx];
+                uint32_t seq = udpgw_get32(p + 8);
+                if (p[2] == UDPGW_STATUS_ERROR && op != UDPGW_OP_REGENERATE)
+                    errors++;
+                lat.push_back(t - s->sent_at[seq % MAX_WINDOW]);
+                s->received++;
+                received++;
+            }
+            last_rx = t;
+            continue;
+        }
+
+        if (now_us() - last_rx > STALL_TIMEOUT_US) {
+            fprintf(stderr, "Warning: %ld packet(s) unanswered, giving up\n", total - received);
+            break;
+        }
+        if (n == 0) {
+            /* Nothing to send: wait for responses or the next paced send */
+            int wait_ms = static_cast<int>((next_due - now_us()) / 1000.0);
+            pollfd pfd = { fd, POLLIN, 0 };
+            poll(&pfd, 1, wait_ms < 1 ? 1 : wait_ms);
+        }
+    }
+    double elapsed = (now_us() - start) / 1e6;
+    close(fd);
+
+    if (lat.empty()) {
+        fprintf(stderr, "Error: No responses from %s:%d\n", addr, port);
+        return 1;
+    }
+
+    std::sort(lat.begin(), lat.end());
+    size_t m = lat.size();
+    const char *mode = op == UDPGW_OP_ENCODE ? "encode" :
+                       op == UDPGW_OP_REGENERATE ? "regenerate" : "decode";
+    printf("Mode:       %s, %d stream(s), window %d, %s\n", mode, num_streams, window,
+           rate > 0.0 ? "paced" : "unpaced");
+    printf("Packets:    %zu answered, %ld lost, %ld error(s) in %.3f s\n",
+           m, total - received, errors, elapsed);
+    printf("Throughput: %.0f packets/s (%.1f real-time streams)\n", m / elapsed, m / elapsed / 50.0);
+    printf("Batching:   %.1f sent, %.1f received per call\n",
+           send_calls ? static_cast<double>(sent) / send_calls : 0.0,
+           recv_calls ? static_cast<double>(m) / recv_calls : 0.0);
+    printf("RTT (us):   p50 %.0f  p90 %.0f  p99 %.0f  p99.9 %.0f  max %.0f\n",
+           lat[m / 2], lat[m * 9 / 10], lat[m * 99 / 100], lat[m * 999 / 1000], lat[m - 1]);
+    return received == total ? 0 : 1;
+}
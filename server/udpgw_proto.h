@@ -0,0 +1,69 @@
+/*
+ * OpenDMR - Open Source DMR (AMBE+2) Vocoder Library
+ *
+ * Datagram format of the UDP transcoding gateway (opendmr-udpgw), shared
+ * with its load generator.
+ *
+ * Every datagram carries one frame behind a 12-byte header:
+ *
+ *   0   version     UDPGW_VERSION
+ *   1   op          UDPGW_OP_*; responses set UDPGW_OP_RESPONSE
+ *   2   status      Response: corrected bit errors, or UDPGW_STATUS_*
+ *   3   reserved    0
+ *   4   stream      Stream ID (32-bit big-endian)
+ *   8   seq         Sequence number, echoed back (32-bit big-endian)
+ *   12  payload     AMBE+2: 9 bytes; PCM: 160 samples, 16-bit little-endian
+ *
+ * The stream ID sits at a fixed offset so the kernel can steer every
+ * datagram of a stream to the same socket (see opendmr_udpgw.cpp).
+ */
+
+#ifndef UDPGW_PROTO_H
+#define UDPGW_PROTO_H
+
+#include "opendmr.h"
+#include <stdint.h>
+
+#define UDPGW_VERSION           1
+#define UDPGW_HEADER_LEN        12
+#define UDPGW_STREAM_OFFSET     4
+
+#define UDPGW_OP_DECODE         1   /* AMBE+2 -> PCM */
+#define UDPGW_OP_ENCODE         2   /* PCM -> AMBE+2 */
+#define UDPGW_OP_REGENERATE     3   /* AMBE+2 -> AMBE+2, FEC only */
+#define UDPGW_OP_CLOSE          4   /* Release the stream's codec state */
+#define UDPGW_OP_RESPONSE       0x80
+
+#define UDPGW_STATUS_ERROR      0xFF    /* Malformed request or no codec */
+
+#define UDPGW_AMBE_DATAGRAM     (UDPGW_HEADER_LEN + OPENDMR_AMBE_FRAME_BYTES)
+#define UDPGW_PCM_DATAGRAM      (UDPGW_HEADER_LEN + OPENDMR_PCM_SAMPLES * 2)
+
+#define UDPGW_DEFAULT_PORT      24620
+
+static inline void udpgw_put32(uint8_t *p, uint32_t v)
+{
+    p[0] = static_cast<uint8_t>(v >> 24);
+    p[1] = static_cast<uint8_t>(v >> 16);
+    p[2] = static_cast<uint8_t>(v >> 8);
+    p[3] = static_cast<uint8_t>(v);
+}
+
+static inline uint32_t udpgw_get32(const uint8_t *p)
+{
+    return static_cast<uint32_t>(p[0]) << 24 | static_cast<uint32_t>(p[1]) << 16 |
+           static_cast<uint32_t>(p[2]) << 8 | p[3];
+}
+
+static inline void udpgw_header(uint8_t *p, uint8_t op, uint8_t status,
+                                uint32_t stream, uint32_t seq)
+{
+    p[0] = UDPGW_VERSION;
+    p[1] = op;
+    p[2] = status;
+    p[3] = 0;
+    udpgw_put32(p + UDPGW_STREAM_OFFSET, stream);
+    udpgw_put32(p + 8, seq);
+}
+
+#endif /* UDPGW_PROTO_H */